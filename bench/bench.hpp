@@ -0,0 +1,43 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_BENCH
+#define DATA_BENCH
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <data/types.hpp>
+
+namespace data::bench {
+    
+    // keep the compiler from optimizing away a result. 
+    template <typename X>
+    inline void keep(const X& x) {
+        asm volatile("" : : "g"(&x) : "memory");
+    }
+    
+    // average time of a call to f in nanoseconds. 
+    template <typename F>
+    double measure(uint64 times, F f) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64 i = 0; i < times; i++) f(i);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / times;
+    }
+    
+    inline void report(string_view name, double ns) {
+        std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(12) 
+            << std::fixed << std::setprecision(1) << ns << " ns" << std::endl;
+    }
+    
+    inline void compare(string_view name, double before, double after) {
+        std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(12) 
+            << std::fixed << std::setprecision(1) << before << " ns" << std::setw(12) << after << " ns" 
+            << std::setw(10) << std::setprecision(2) << (before / after) << "x" << std::endl;
+    }
+    
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include <data/tools/priority_queue.hpp>
+#include "bench.hpp"
+
+// Compare the node allocation policies of the persistent
+// containers on allocation-heavy workloads.
+
+namespace data::bench {
+
+    // the sieve that eratosthenes runs, with machine integers.
+    struct multiple {
+        uint64 Prime;
+        uint64 Multiple;
+
+        bool operator<=(const multiple& m) const {
+            return Multiple <= m.Multiple;
+        }
+    };
+
+    template <typename alloc>
+    uint64 sieve(uint64 max) {
+        using heap = tool::priority_queue<multiple, tool::linked_stack<multiple, alloc>, alloc>;
+        heap q{};
+        uint64 primes = 0;
+        for (uint64 n = 2; n < max; n++) {
+            bool prime = true;
+            while (!q.empty() && q.first().Multiple <= n) {
+                multiple m = q.first();
+                if (m.Multiple == n) prime = false;
+                q = q.rest().insert(multiple{m.Prime, m.Multiple + m.Prime});
+            }
+            if (prime) {
+                primes++;
+                q = q.insert(multiple{n, n * 2});
+            }
+        }
+        return primes;
+    }
+
+    // the term insertions that polynomial multiplication makes.
+    template <typename alloc>
+    size_t multiply(uint32 degree) {
+        tool::ordered_list<uint64, alloc> terms{};
+        for (uint64 i = 0; i <= degree; i++) for (uint64 j = 0; j <= degree; j++) terms = terms.insert(i + j);
+        return terms.size();
+    }
+
+    template <typename alloc>
+    size_t push_pop(uint32 count) {
+        tool::linked_stack<uint64, alloc> s{};
+        for (uint32 round = 0; round < 4; round++) {
+            for (uint64 i = 0; i < count; i++) s = s << i;
+            for (uint64 i = 0; i < count / 2; i++) s = s.rest();
+        }
+        return s.first();
+    }
+
+    template <typename alloc>
+    size_t map_insert(uint32 count) {
+        std::mt19937_64 engine{1};
+        tool::rb_map<uint64, uint64, alloc> m{};
+        for (uint64 i = 0; i < count; i++) m = m.insert(engine(), i);
+        return m.size();
+    }
+
+    template <typename F>
+    void run(string_view name, F f) {
+        double shared = measure(1, [&](uint64) { keep(f(tool::shared_allocation{})); });
+        double pooled = measure(1, [&](uint64) { keep(f(tool::pooled_allocation{})); });
+        double local = measure(1, [&](uint64) { keep(f(tool::local_allocation{})); });
+        std::cout << name << std::endl;
+        compare("  shared -> pooled", shared, pooled);
+        compare("  shared -> pooled, non-atomic", shared, local);
+    }
+
+}
+
+int main() {
+    using namespace data::bench;
+
+    run("sieve up to 200000", [](auto a) { return sieve<decltype(a)>(200000); });
+    run("polynomial terms, degree 40", [](auto a) { return multiply<decltype(a)>(40); });
+    run("stack push and pop, 100000", [](auto a) { return push_pop<decltype(a)>(100000); });
+    run("map insert, 100000", [](auto a) { return map_insert<decltype(a)>(100000); });
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/base58.hpp>
+#include <data/math/number/gmp/N.hpp>
+#include <data/math/number/bytes/N.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Compare base58::encode and base58::decode with the old approach
+// of converting to gmp::N and dividing or multiplying digit by digit.
+
+namespace data::bench {
+
+    using nat = math::number::gmp::N;
+
+    std::string gmp_encode(bytes_view b) {
+        return encoding::base58::write<nat>(nat{math::number::N_bytes<endian::big>(b)});
+    }
+
+    bytes gmp_decode(string_view s) {
+        return bytes(bytes_view(math::number::N_bytes<endian::big>(encoding::base58::read<nat>(s))));
+    }
+
+    void run(string_view name, size_t size, uint64 times) {
+        const size_t count = 256;
+        std::mt19937_64 engine{size};
+        std::vector<bytes> payloads(count, bytes(size));
+        std::vector<std::string> encoded(count);
+        for (size_t i = 0; i < count; i++) {
+            for (byte& x : payloads[i]) x = engine();
+            // so that both ways of encoding give the same string.
+            payloads[i][0] |= 1;
+            encoded[i] = encoding::base58::encode(payloads[i]);
+        }
+
+        std::cout << name << ", " << size << " bytes" << std::setw(38 - name.size()) << "gmp::N" << std::setw(15) << "base58" << std::endl;
+
+        compare("encode",
+            measure(times, [&](uint64 i) { keep(gmp_encode(payloads[i % count])); }),
+            measure(times, [&](uint64 i) { keep(encoding::base58::encode(payloads[i % count])); }));
+
+        bytes out;
+        compare("decode",
+            measure(times, [&](uint64 i) { keep(gmp_decode(encoded[i % count])); }),
+            measure(times, [&](uint64 i) { keep(encoding::base58::decode(out, encoded[i % count])); }));
+
+        std::cout << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    data::uint64 times = argc > 1 ? std::stoull(argv[1]) : 100000;
+    data::bench::run("address", 25, times);
+    data::bench::run("extended key", 82, times);
+    data::bench::run("script", 520, times / 10);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/base64.hpp>
+#include <boost/regex.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Compare base64::encode and base64::decode with the character by 
+// character codec and regex validation that base64 used before. 
+
+namespace data::bench {
+    
+    namespace base64 = encoding::base64;
+    
+    const std::string Characters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const boost::regex Pattern{"^(?:[A-Za-z0-9+/]{4})*(?:[A-Za-z0-9+/]{2}==|[A-Za-z0-9+/]{3}=|[A-Za-z0-9+/]{4})$"};
+    
+    std::string old_write(bytes_view b) {
+        std::string output;
+        output.reserve((b.size() + 2) / 3 * 4);
+        size_t i = 0;
+        for (; i + 3 <= b.size(); i += 3) {
+            uint32 value = (b[i] << 16) + (b[i + 1] << 8) + b[i + 2];
+            output.append(1, Characters[(value & 0x00FC0000) >> 18]);
+            output.append(1, Characters[(value & 0x0003F000) >> 12]);
+            output.append(1, Characters[(value & 0x00000FC0) >> 6]);
+            output.append(1, Characters[(value & 0x0000003F) >> 0]);
+        }
+        if (i < b.size()) {
+            uint32 value = (b[i] << 16) + (i + 1 < b.size() ? b[i + 1] << 8 : 0);
+            output.append(1, Characters[(value & 0x00FC0000) >> 18]);
+            output.append(1, Characters[(value & 0x0003F000) >> 12]);
+            if (i + 1 < b.size()) output.append(1, Characters[(value & 0x00000FC0) >> 6]);
+            output.append(i + 1 < b.size() ? 1 : 2, '=');
+        }
+        return output;
+    }
+    
+    ptr<bytes> old_read(string_view source) {
+        if (!boost::regex_match(source.data(), Pattern)) return nullptr;
+        ptr<bytes> b = std::make_shared<bytes>();
+        b->reserve(source.size() / 4 * 3);
+        uint32 value = 0;
+        for (auto cursor = source.begin(); cursor < source.end();) {
+            for (size_t position = 0; position < 4; position++) {
+                value <<= 6;
+                if (*cursor >= 0x41 && *cursor <= 0x5A) value |= *cursor - 0x41;
+                else if (*cursor >= 0x61 && *cursor <= 0x7A) value |= *cursor - 0x47;
+                else if (*cursor >= 0x30 && *cursor <= 0x39) value |= *cursor + 0x04;
+                else if (*cursor == 0x2B) value |= 0x3E;
+                else if (*cursor == 0x2F) value |= 0x3F;
+                else if (*cursor == '=') {
+                    if (source.end() - cursor == 1) {
+                        b->push_back((value >> 16) & 0xff);
+                        b->push_back((value >> 8) & 0xff);
+                    } else b->push_back((value >> 10) & 0xff);
+                    return b;
+                } else return nullptr;
+                cursor++;
+            }
+            b->push_back((value >> 16) & 0xff);
+            b->push_back((value >> 8) & 0xff);
+            b->push_back(value & 0xff);
+        }
+        return b;
+    }
+    
+    void run(size_t size, uint64 times) {
+        std::mt19937_64 engine{size};
+        bytes b(size);
+        for (byte& x : b) x = engine();
+        std::string text = old_write(b);
+        std::string out(base64::encoded_size(size), ' ');
+        bytes back(base64::decoded_size(text.size()));
+        size_t written;
+        
+        std::cout << size << " bytes" << std::setw(44) << "old" << std::setw(15) << "base64" << std::endl;
+        
+        compare("encode", 
+            measure(times, [&](uint64) { keep(old_write(b)); }), 
+            measure(times, [&](uint64) { base64::encode(out.data(), b); keep(out); }));
+        
+        compare("decode", 
+            measure(times, [&](uint64) { keep(old_read(text)); }), 
+            measure(times, [&](uint64) { keep(base64::decode(back.data(), text, written)); }));
+        
+        compare("decode in 4096 byte pieces", 
+            measure(times, [&](uint64) { keep(old_read(text)); }), 
+            measure(times, [&](uint64) { 
+                base64::decoder d;
+                bytes decoded;
+                decoded.reserve(back.size());
+                for (size_t i = 0; i < text.size(); i += 4096) d.write(decoded, string_view(text).substr(i, 4096));
+                keep(d.finish(decoded));
+            }));
+        
+        std::cout << std::endl;
+    }
+    
+}
+
+int main(int argc, char *argv[]) {
+    data::bench::run(32, 1000000);
+    data::bench::run(1000, 100000);
+    data::bench::run(1 << 20, 50);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <data/log/binary.hpp>
+#include "bench.hpp"
+
+// How many records with a few arguments can be logged and written,
+// as text with async logging and as binary records.
+
+namespace data::bench {
+
+    const uint64 records = 1000000;
+
+    // nanoseconds per record with the given number of threads logging
+    // at once, until everything that was logged has been written.
+    template <typename F>
+    double logging(int threads, F f) {
+        return measure(1, [threads, f](uint64) {
+            std::vector<std::thread> loggers;
+            for (int i = 0; i < threads; i++) loggers.emplace_back([threads, f]() {
+                for (uint64 j = 0; j < records / threads; j++) f(j);
+            });
+            for (auto& t : loggers) t.join();
+            log::flush_logging();
+        }) / records;
+    }
+
+    void run(int threads) {
+        std::cout << threads << " threads" << std::setw(38) << "async text" << std::setw(15) << "binary" << std::endl;
+
+        log::async_options text;
+        text.Overflow = log::overflow::block;
+        log::init_async_logging("bench_text.log", text);
+        double before = logging(threads, [](uint64 j) {
+            DATA_LOG_CHANNEL("bench", warning) << "record " << j << " of " << records << " at " << 0.5;
+        });
+        log::logging::core::get()->remove_all_sinks();
+
+        log::binary_options binary;
+        binary.Overflow = log::overflow::block;
+        log::init_binary_logging("bench_binary.log", binary);
+        double after = logging(threads, [](uint64 j) {
+            DATA_LOG_BINARY_CHANNEL("bench", warning, "record {} of {} at {}", j, records, 0.5);
+        });
+        log::close_binary_logging();
+
+        compare("per record", before, after);
+        std::cout << "  binary records per second " << std::setprecision(0) << 1e9 / after << std::endl;
+
+        std::remove("bench_text.log");
+        std::remove("bench_binary.log");
+    }
+
+}
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    data::bench::run(1);
+    data::bench::run(4);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/data.hpp>
+#include <data/math/number/bounded/bounded.hpp>
+#include "bench.hpp"
+
+// Throughput of fixed-size arithmetic on bounded numbers, 
+// compared with the variable-size arithmetic of N_bytes. 
+
+namespace data::bench {
+    
+    template <endian::order r, size_t size>
+    std::vector<math::number::bounded<false, r, size>> random_bounded(size_t count, size_t bytes) {
+        std::mt19937_64 engine{bytes};
+        std::vector<math::number::bounded<false, r, size>> numbers(count);
+        for (auto& n : numbers) for (size_t i = 0; i < bytes; i++) n.words().digit(i) = engine();
+        return numbers;
+    }
+    
+    template <endian::order r, size_t size>
+    void run(string_view order, uint64 times) {
+        using uint = math::number::bounded<false, r, size>;
+        const size_t count = 256;
+        std::vector<uint> a = random_bounded<r, size>(count, size);
+        std::vector<uint> b = random_bounded<r, size>(count, size / 2 + 1);
+        std::vector<N_bytes<r>> na(count);
+        std::vector<N_bytes<r>> nb(count);
+        for (size_t i = 0; i < count; i++) {
+            na[i] = N_bytes<r>{a[i]};
+            nb[i] = N_bytes<r>{b[i]};
+        }
+        
+        std::cout << order << " endian, " << (8 * size) << " bits" << std::setw(35) << "N_bytes" << std::setw(15) << "bounded" << std::endl;
+        
+        compare("<", 
+            measure(times, [&](uint64 i) { keep(na[i % count] < nb[i % count]); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] < b[i % count]); }));
+        
+        compare("+", 
+            measure(times, [&](uint64 i) { keep(na[i % count] + nb[i % count]); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] + b[i % count]); }));
+        
+        compare("-", 
+            measure(times, [&](uint64 i) { keep(na[i % count] - nb[i % count]); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] - b[i % count]); }));
+        
+        compare("*", 
+            measure(times, [&](uint64 i) { keep(na[i % count] * nb[i % count]); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] * b[i % count]); }));
+        
+        compare("/", 
+            measure(times, [&](uint64 i) { keep(na[i % count] / nb[i % count]); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] / b[i % count]); }));
+        
+        compare("<< 13", 
+            measure(times, [&](uint64 i) { keep(na[i % count] << 13); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] << 13); }));
+        
+        double ns = measure(times, [&](uint64 i) { keep(a[i % count] * b[i % count] + a[(i + 1) % count]); });
+        std::cout << "  multiply-add throughput: " << std::setprecision(1) << (1000.0 / ns) << " million per second" << std::endl;
+        
+        std::cout << std::endl;
+    }
+    
+}
+
+int main(int argc, char *argv[]) {
+    data::uint64 times = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    data::bench::run<data::endian::big, 32>("big", times);
+    data::bench::run<data::endian::little, 32>("little", times);
+    data::bench::run<data::endian::big, 64>("big", times);
+    data::bench::run<data::endian::little, 64>("little", times);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <list>
+#include <thread>
+#include <data/tools/channel.hpp>
+#include "bench.hpp"
+
+// Compare the throughput of the ring buffer channel with the 
+// list behind a mutex that channel used to be. 
+
+namespace data::bench {
+    
+    // the old channel, with its waits in loops. 
+    template <typename item>
+    class locked_channel {
+        std::list<item> Queue;
+        std::mutex M;
+        std::condition_variable Receive;
+        std::condition_variable Send;
+        uint32 Size;
+        bool Closed;
+        
+    public:
+        locked_channel(uint32 n) : Size{n}, Closed{false} {}
+        
+        void close() {
+            std::unique_lock<std::mutex> lock{M};
+            Closed = true;
+            Receive.notify_all();
+            Send.notify_all();
+        }
+        
+        void put(const item &i) {
+            std::unique_lock<std::mutex> lock{M};
+            Queue.push_back(i);
+            Receive.notify_one();
+            while (!Closed && Size != 0 && Queue.size() >= Size) Send.wait(lock);
+        }
+        
+        bool get(item &out) {
+            std::unique_lock<std::mutex> lock{M};
+            while (Queue.empty()) {
+                if (Closed) return false;
+                Receive.wait(lock);
+            }
+            out = Queue.front();
+            Queue.pop_front();
+            Send.notify_one();
+            return true;
+        }
+    };
+    
+    const uint32 capacity = 1024;
+    const uint64 items = 1000000;
+    
+    // nanoseconds per item passed from producers to consumers. 
+    template <typename C, typename P, typename G>
+    double throughput(int threads, P put, G get) {
+        return measure(1, [&](uint64) {
+            C c{capacity};
+            std::vector<std::thread> producers{};
+            std::vector<std::thread> consumers{};
+            for (int i = 0; i < threads; i++) {
+                producers.emplace_back([&c, &put, threads]() {
+                    put(c, items / threads);
+                });
+                consumers.emplace_back([&c, &get]() {
+                    keep(get(c));
+                });
+            }
+            for (auto& t : producers) t.join();
+            c.close();
+            for (auto& t : consumers) t.join();
+        }) / items;
+    }
+    
+    template <typename C>
+    void put_one(C& c, uint64 n) {
+        for (uint64 i = 0; i < n; i++) c.put(i);
+    }
+    
+    template <typename C>
+    uint64 get_one(C& c) {
+        uint64 x, sum = 0;
+        while (c.get(x)) sum += x;
+        return sum;
+    }
+    
+    template <typename C>
+    void put_batch(C& c, uint64 n) {
+        std::array<uint64, 32> b;
+        for (uint64 i = 0; i < n; i += b.size()) {
+            for (uint64 j = 0; j < b.size(); j++) b[j] = i + j;
+            c.put_batch(b.begin(), b.begin() + std::min(b.size(), n - i));
+        }
+    }
+    
+    template <typename C>
+    uint64 get_batch(C& c) {
+        std::array<uint64, 32> b;
+        uint64 sum = 0;
+        while (size_t n = c.get_batch(b.begin(), b.size())) for (size_t j = 0; j < n; j++) sum += b[j];
+        return sum;
+    }
+    
+    void run(int threads) {
+        using locked = locked_channel<uint64>;
+        using multiple = tool::channel<uint64>;
+        
+        std::cout << threads << " -> " << threads << std::setw(44) << "list" << std::setw(15) << "ring" << std::endl;
+        double before = throughput<locked>(threads, put_one<locked>, get_one<locked>);
+        compare("one at a time", before, throughput<multiple>(threads, put_one<multiple>, get_one<multiple>));
+        compare("batches of 32", before, throughput<multiple>(threads, put_batch<multiple>, get_batch<multiple>));
+        
+        if (threads == 1) {
+            using single = tool::channel<uint64, tool::access::single>;
+            compare("single access", before, throughput<single>(threads, put_one<single>, get_one<single>));
+            compare("single access, batches of 32", before, throughput<single>(threads, put_batch<single>, get_batch<single>));
+        }
+    }
+    
+}
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    data::bench::run(1);
+    data::bench::run(4);
+    data::bench::run(16);
+    
+    return 0;
+}
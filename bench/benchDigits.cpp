@@ -0,0 +1,72 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/digits.hpp>
+#include <data/encoding/integer.hpp>
+#include <data/math/number/gmp/N.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Compare write_base and read_base with the digit by digit
+// conversion that they did before.
+
+namespace data::bench {
+
+    using nat = math::number::gmp::N;
+
+    std::string old_write(const nat& n, const std::string& digits) {
+        std::string o;
+        nat x = n;
+        while (x > 0) {
+            math::division<nat> d = x.divide(digits.size());
+            o.push_back(digits[(uint64)(d.Remainder)]);
+            x = d.Quotient;
+        }
+        std::reverse(o.begin(), o.end());
+        return o;
+    }
+
+    nat old_read(string_view s, uint32 base) {
+        nat n{0};
+        nat pow{1};
+        for (auto x = s.rbegin(); x != s.rend(); ++x) {
+            n += pow * uint64(encoding::decimal::digit(*x));
+            pow *= base;
+        }
+        return n;
+    }
+
+    void run(size_t size, uint64 times) {
+        std::mt19937_64 engine{size};
+        std::string s(size, '0');
+        for (char& c : s) c = '0' + engine() % 10;
+        s[0] = '1';
+        nat n{s};
+        std::string digits = encoding::decimal::characters();
+
+        std::cout << size << " digits" << std::setw(43) << "digit by digit" << std::setw(15) << "digits" << std::endl;
+
+        compare("write decimal",
+            measure(times, [&](uint64) { keep(old_write(n, digits)); }),
+            measure(times, [&](uint64) { keep(encoding::write_base<nat>(n, digits)); }));
+
+        compare("read decimal",
+            measure(times, [&](uint64) { keep(old_read(s, 10)); }),
+            measure(times, [&](uint64) { keep(encoding::read_base<nat>(s, 10, &encoding::decimal::digit)); }));
+
+        encoding::decimal::N x{s};
+        report("decimal::N +", measure(times, [&](uint64) { keep(x + x); }));
+
+        std::cout << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    data::bench::run(100, 10000);
+    data::bench::run(1000, 1000);
+    data::bench::run(10000, 10);
+    data::bench::run(100000, 1);
+    return 0;
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#include <data/networking/http.hpp>
+#include "bench.hpp"
+
+// Requests per second to a server on localhost with a connection for
+// each request, with connections that are kept alive, and with pipelining,
+// and how long it takes to make many requests at once with async_request.
+// There is no TLS here, so this leaves out the handshakes that keeping
+// connections alive saves us, which cost far more than the connections.
+
+namespace data::bench {
+
+    namespace beast = boost::beast;
+    using tcp = boost::asio::ip::tcp;
+
+    // answers each request with its target after a delay, to stand in for a server 
+    // that is far away. Connections are served asynchronously on one thread. 
+    struct echo_server {
+        boost::asio::io_context ioc;
+        tcp::acceptor acceptor;
+        std::chrono::microseconds delay;
+        std::thread thread;
+
+        struct session : std::enable_shared_from_this<session> {
+            tcp::socket socket;
+            boost::asio::steady_timer timer;
+            std::chrono::microseconds delay;
+            beast::flat_buffer buffer;
+            beast::http::request<beast::http::string_body> req;
+            beast::http::response<beast::http::string_body> res;
+
+            session(tcp::socket s, std::chrono::microseconds d) : socket(std::move(s)), timer(socket.get_executor()), delay(d) {}
+
+            void read() {
+                req = {};
+                beast::http::async_read(socket, buffer, req, [self = shared_from_this()](beast::error_code ec, size_t) {
+                    if (ec) return;
+                    self->timer.expires_after(self->delay);
+                    self->timer.async_wait([self](beast::error_code) {
+                        self->write();
+                    });
+                });
+            }
+
+            void write() {
+                res = beast::http::response<beast::http::string_body>(beast::http::status::ok, req.version());
+                res.body() = std::string(req.target());
+                res.keep_alive(req.keep_alive());
+                res.prepare_payload();
+                beast::http::async_write(socket, res, [self = shared_from_this()](beast::error_code ec, size_t) {
+                    if (ec || !self->res.keep_alive()) {
+                        self->socket.shutdown(tcp::socket::shutdown_send, ec);
+                        return;
+                    }
+                    self->read();
+                });
+            }
+        };
+
+        void accept() {
+            acceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+                if (ec) return;
+                socket.set_option(tcp::no_delay(true));
+                std::make_shared<session>(std::move(socket), delay)->read();
+                accept();
+            });
+        }
+
+        explicit echo_server(std::chrono::microseconds d = std::chrono::microseconds(0)) :
+            acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)), delay(d) {
+            acceptor.listen(4096);
+            accept();
+            thread = std::thread([this]() {
+                ioc.run();
+            });
+        }
+
+        string port() const {
+            return std::to_string(acceptor.local_endpoint().port());
+        }
+
+        ~echo_server() {
+            ioc.stop();
+            thread.join();
+        }
+    };
+
+    const uint64 requests = 2000;
+
+    double per_second(double ns) {
+        return 1e9 / ns;
+    }
+
+    const uint64 fan = 1000;
+
+    // a thousand requests to a server that takes a millisecond to answer each one, 
+    // one after another and all at once on an io_context run by a few threads.
+    void fan_out() {
+        using data::networking::http;
+        echo_server server(std::chrono::milliseconds(1));
+        http::options o;
+        o.TLS = false;
+        o.Connections = fan;
+
+        double before;
+        {
+            http client(o);
+            before = measure(1, [&](uint64) {
+                for (uint64 i = 0; i < fan; i++) keep(client.request(server.port(), http::method::get, "127.0.0.1", "/"));
+            });
+        }
+
+        boost::asio::io_context ioc;
+        auto work = boost::asio::make_work_guard(ioc);
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < std::max(2u, std::thread::hardware_concurrency()); i++) threads.emplace_back([&ioc]() {
+            ioc.run();
+        });
+
+        double first, again;
+        {
+            http client(ioc, o);
+            auto all = [&](uint64) {
+                std::atomic<uint64> done(0);
+                std::promise<void> finished;
+                for (uint64 i = 0; i < fan; i++) client.async_request(server.port(), "127.0.0.1",
+                    http::call{http::method::get, "/", {}, ""}, std::chrono::seconds(30),
+                    [&](boost::system::error_code ec, string body) {
+                        if (ec) std::cout << "  error: " << ec.message() << std::endl;
+                        keep(body);
+                        if (++done == fan) finished.set_value();
+                    });
+                finished.get_future().wait();
+            };
+            // the first time, every request needs a new connection.
+            first = measure(1, all);
+            again = measure(1, all);
+        }
+
+        work.reset();
+        for (auto& t : threads) t.join();
+
+        std::cout << fan << " requests, 1ms each" << std::setw(29) << "sequential" << std::setw(15) << "fan out" << std::endl;
+        compare("all requests, new connections", before, first);
+        compare("all requests, pooled connections", before, again);
+    }
+
+}
+
+int main() {
+    using namespace data;
+    using namespace data::bench;
+    using data::networking::http;
+
+    echo_server server;
+    http::options plain;
+    plain.TLS = false;
+
+    double before, pooled, pipelined;
+    {
+        http::options o = plain;
+        o.Connections = 0;
+        http client(o);
+        before = measure(requests, [&](uint64) {
+            keep(client.request(server.port(), http::method::get, "127.0.0.1", "/"));
+        });
+    }
+    {
+        http client(plain);
+        pooled = measure(requests, [&](uint64) {
+            keep(client.request(server.port(), http::method::get, "127.0.0.1", "/"));
+        });
+
+        std::vector<http::call> calls(100, http::call{http::method::get, "/", {}, ""});
+        pipelined = measure(requests / calls.size(), [&](uint64) {
+            keep(client.pipeline(server.port(), "127.0.0.1", calls));
+        }) / calls.size();
+    }
+
+    std::cout << "requests to localhost" << std::setw(28) << "new connection" << std::setw(15) << "pooled" << std::endl;
+    compare("request", before, pooled);
+    compare("pipelined request", before, pipelined);
+    std::cout << std::fixed << std::setprecision(0) << "  requests per second: " << per_second(before) << " before, "
+        << per_second(pooled) << " pooled, " << per_second(pipelined) << " pipelined" << std::endl;
+
+    fan_out();
+
+    return 0;
+}
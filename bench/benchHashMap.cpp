@@ -0,0 +1,79 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include <data/crypto/digest.hpp>
+#include "bench.hpp"
+
+// Compare the red-black tree map with the hash array 
+// mapped trie on maps keyed by 32-byte digests. 
+
+namespace data::bench {
+    
+    using digest = crypto::digest<32>;
+    
+    std::vector<digest> random_digests(size_t count, uint64 seed) {
+        std::mt19937_64 engine{seed};
+        std::vector<digest> d(count);
+        for (digest& x : d) for (byte& b : x) b = byte(engine());
+        return d;
+    }
+    
+    template <typename M>
+    M build(const std::vector<digest>& d) {
+        M m{};
+        for (size_t i = 0; i < d.size(); i++) m = m.insert(d[i], i);
+        return m;
+    }
+    
+    template <typename M>
+    size_t look_up(const M& m, const std::vector<digest>& d) {
+        size_t found = 0;
+        for (const digest& x : d) found += m.contains(x);
+        return found;
+    }
+    
+    template <typename M>
+    M remove_all(M m, const std::vector<digest>& d) {
+        for (const digest& x : d) m = m.remove(x);
+        return m;
+    }
+    
+    void run(size_t count) {
+        using tree = map<digest, size_t>;
+        using trie = hash_map<digest, size_t>;
+        
+        std::vector<digest> d = random_digests(count, 1);
+        std::vector<digest> missing = random_digests(count, 2);
+        
+        std::cout << count << " digests" << std::setw(42) << "rb_map" << std::setw(15) << "hash_map" << std::endl;
+        
+        compare("insert", 
+            measure(1, [&](uint64) { keep(build<tree>(d)); }) / count, 
+            measure(1, [&](uint64) { keep(build<trie>(d)); }) / count);
+        
+        tree a = build<tree>(d);
+        trie b = build<trie>(d);
+        
+        compare("find present", 
+            measure(1, [&](uint64) { keep(look_up(a, d)); }) / count, 
+            measure(1, [&](uint64) { keep(look_up(b, d)); }) / count);
+        
+        compare("find missing", 
+            measure(1, [&](uint64) { keep(look_up(a, missing)); }) / count, 
+            measure(1, [&](uint64) { keep(look_up(b, missing)); }) / count);
+        
+        compare("remove", 
+            measure(1, [&](uint64) { keep(remove_all(a, d)); }) / count, 
+            measure(1, [&](uint64) { keep(remove_all(b, d)); }) / count);
+    }
+    
+}
+
+int main() {
+    data::bench::run(1000);
+    data::bench::run(100000);
+    
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/hex.hpp>
+#include <data/encoding/integer.hpp>
+#include <boost/algorithm/hex.hpp>
+#include <random>
+#include <sstream>
+#include "bench.hpp"
+
+// Compare hex::encode and hex::decode with boost::algorithm,
+// which hex::write and hex::read used before.
+
+namespace data::bench {
+
+    bool boost_decode(byte* out, string_view s) {
+        try {
+            boost::algorithm::unhex(s.begin(), s.end(), out);
+        } catch (boost::algorithm::hex_decode_error) {
+            return false;
+        }
+        return true;
+    }
+
+    // what hexidecimal::write used to do.
+    std::string stream_hexidecimal(bytes_view b) {
+        std::stringstream ss;
+        ss << "0x";
+        for (int i = b.size() - 1; i >= 0; i--) ss << encoding::hex::write(b[i]);
+        return ss.str();
+    }
+
+    void run(size_t size, uint64 times) {
+        std::mt19937_64 engine{size};
+        bytes b(size);
+        for (byte& x : b) x = engine();
+        std::string text = encoding::hex::write(b);
+        std::string out(2 * size, ' ');
+        bytes back(size);
+
+        std::cout << size << " bytes" << std::setw(44) << "boost" << std::setw(15) << "hex" << std::endl;
+
+        compare("encode",
+            measure(times, [&](uint64) { boost::algorithm::hex(b.begin(), b.end(), out.begin()); keep(out); }),
+            measure(times, [&](uint64) { encoding::hex::encode(out.data(), b); keep(out); }));
+
+        compare("encode little endian",
+            measure(times, [&](uint64) { boost::algorithm::hex(b.rbegin(), b.rend(), out.begin()); keep(out); }),
+            measure(times, [&](uint64) { encoding::hex::encode(out.data(), b, endian::little); keep(out); }));
+
+        compare("decode",
+            measure(times, [&](uint64) { keep(boost_decode(back.data(), text)); }),
+            measure(times, [&](uint64) { keep(encoding::hex::decode(back.data(), text)); }));
+
+        text[text.size() / 2] = 'x';
+        compare("decode invalid",
+            measure(times, [&](uint64) { keep(boost_decode(back.data(), text)); }),
+            measure(times, [&](uint64) { keep(encoding::hex::decode(back.data(), text)); }));
+
+        compare("hexidecimal::write",
+            measure(times / 4, [&](uint64) { keep(stream_hexidecimal(b)); }),
+            measure(times / 4, [&](uint64) { keep(encoding::hexidecimal::write(b, endian::little)); }));
+
+        std::cout << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    data::bench::run(32, 1000000);
+    data::bench::run(1000, 100000);
+    data::bench::run(1 << 20, 100);
+    return 0;
+}
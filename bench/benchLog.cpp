@@ -0,0 +1,70 @@
+// Copyright (c) 2021 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <data/log/log.hpp>
+#include "bench.hpp"
+
+// Compare how long a thread waits to log a line with the file sink
+// and with async logging. What matters is the slowest calls, which
+// is when the file sink's lock is taken or its file is written.
+
+namespace data::bench {
+
+    const int lines = 20000;
+
+    // the time of each call to log, in nanoseconds.
+    std::vector<double> latencies(int threads) {
+        std::vector<std::vector<double>> times(threads);
+        std::vector<std::thread> loggers;
+        for (int i = 0; i < threads; i++) loggers.emplace_back([i, &times]() {
+            times[i].reserve(lines);
+            for (int j = 0; j < lines; j++) times[i].push_back(measure(1, [i, j](uint64) {
+                DATA_LOG_CHANNEL("bench", warning) << "thread " << i << " line " << j << " of a benchmark";
+            }));
+        });
+        for (auto& t : loggers) t.join();
+        log::flush_logging();
+        log::logging::core::get()->remove_all_sinks();
+
+        std::vector<double> all;
+        for (auto& t : times) all.insert(all.end(), t.begin(), t.end());
+        std::sort(all.begin(), all.end());
+        return all;
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    }
+
+    void run(int threads) {
+        std::cout << threads << " threads" << std::setw(38) << "file sink" << std::setw(15) << "async" << std::endl;
+
+        log::init_logging("bench_sync_%N.log");
+        std::vector<double> before = latencies(threads);
+
+        log::init_async_logging("bench_async.log");
+        std::vector<double> after = latencies(threads);
+
+        compare("p50", percentile(before, .5), percentile(after, .5));
+        compare("p99", percentile(before, .99), percentile(after, .99));
+        compare("p99.9", percentile(before, .999), percentile(after, .999));
+        std::cout << "  dropped " << log::dropped_log_lines() << std::endl;
+
+        std::remove("bench_sync_0.log");
+        std::remove("bench_async.log");
+    }
+
+}
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    data::bench::run(1);
+    data::bench::run(4);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include "bench.hpp"
+
+// Compare building sets from sorted keys and set algebra 
+// by split and join with inserting one element at a time. 
+
+namespace data::bench {
+    
+    using keys = std::vector<uint64>;
+    
+    keys sorted_keys(size_t count, uint64 step, uint64 seed) {
+        std::mt19937_64 engine{seed};
+        keys k(count);
+        uint64 x = 0;
+        for (uint64& y : k) y = x += 1 + engine() % step;
+        return k;
+    }
+    
+    set<uint64> one_by_one(const keys& k) {
+        set<uint64> s{};
+        for (uint64 x : k) s = s.insert(x);
+        return s;
+    }
+    
+    void run(size_t count, size_t smaller) {
+        keys a = sorted_keys(count, 4, 1);
+        keys b = sorted_keys(smaller, 4 * count / smaller, 2);
+        
+        std::cout << count << " and " << smaller << " keys" << std::setw(30) << "one by one" << std::setw(15) << "split/join" << std::endl;
+        
+        compare("build from sorted keys", 
+            measure(1, [&](uint64) { keep(one_by_one(a)); }), 
+            measure(1, [&](uint64) { keep(set<uint64>::from_sorted(a.begin(), a.end())); }));
+        
+        set<uint64> x = set<uint64>::from_sorted(a.begin(), a.end());
+        set<uint64> y = set<uint64>::from_sorted(b.begin(), b.end());
+        
+        compare("union", 
+            measure(1, [&](uint64) {
+                set<uint64> u = x;
+                for (uint64 k : b) u = u.insert(k);
+                keep(u);
+            }), 
+            measure(1, [&](uint64) { keep(x & y); }));
+        
+        compare("intersection", 
+            measure(1, [&](uint64) {
+                set<uint64> n{};
+                for (uint64 k : b) if (x.contains(k)) n = n.insert(k);
+                keep(n);
+            }), 
+            measure(1, [&](uint64) { keep(x | y); }));
+        
+        compare("difference", 
+            measure(1, [&](uint64) {
+                set<uint64> d = x;
+                for (uint64 k : b) d = d.remove(k);
+                keep(d);
+            }), 
+            measure(1, [&](uint64) { keep(x - y); }));
+        
+        std::cout << std::endl;
+    }
+    
+}
+
+int main(int argc, char *argv[]) {
+    for (size_t count : {100000, 1000000}) {
+        data::bench::run(count, count);
+        data::bench::run(count, count / 10);
+    }
+    return 0;
+}
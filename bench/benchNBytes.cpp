@@ -0,0 +1,77 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/data.hpp>
+#include "bench.hpp"
+
+// Compare the limb arithmetic on N_bytes with the old 
+// approach of converting to N and back again. 
+
+namespace data::bench {
+    
+    template <endian::order r>
+    std::vector<N_bytes<r>> random_numbers(size_t count, size_t size) {
+        std::mt19937_64 engine{size};
+        std::vector<N_bytes<r>> numbers(count);
+        for (N_bytes<r>& n : numbers) {
+            bytes b(size);
+            for (byte& x : b) x = engine();
+            n = N_bytes<r>{bytes_view(b)};
+        }
+        return numbers;
+    }
+    
+    template <endian::order r>
+    void run(string_view order, size_t size, uint64 times) {
+        const size_t count = 256;
+        std::vector<N_bytes<r>> a = random_numbers<r>(count, size);
+        std::vector<N_bytes<r>> b = random_numbers<r>(count, size / 2 + 1);
+        
+        std::cout << order << " endian, " << size << " bytes" << std::setw(34) << "gmp::N" << std::setw(15) << "N_bytes" << std::endl;
+        
+        compare("==", 
+            measure(times, [&](uint64 i) { keep(N{a[i % count]} == N{b[i % count]}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] == b[i % count]); }));
+        
+        compare("<", 
+            measure(times, [&](uint64 i) { keep(N{a[i % count]} < N{b[i % count]}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] < b[i % count]); }));
+        
+        compare("+", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} + N{b[i % count]}}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] + b[i % count]); }));
+        
+        compare("-", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} - N{b[i % count]}}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] - b[i % count]); }));
+        
+        compare("*", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} * N{b[i % count]}}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] * b[i % count]); }));
+        
+        compare("/", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} / N{b[i % count]}}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] / b[i % count]); }));
+        
+        compare("<< 13", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} << 13}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] << 13); }));
+        
+        compare(">> 13", 
+            measure(times, [&](uint64 i) { keep(N_bytes<r>{N{a[i % count]} >> 13}); }), 
+            measure(times, [&](uint64 i) { keep(a[i % count] >> 13); }));
+        
+        std::cout << std::endl;
+    }
+    
+}
+
+int main(int argc, char *argv[]) {
+    data::uint64 times = argc > 1 ? std::stoull(argv[1]) : 100000;
+    for (size_t size : {8, 32, 64, 256}) {
+        data::bench::run<data::endian::big>("big", size, times);
+        data::bench::run<data::endian::little>("little", size, times);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <thread>
+#include <data/parallel.hpp>
+#include <data/math/arithmetic.hpp>
+#include "bench.hpp"
+
+// Compare parallel for_each and fold with doing the same in one thread.
+// Speedup depends on the number of cores; with one core, the numbers
+// show the cost of dividing the work.
+
+namespace data::bench {
+
+    const uint64 elements = 4000000;
+    const uint64 nodes = 100000;
+
+    // enough work per element that dividing it is worth it.
+    uint64 mix(uint64 x) {
+        for (int i = 0; i < 16; i++) x = x * 6364136223846793005ull + 1442695040888963407ull;
+        return x;
+    }
+
+    void run(uint32 threads) {
+        tool::executor e{threads};
+        std::cout << threads << " threads" << std::setw(38) << "sequential" << std::setw(15) << "parallel" << std::endl;
+
+        cross<uint64> c(elements);
+        for (uint64 i = 0; i < elements; i++) c[i] = i;
+
+        compare("for_each over cross",
+            measure(20, [&c](uint64) {
+                cross<uint64> r(c.size());
+                for (size_t i = 0; i < c.size(); i++) r[i] = mix(c[i]);
+                keep(r);
+            }) / elements,
+            measure(20, [&c, &e](uint64) {
+                keep(parallel::for_each(mix, c, e));
+            }) / elements);
+
+        compare("fold over cross",
+            measure(20, [&c](uint64) {
+                uint64 x = 0;
+                for (uint64 y : c) x = plus<uint64>{}(x, y);
+                keep(x);
+            }) / elements,
+            measure(20, [&c, &e](uint64) {
+                keep(parallel::fold(plus<uint64>{}, uint64{0}, c, e));
+            }) / elements);
+
+        tool::rb_map<uint64, uint64> m{};
+        for (uint64 i = 0; i < nodes; i++) m = m.insert(i, i);
+
+        compare("for_each over rb_map",
+            measure(20, [&m](uint64) {
+                tool::rb_map<uint64, uint64> r{};
+                for (const auto& x : m) r = r.insert(x.Key, mix(x.Value));
+                keep(r);
+            }) / nodes,
+            measure(20, [&m, &e](uint64) {
+                keep(parallel::for_each(mix, m, e));
+            }) / nodes);
+
+        compare("fold over rb_map",
+            measure(20, [&m](uint64) {
+                uint64 x = 0;
+                for (const auto& y : m) x = plus<uint64>{}(x, y.Value);
+                keep(x);
+            }) / nodes,
+            measure(20, [&m, &e](uint64) {
+                keep(parallel::fold(plus<uint64>{}, uint64{0}, m, e));
+            }) / nodes);
+    }
+
+}
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    data::bench::run(1);
+    data::bench::run(std::max(2u, std::thread::hardware_concurrency()));
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/hex.hpp>
+#include <data/encoding/base58.hpp>
+#include <data/encoding/base64.hpp>
+#include <data/encoding/integer.hpp>
+#include <boost/regex.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Compare the validators with the regular expressions they used before.
+
+namespace data::bench {
+
+    namespace base64 = encoding::base64;
+
+    const boost::regex HexPattern{"^(([0-9a-f][0-9a-f])*)|(([0-9A-F][0-9A-F])*)$"};
+    const boost::regex Base58Pattern{"^1|([2-9A-HJ-NP-Za-km-z][1-9A-HJ-NP-Za-km-z]*)$"};
+    const boost::regex Base64Pattern{"^(?:[A-Za-z0-9+/]{4})*(?:[A-Za-z0-9+/]{2}==|[A-Za-z0-9+/]{3}=|[A-Za-z0-9+/]{4})$"};
+    const boost::regex DecimalPattern{"^0|([1-9][0-9]*)$"};
+
+    bool matches(const std::string& s, const boost::regex& p) {
+        return boost::regex_match(s, p);
+    }
+
+    template <typename valid>
+    void run(string_view name, const std::string& s, const boost::regex& p, valid v, uint64 times) {
+        try {
+            if (matches(s, p) != v(s)) std::cout << "  " << name << " results differ!" << std::endl;
+        } catch (const std::runtime_error&) {
+            // boost::regex runs out of stack on long strings.
+            std::cout << "  " << name << " regex fails" << std::endl;
+            report(name, measure(times, [&](uint64) { keep(v(s)); }));
+            return;
+        }
+        compare(name,
+            measure(times, [&](uint64) { keep(matches(s, p)); }),
+            measure(times, [&](uint64) { keep(v(s)); }));
+    }
+
+    void run(size_t size, uint64 times) {
+        std::mt19937_64 engine{size};
+        bytes b(size);
+        for (byte& x : b) x = engine();
+
+        std::string hex = encoding::hex::write(b);
+        std::string b58(size, ' ');
+        for (char& c : b58) c = encoding::base58::characters()[1 + engine() % 57];
+        std::string b64(base64::encoded_size(size), ' ');
+        base64::encode(b64.data(), b);
+        std::string dec(size, ' ');
+        for (char& c : dec) c = '1' + engine() % 9;
+
+        std::cout << size << " bytes" << std::setw(44) << "regex" << std::setw(15) << "classify" << std::endl;
+
+        run("hex", hex, HexPattern, [](string_view s) { return encoding::hex::valid(s); }, times);
+        run("base58", b58, Base58Pattern, [](string_view s) { return encoding::base58::valid(s); }, times);
+        run("base64", b64, Base64Pattern, [](string_view s) { return base64::valid(s); }, times);
+        run("decimal", dec, DecimalPattern, [](string_view s) { return encoding::decimal::valid(s); }, times);
+
+        // an invalid character at the end.
+        hex.back() = 'g';
+        run("hex invalid", hex, HexPattern, [](string_view s) { return encoding::hex::valid(s); }, times);
+
+        std::cout << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    data::bench::run(32, 100000);
+    data::bench::run(1000, 10000);
+    data::bench::run(1 << 20, 10);
+    return 0;
+}
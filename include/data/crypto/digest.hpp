@@ -4,6 +4,7 @@
 
 #ifndef DATA_CRYPTO_DIGEST
 #define DATA_CRYPTO_DIGEST
+#include <cstring>
 #include "data/types.hpp"
 #include <data/math/number/bounded/bounded.hpp>
 
@@ -16,7 +17,7 @@ namespace data::crypto {
         using uint<s>::uint;
         
         digest() : uint<s>() {}
-        digest(const digest& d) : uint<s>{static_cast<uint<s>&>(d)} {}
+        digest(const digest& d) : uint<s>{static_cast<const uint<s>&>(d)} {}
         
         digest(bytes_view b) : uint<s>{0} {
             if (b.size() == s) std::copy(b.begin(), b.end(), uint<s>::begin());
@@ -28,6 +29,16 @@ namespace data::crypto {
     };
 
 
+    // digests are uniformly distributed, so the first 
+    // eight bytes are as good a hash as any. 
+    template <size_t s>
+    inline uint64 hash_key(const digest<s>& d) {
+        static_assert(s >= sizeof(uint64));
+        uint64 h;
+        std::memcpy(&h, d.Data.data(), sizeof(uint64));
+        return h;
+    }
+
     template<size_t s>
     inline bool digest<s>::valid() const {
         return operator!=(digest{0});
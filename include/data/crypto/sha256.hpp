@@ -33,7 +33,8 @@ namespace data::crypto::sha256 {
     
     template <typename A>
     inline digest double_hash(A a) {
-        return hash<size>(hash(a).Digest);
+        digest d = hash(a);
+        return hash(bytes_view{d.data(), size});
     }
 
 }
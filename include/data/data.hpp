@@ -30,6 +30,10 @@
 
 // Thread safe communication channel, similar to golang. 
 #include <data/tools/channel.hpp>
+#include <data/tools/select.hpp>
+
+// divide work on data structures among threads. 
+#include <data/parallel.hpp>
 
 namespace data {
     
@@ -118,6 +122,18 @@ namespace data {
     
 }
 
+#include <data/math/number/bytes/N.hpp>
+
+namespace data {
+    
+    // Natural numbers and integers stored as byte strings 
+    // with a given endian order. 
+    template <endian::order r> using N_bytes = math::number::N_bytes<r>;
+    
+    template <endian::order r> using Z_bytes = math::number::Z_bytes<r>;
+    
+}
+
 // Some algebra
 #include <data/math/polynomial.hpp>
 #include <data/math/permutation.hpp>
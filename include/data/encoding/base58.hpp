@@ -8,9 +8,9 @@
 #include <data/types.hpp>
 #include <data/encoding/digits.hpp>
 #include <data/encoding/invalid.hpp>
+#include <data/encoding/classify.hpp>
 #include <data/math/division.hpp>
 #include <data/iterable.hpp>
-#include <boost/regex.hpp>
 #include <algorithm>
 #include <iostream>
 
@@ -20,10 +20,11 @@ namespace data::encoding::base58 {
     
     inline std::string characters() {return "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";}
 
-    static const boost::regex pattern {"^1|([2-9A-HJ-NP-Za-km-z][1-9A-HJ-NP-Za-km-z]*)$"};
-    
+    // a number without leading zeros, which are written as '1'. 
     inline bool valid(const string_view s) {
-        return boost::regex_match(s.data(),pattern);
+        if (s.size() == 0) return false;
+        if (s[0] == '1') return s.size() == 1;
+        return !(classify(s, {{'1', '9', 1}, {'A', 'H', 1}, {'J', 'N', 1}, {'P', 'Z', 1}, {'a', 'k', 1}, {'m', 'z', 1}}) & unclassified);
     }
     
     inline char digit(char c) {
@@ -33,19 +34,8 @@ namespace data::encoding::base58 {
     template <typename N>
     N read(const string_view s) {
         if (s.size() == 0) return N{};
-        
-        N power{1};
-        
-        N n{0};
-        
-        for (int i = s.size() - 1; i >= 0; i--) {
-            char v = digit(s[i]);
-            if (v == -1) return N{};
-            n += power * uint64(v);
-            power *= 58;
-        }
-        
-        return n;
+        for (char c : s) if (digit(c) == -1) return N{};
+        return read_base<N>(s, 58, &digit);
     }
     
     class view : public string_view {
@@ -107,8 +97,25 @@ namespace data::encoding::base58 {
         return encoding::write_base<N>(n, characters());
     };
     
+    // write bytes as a number, so that leading zeros are dropped. 
     string write(const bytes_view b);
     
+    // Bitcoin's encoding of bytes, in which each leading zero byte is written 
+    // as '1'. The conversion is done on 32 bit limbs without a bignum. 
+    std::string encode(bytes_view);
+    
+    // returns false if s has a character that is not in base58. 
+    bool decode(bytes& out, string_view s);
+    
+    // base58check: the payload followed by the first four 
+    // bytes of its double sha256, encoded as base58. 
+    namespace check {
+        std::string encode(bytes_view payload);
+        
+        // returns false if s is not base58 or the checksum is wrong. 
+        bool decode(bytes& payload, string_view s);
+    }
+    
 }
 
 #endif
@@ -6,8 +6,8 @@
 #ifndef DATA_ENCODING_BASE64
 #define DATA_ENCODING_BASE64
 
-#include <boost/regex.hpp>
 #include <data/encoding/invalid.hpp>
+#include <data/encoding/classify.hpp>
 #include <data/iterable.hpp>
 #include <data/math/division.hpp>
 
@@ -20,14 +20,76 @@ namespace data::encoding::base64 {
     }
     
     constexpr static char Pad = '=';
-    static const boost::regex pattern{"^(?:[A-Za-z0-9+/]{4})*(?:[A-Za-z0-9+/]{2}==|[A-Za-z0-9+/]{3}=|[A-Za-z0-9+/]{4})$"};
-
+    // groups of four characters, the last of which may be padded. 
     inline bool valid(string_view s) {
-        return boost::regex_match(s.data(),pattern);
+        if (s.size() == 0 || s.size() % 4 != 0) return false;
+        size_t padding = s[s.size() - 1] != Pad ? 0 : s[s.size() - 2] != Pad ? 1 : 2;
+        return !(classify(s.substr(0, s.size() - padding), 
+            {{'A', 'Z', 1}, {'a', 'z', 1}, {'0', '9', 1}, {'+', '+', 1}, {'/', '/', 1}}) & unclassified);
     }
     
     ptr<bytes> read(string_view);
     
+    enum alphabet {
+        standard, 
+        // - and _ in place of + and /, for URLs and file names. 
+        url
+    };
+    
+    // the size of the encoding of n bytes, with padding. 
+    constexpr size_t encoded_size(size_t n) {
+        return (n + 2) / 3 * 4;
+    }
+    
+    // the most bytes that can come from n characters. 
+    constexpr size_t decoded_size(size_t n) {
+        return n / 4 * 3 + n % 4 * 3 / 4;
+    }
+    
+    // Write the encoding of b to out, with padding. Uses AVX2 if the processor has it. 
+    void encode(char* out, bytes_view b, alphabet = standard);
+    
+    // Decode s into out, which must have room for decoded_size(s.size()) bytes, 
+    // and set size to the number of bytes written. Validates s in the same pass 
+    // and returns false if it is not base64. Padding may be left off the end. 
+    bool decode(byte* out, string_view s, size_t& size, alphabet = standard);
+    
+    // encode bytes that are given in pieces of any size. 
+    struct encoder {
+        explicit encoder(alphabet a = standard) : Rest{}, Size{0}, Alphabet{a} {}
+        
+        // append to out the encoding of as much as can be encoded so far. 
+        void write(std::string& out, bytes_view);
+        
+        // append the rest with padding. 
+        void finish(std::string& out);
+        
+    private:
+        byte Rest[3];
+        size_t Size;
+        alphabet Alphabet;
+    };
+    
+    // decode a string that is given in pieces of any size. 
+    struct decoder {
+        explicit decoder(alphabet a = standard) : Rest{}, Size{0}, Padded{false}, Failed{false}, Alphabet{a} {}
+        
+        // append to out the bytes of as much as can be decoded so far. 
+        // Returns false if the input is not base64. 
+        bool write(bytes& out, string_view);
+        
+        // append the last bytes. Returns false if the input was cut short. 
+        bool finish(bytes& out);
+        
+    private:
+        char Rest[4];
+        size_t Size;
+        // whether we have seen the end of the input. 
+        bool Padded;
+        bool Failed;
+        alphabet Alphabet;
+    };
+    
     struct string : std::string {
         using std::string::string;
         string(const std::string& x) : std::string{x} {}
@@ -0,0 +1,29 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_ENCODING_CLASSIFY
+#define DATA_ENCODING_CLASSIFY
+
+#include <data/types.hpp>
+#include <initializer_list>
+
+namespace data::encoding {
+    
+    // the characters from First to Last, which are marked with Bit. 
+    struct character_class {
+        char First;
+        char Last;
+        byte Bit;
+    };
+    
+    // the bit that marks characters that are in no class. 
+    const byte unclassified = 0x80;
+    
+    // the bits of every class that has a character of s in it, together. 
+    // There may be up to eight classes. Uses AVX2 if the processor has it. 
+    byte classify(string_view s, std::initializer_list<character_class>);
+    
+}
+
+#endif
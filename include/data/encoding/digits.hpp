@@ -5,45 +5,183 @@
 #ifndef DATA_ENCODING_DIGITS
 #define DATA_ENCODING_DIGITS
 
-#include <data/tools/linked_stack.hpp>
 #include <data/math/number/natural.hpp>
+#include <data/encoding/invalid.hpp>
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace data::encoding {
+    
+    // the digits that gmp uses: 0-9 and a-z up to base 36,
+    // then 0-9, A-Z and a-z up to base 62.
+    inline std::string standard_digits(uint32 base) {
+        if (base < 2 || base > 62) return "";
+        if (base <= 36) return std::string{"0123456789abcdefghijklmnopqrstuvwxyz"}.substr(0, base);
+        return std::string{"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"}.substr(0, base);
+    }
+    
+    namespace radix {
+        
+        // A number type can provide its own conversion to and from the standard
+        // digits by overloading these functions, to be found by ADL:
+        //     std::string write_digits(const N&, uint32 base);
+        //     void read_digits(N&, const std::string&, uint32 base);
+        // gmp::N does this with mpz_get_str and mpz_set_str.
+        template <typename N, typename = void>
+        struct standard : std::false_type {};
+        
+        template <typename N>
+        struct standard<N, std::void_t<
+            decltype(write_digits(std::declval<const N&>(), uint32{})),
+            decltype(read_digits(std::declval<N&>(), std::declval<const std::string&>(), uint32{}))>> : std::true_type {};
+        
+        // the number of digits that fit in a uint64, and the base to that power.
+        struct chunk {
+            uint32 Digits;
+            uint64 Power;
+            
+            explicit chunk(uint32 base) : Digits{0}, Power{1} {
+                while (Power <= std::numeric_limits<uint64>::max() / base) {
+                    Power *= base;
+                    Digits++;
+                }
+            }
+        };
+        
+        // chunk^(2^i) for each i until one is bigger than n.
+        template <typename N>
+        std::vector<N> powers(const chunk& c, const N& n) {
+            std::vector<N> p{N{c.Power}};
+            while (p.back() <= n) p.push_back(p.back() * p.back());
+            return p;
+        }
+        
+        // write x < p[level] as exactly Digits * 2^level digits.
+        template <typename N>
+        void write(char* o, const N& x, const std::vector<N>& p, size_t level, const chunk& c, const std::string& digits) {
+            if (level == 0) {
+                uint64 u = uint64(x);
+                for (size_t i = c.Digits; i > 0; i--) {
+                    o[i - 1] = digits[u % digits.size()];
+                    u /= digits.size();
+                }
+                return;
+            }
+            
+            math::division<N> d = x.divide(p[level - 1]);
+            size_t half = size_t(c.Digits) << (level - 1);
+            write(o, d.Quotient, p, level - 1, c, digits);
+            write(o + half, d.Remainder, p, level - 1, c, digits);
+        }
+        
+        // read at most Digits * 2^level digits.
+        template <typename N, typename f>
+        N read(string_view s, const std::vector<N>& p, size_t level, const chunk& c, uint32 base, f inverse_digits) {
+            if (level == 0) {
+                uint64 u = 0;
+                for (char x : s) u = u * base + static_cast<byte>(inverse_digits(x));
+                return N{u};
+            }
+            
+            size_t half = size_t(c.Digits) << (level - 1);
+            if (s.size() <= half) return read<N>(s, p, level - 1, c, base, inverse_digits);
+            return read<N>(s.substr(0, s.size() - half), p, level - 1, c, base, inverse_digits) * p[level - 1] +
+                read<N>(s.substr(s.size() - half), p, level - 1, c, base, inverse_digits);
+        }
+        
+    }
+    
+    // write n in the base given by the number of digits. Zero is written as the empty string.
+    // Conversion is done by splitting n on powers of the base, so that it is subquadratic
+    // when division is, and with gmp for types that support it.
     template <typename N>
     std::string write_base(const N& n, std::string digits) {
         uint32 base = digits.size();
-        if (base < 2) return "";
-        tool::linked_stack<char> dig{};
-        N x = n;
-        while(x > 0) {
-            math::division<N> d = x.divide(base);
-            dig = dig << digits[(uint64)(d.Remainder)];
-            x = d.Quotient;
-        }
+        if (base < 2 || n == 0) return "";
         
-        std::string o;
-        o.resize(dig.size());
-        int i = 0;
-        while(dig.size() > 0) {
-            o[i] = dig.first();
-            dig = dig.rest();
-            i++;
+        if constexpr (radix::standard<N>::value) if (base <= 62) {
+            std::string o = write_digits(n, base);
+            std::string standard = standard_digits(base);
+            if (digits == standard) return o;
+            char translate[256];
+            for (uint32 i = 0; i < base; i++) translate[static_cast<byte>(standard[i])] = digits[i];
+            for (char& x : o) x = translate[static_cast<byte>(x)];
+            return o;
         }
         
-        return o;
+        radix::chunk c{base};
+        std::vector<N> p = radix::powers(c, n);
+        std::string o(size_t(c.Digits) << (p.size() - 1), digits[0]);
+        radix::write(o.data(), n, p, p.size() - 1, c, digits);
+        // remove leading zeros.
+        return o.substr(o.find_first_not_of(digits[0]));
     }
     
+    // inverse_digits must give a value less than base for every character of s.
     template <typename N, typename f>
     N read_base(string_view s, uint32 base, f inverse_digits) {
-        N n{0};
-        N pow{1};
-        for (auto x = s.rbegin(); x != s.rend(); ++x) {
-            n += pow * inverse_digits(*x);
-            pow *= base;
+        if (s.size() == 0 || base < 2) return N{0};
+        
+        if constexpr (radix::standard<N>::value) if (base <= 62) {
+            std::string standard = standard_digits(base);
+            std::string x(s.size(), ' ');
+            bool translated = true;
+            for (size_t i = 0; i < s.size(); i++) {
+                byte d = static_cast<byte>(inverse_digits(s[i]));
+                if (d >= base) {
+                    translated = false;
+                    break;
+                }
+                x[i] = standard[d];
+            }
+            
+            if (translated) {
+                N n{0};
+                read_digits(n, x, base);
+                return n;
+            }
+        }
+        
+        radix::chunk c{base};
+        size_t level = 0;
+        while ((size_t(c.Digits) << level) < s.size()) level++;
+        std::vector<N> p{N{c.Power}};
+        while (p.size() < level) p.push_back(p.back() * p.back());
+        return radix::read<N>(s, p, level, c, base, inverse_digits);
+    }
+    
+    // write n with the standard digits of the given base, which may be from 2 to 62.
+    template <typename N>
+    std::string write_base(const N& n, uint32 base) {
+        if (base < 2 || base > 62) throw std::invalid_argument{"base must be from 2 to 62"};
+        if (n == 0) return "0";
+        return write_base<N>(n, standard_digits(base));
+    }
+    
+    // read a number written with the standard digits of the given base, which may be from 2 to 62.
+    // Letters may be of either case up to base 36.
+    template <typename N>
+    N read_base(string_view s, uint32 base) {
+        if (base < 2 || base > 62) throw std::invalid_argument{"base must be from 2 to 62"};
+        if (s.size() == 0) throw invalid{"base " + std::to_string(base), s};
+        
+        std::string standard = standard_digits(base);
+        char inverse[256];
+        std::fill(inverse, inverse + 256, char(-1));
+        for (uint32 i = 0; i < base; i++) {
+            inverse[static_cast<byte>(standard[i])] = i;
+            if (base <= 36) inverse[static_cast<byte>(std::toupper(standard[i]))] = i;
         }
-        return n;
+        
+        for (char x : s) if (inverse[static_cast<byte>(x)] < 0) throw invalid{"base " + std::to_string(base), s};
+        return read_base<N>(s, base, [&inverse](char x) -> char {
+            return inverse[static_cast<byte>(x)];
+        });
     }
 }
 
 #endif
-
@@ -6,10 +6,9 @@
 #ifndef DATA_ENCODING_HEX
 #define DATA_ENCODING_HEX
 
-#include <boost/algorithm/hex.hpp>
 #include <data/encoding/invalid.hpp>
+#include <data/encoding/classify.hpp>
 #include <data/iterable.hpp>
-#include <boost/regex.hpp>
 
 namespace data::encoding::hex {
     const std::string Format{"hex"};
@@ -27,13 +26,25 @@ namespace data::encoding::hex {
         return "0123456789ABCDEF";
     }
 
-    static const boost::regex pattern{"^(([0-9a-f][0-9a-f])*)|(([0-9A-F][0-9A-F])*)$"};
+    // an even number of digits, all upper case or all lower case. 
     inline bool valid(string_view s) {
-        return boost::regex_match(s.data(), pattern);
+        if (s.size() & 1) return false;
+        byte c = classify(s, {{'0', '9', 1}, {'a', 'f', 2}, {'A', 'F', 4}});
+        return !(c & unclassified) && (c & 6) != 6;
     }
     
     ptr<bytes> read(string_view);
     
+    // Write the 2 * b.size() characters of b to out. If the order is little, 
+    // the bytes are written last to first. Uses AVX2 if the processor has it. 
+    void encode(char* out, bytes_view b, endian::order = endian::big, letter_case = upper);
+    
+    // Read s.size() / 2 bytes into out, in reverse if the order is little. Upper 
+    // and lower case may be mixed. Returns false if s has an odd size or a 
+    // character that is not a hex digit, in which case out has been written 
+    // up to some unspecified point. 
+    bool decode(byte* out, string_view s, endian::order = endian::big);
+    
     struct string : std::string {
         string() : std::string{} {}
         string(const std::string& x) : std::string{x} {}
@@ -71,8 +82,7 @@ namespace data::encoding::hex {
     template <endian::order o, size_t x>
     fixed<x> write(endian::arithmetic<o, false, x> n, letter_case q) {
         fixed<x> output;
-        if (q == upper) boost::algorithm::hex(n.begin(), n.end(), output.begin());
-        else boost::algorithm::hex_lower(n.begin(), n.end(), output.begin());
+        encode(output.data(), bytes_view{n.data(), x}, endian::big, q);
         return output;
     }
     
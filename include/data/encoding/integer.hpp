@@ -8,16 +8,15 @@
 
 #include <data/types.hpp>
 #include <data/encoding/hex.hpp>
+#include <data/encoding/classify.hpp>
 #include <data/encoding/invalid.hpp>
 #include <data/encoding/endian.hpp>
 #include <data/math/division.hpp>
 #include <boost/algorithm/hex.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/regex.hpp>
 
 namespace data::encoding {
     namespace decimal {
-        static const boost::regex pattern{"^0|([1-9][0-9]*)$"};
         inline std::string characters() {
             return "0123456789";
         }
@@ -26,8 +25,11 @@ namespace data::encoding {
             return x < '0' || x > '9' ? -1 : x - '0';
         }
         
+        // digits without leading zeros. 
         inline bool valid(string_view s) {
-            return boost::regex_match(s.data(),pattern);
+            if (s.size() == 0) return false;
+            if (s[0] == '0') return s.size() == 1;
+            return !(classify(s, {{'0', '9', 1}}) & unclassified);
         } 
         
         inline bool nonzero(string_view s) {
@@ -79,18 +81,18 @@ namespace data::encoding {
     };
     
     namespace hexidecimal {
-        static const boost::regex pattern{"0x((([0-9a-f][0-9a-f])*)|(([0-9A-F][0-9A-F])*))"};
-        static const boost::regex zero_pattern{"^0x(00)*$"};
+        // 0x followed by hex. 
         inline bool valid(string_view s) {
-            return boost::regex_match(s.data(),pattern);
+            return s.size() >= 2 && s[0] == '0' && s[1] == 'x' && hex::valid(s.substr(2));
         } 
         
         inline bool zero(string_view s) {
-            return boost::regex_match(s.data(),zero_pattern);
+            return s.size() >= 2 && s[0] == '0' && s[1] == 'x' && s.size() % 2 == 0 && 
+                !(classify(s.substr(2), {{'0', '0', 1}}) & unclassified);
         }
         
         inline bool nonzero(string_view s) {
-            return valid(s) && !boost::regex_match(s.data(),zero_pattern);
+            return valid(s) && !zero(s);
         }
         
         inline uint32 digits(string_view s) {
@@ -108,11 +110,7 @@ namespace data::encoding {
         
         std::ostream& write(std::ostream& o, bytes_view b, endian::order r, hex::letter_case q = hex::upper);
         
-        inline std::string write(bytes_view b, endian::order r, hex::letter_case q = hex::upper) {
-            std::stringstream ss;
-            write(ss, b, r, q);
-            return ss.str();
-        }
+        std::string write(bytes_view b, endian::order r, hex::letter_case q = hex::upper);
         
         struct N : string {
             N();
@@ -156,20 +154,16 @@ namespace data::encoding {
     };
     
     namespace natural {
-        static const boost::regex pattern{"^0|([1-9][0-9]*)|(0x((([0-9a-f][0-9a-f])*)|(([0-9A-F][0-9A-F])*)))$"};
-
-        static const boost::regex zero_pattern{"^0|0x(00)*$"};
-        
         inline bool valid(string_view s) {
-            return boost::regex_match(s.data(),pattern);
+            return decimal::valid(s) || hexidecimal::valid(s);
         } 
         
         inline bool zero(string_view s) {
-            return boost::regex_match(s.data(),zero_pattern);
+            return s == "0" || hexidecimal::zero(s);
         }
         
         inline bool nonzero(string_view s) {
-            return valid(s) && ! boost::regex_match(s.data(),zero_pattern);
+            return valid(s) && !zero(s);
         }
         
         inline uint32 digits(string_view s) {
@@ -180,24 +174,28 @@ namespace data::encoding {
     };
     
     namespace integer {
-        static const boost::regex pattern{"^0|(-?[1-9][0-9]*)|(0x((([0-9a-f][0-9a-f])*)|(([0-9A-F][0-9A-F])*)))$"};
-        static const boost::regex zero_pattern {"^0|0x(00)*$"};
-        static const boost::regex negative_pattern{"^(-(0*[1-9][0-9]*))|0x(([8-9a-f][0-9a-f]([0-9a-f][0-9a-f])*)|([8-9A-F][0-9A-F]([0-9A-F][0-9A-F])*))"};
-        
         inline bool valid(string_view s) {
-            return boost::regex_match(s.data(),pattern);
+            return natural::valid(s) || (s.size() > 1 && s[0] == '-' && s[1] != '0' && decimal::valid(s.substr(1)));
         } 
         
+        // a minus sign followed by digits that are not all zero, 
+        // or hex whose first digit has its highest bit set. 
         inline bool negative(string_view s) {
-            return boost::regex_match(s.data(),negative_pattern);
+            if (s.size() > 1 && s[0] == '-') {
+                byte c = classify(s.substr(1), {{'0', '0', 1}, {'1', '9', 2}});
+                return !(c & unclassified) && (c & 2);
+            }
+            
+            return s.size() > 2 && hexidecimal::valid(s) && 
+                ((s[2] >= '8' && s[2] <= '9') || (s[2] >= 'a' && s[2] <= 'f') || (s[2] >= 'A' && s[2] <= 'F'));
         }
         
         inline bool zero(string_view s) {
-            return boost::regex_match(s.data(),zero_pattern);
+            return natural::zero(s);
         }
         
         inline bool nonzero(string_view s) {
-            return valid(s) && ! boost::regex_match(s.data(),zero_pattern);
+            return valid(s) && !zero(s);
         }
         
         inline uint32 digits(string_view s) {
@@ -5,26 +5,40 @@
 #ifndef DATA_FOLD
 #define DATA_FOLD
 
+#include <vector>
 #include <data/interface.hpp>
 
 namespace data {
 
     template <typename x, typename f, typename l>
-    inline x fold(f fun, x init, l ls) {
-        if (data::empty(ls)) return init;
-        return fold(fun, fun(init, data::first(ls)), data::rest(ls));
+    x fold(f fun, x init, l ls) {
+        while (!data::empty(ls)) {
+            init = fun(init, data::first(ls));
+            ls = data::rest(ls);
+        }
+        return init;
     }
     
     template <typename x, typename f>
-    inline x nest(f fun, uint32 rounds, x init) {
-        if (rounds == 0) return init;
-        return nest(fun, fun(init), rounds - 1);
+    x nest(f fun, uint32 rounds, x init) {
+        for (; rounds > 0; rounds--) init = fun(init);
+        return init;
     }
     
+    // reduce associates to the right, so the elements 
+    // are collected first and combined from the end. 
     template <typename x, typename f, typename l>
-    inline x reduce(f fun, l ls) {
-        if (data::empty(ls)) return x{};
-        return fun(data::first(ls), reduce<x>(fun, data::rest(ls)));
+    x reduce(f fun, l ls) {
+        std::vector<std::decay_t<decltype(data::first(ls))>> elements{};
+        elements.reserve(data::size(ls));
+        while (!data::empty(ls)) {
+            elements.push_back(data::first(ls));
+            ls = data::rest(ls);
+        }
+        
+        x result{};
+        for (auto e = elements.rbegin(); e != elements.rend(); ++e) result = fun(*e, result);
+        return result;
     }
 
 }
@@ -15,6 +15,7 @@
 #include <data/tools/linked_tree.hpp>
 #include <data/tools/rb_map.hpp>
 #include <data/tools/functional_queue.hpp>
+#include <data/tools/persistent_vector.hpp>
 #include <data/tools/entry_function.hpp>
 #include <data/tools/iterator_list.hpp>
 
@@ -46,11 +47,22 @@ namespace data::meta::functional {
         }
     };
     
+    // a list of the same kind as the input. 
+    template <typename input, typename element> 
+    struct queue_output {
+        using type = tool::functional_queue<tool::linked_stack<element>>;
+    };
+    
+    template <typename X, typename alloc, typename element> 
+    struct queue_output<tool::persistent_vector<X, alloc>, element> {
+        using type = tool::persistent_vector<element, alloc>;
+    };
+    
     template <typename function, typename input, typename proof = interface::list<input>> 
     struct for_each_queue  {
         using input_element = typename interface::sequence<input>::element;
         using output_element = typename std::invoke_result<function, input_element>::type;
-        using output = tool::functional_queue<tool::linked_stack<output_element>>;
+        using output = typename queue_output<input, output_element>::type;
         
         output operator()(const function f, const input l) const {
             return queue::for_each<function, input, output>{}(f, l);
@@ -5,6 +5,8 @@
 #ifndef DATA_ITERABLE
 #define DATA_ITERABLE
 
+#include <array>
+#include <stdexcept>
 #include <data/interface.hpp>
 #include <data/slice.hpp>
 #include <data/encoding/endian.hpp>
@@ -135,36 +137,49 @@ namespace data {
         section(ptr<cross<X>> d) : slice<X>(slice<X>(*d)), Data(d) {}
     };
     
+    // A section of fixed size keeps its data in place, so it 
+    // can be copied and modified without touching the heap. 
     template <typename X, size_t size> struct section<X, size> : slice<X, size> {
-        ptr<cross<X>> Data;
+        std::array<X, size> Data;
         
         bool valid() const {
-            return slice<X, size>::valid() && Data != nullptr;
+            return slice<X, size>::valid();
         }
         
-        section() : slice<X>(), Data() {} 
+        section() : slice<X, size>(nullptr), Data{} {
+            slice<X>::Data = Data.data();
+        }
+        
+        section(const section& s) : slice<X, size>(nullptr), Data{s.Data} {
+            slice<X>::Data = Data.data();
+        }
+        
+        section& operator=(const section& s) {
+            Data = s.Data;
+            return *this;
+        }
         
+        // these throw std::invalid_argument if there are not size elements to take. 
         section(ptr<cross<X>> d, size_t begin) : 
-            section(d, d == nullptr || d.size() - begin < size ? 
-                slice<X, size>() : 
-                slice<X, size>(d->data())) {}
+            section(d == nullptr ? throw std::invalid_argument{"section of null"} : section(view<X>(d->data(), d->size()), begin)) {}
         
-        section(view<X> d, size_t begin) : 
-            section(d.size() - begin < size ? 
-                section() :
-                section(std::make_shared<cross<X>>(d), begin)) {}
+        section(view<X> d, size_t begin) : section() {
+            if (begin > d.size() || d.size() - begin < size) throw std::invalid_argument{"section out of range"};
+            std::copy_n(d.begin() + begin, size, Data.begin());
+        }
         
         section(view<X> d, size_t begin, size_t end) : 
-            section(end - begin != size ? 
-                section() :
-                section(std::make_shared<cross<X>>(d), begin)) {}
+            section(end < begin || end - begin != size ? throw std::invalid_argument{"section of wrong size"} : section(d, begin)) {}
         
-        section(const slice<X, size>);
+        section(view<X> d) : section(d, 0, d.size()) {}
         
-        section(X fill) : section(std::make_shared<cross<X>>(size, fill)) {}
+        section(const slice<X, size> s) : section() {
+            std::copy_n(s.begin(), size, Data.begin());
+        }
         
-    private:
-        section(ptr<cross<X>> d) : slice<X, size>(d->data()), Data(d) {}
+        section(X fill) : section() {
+            Data.fill(fill);
+        }
         
     };
     
@@ -84,8 +84,13 @@ namespace data {
     
     template <typename list>
     list join(const list&a, const list& b) {
-        if (b.empty()) return a;
-        return join(a << b.first(), b.rest());
+        list x = a;
+        list y = b;
+        while (!y.empty()) {
+            x = x << y.first();
+            y = y.rest();
+        }
+        return x;
     }
 }
 
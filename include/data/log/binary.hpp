@@ -0,0 +1,182 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_LOG_BINARY_HPP
+#define DATA_LOG_BINARY_HPP
+
+#include <data/log/log.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Binary logging. Every statement is registered once with its format
+// string and the types of its arguments, and gets an id. A record is
+// only the id, a timestamp and the bytes of its arguments, which a
+// thread copies into a buffer of its own. A background thread writes
+// the buffers to a file, which decode turns back into lines of text.
+//
+//     DATA_LOG_BINARY(warning, "peer {} sent {} bytes", address, n);
+//
+// {} is replaced by the next argument. Arguments may be numbers, enums,
+// pointers, and strings, which are copied.
+
+namespace data::log {
+
+    struct binary_options {
+        // bytes of records that each thread may have waiting to be written.
+        size_t ThreadBuffer = 1 << 20;
+        overflow Overflow = overflow::drop;
+    };
+
+    // start logging records to a file. Any binary log that was open is closed.
+    // Threads may be logging while this is called, though records that they
+    // log to the old file as it closes may be lost.
+    void init_binary_logging(std::string filename, binary_options options = {});
+
+    // write what has been logged and close the file. No thread may be
+    // logging while this is called.
+    void close_binary_logging();
+
+    // records that binary logging has dropped because a thread's buffer was full.
+    uint64_t dropped_log_records();
+
+    namespace binary {
+
+        // the code of each type of argument in a statement's signature.
+        template <typename X, typename = void> struct argument;
+
+        template <typename X> struct number {
+            static size_t size(const X&) {
+                return sizeof(X);
+            }
+
+            static char* write(char* p, const X& x) {
+                std::memcpy(p, &x, sizeof(X));
+                return p + sizeof(X);
+            }
+        };
+
+        template <> struct argument<bool> : number<bool> { static constexpr char code = 'b'; };
+        template <> struct argument<char> : number<char> { static constexpr char code = 'c'; };
+        template <> struct argument<float> : number<float> { static constexpr char code = 'f'; };
+        template <> struct argument<double> : number<double> { static constexpr char code = 'd'; };
+
+        // integers are coded by size, upper case when unsigned.
+        template <typename X> struct argument<X, std::enable_if_t<
+            std::is_integral_v<X> && !std::is_same_v<X, bool> && !std::is_same_v<X, char>>> : number<X> {
+            static constexpr char code = (std::is_signed_v<X> ? "\0hs\0i\0\0\0l" : "\0HS\0I\0\0\0L")[sizeof(X)];
+        };
+
+        template <typename X> struct argument<X, std::enable_if_t<std::is_enum_v<X>>> :
+            number<std::underlying_type_t<X>> {
+            static constexpr char code = argument<std::underlying_type_t<X>>::code;
+
+            static size_t size(const X&) {
+                return sizeof(X);
+            }
+
+            static char* write(char* p, const X& x) {
+                return number<std::underlying_type_t<X>>::write(p, static_cast<std::underlying_type_t<X>>(x));
+            }
+        };
+
+        template <typename X> struct argument<X*, std::enable_if_t<
+            !std::is_same_v<std::remove_cv_t<X>, char>>> : number<uint64_t> {
+            static constexpr char code = 'p';
+
+            static char* write(char* p, const X* x) {
+                return number<uint64_t>::write(p, reinterpret_cast<uint64_t>(x));
+            }
+        };
+
+        // strings are a 32 bit size followed by their characters.
+        struct text {
+            static constexpr char code = 'z';
+
+            static size_t size(std::string_view x) {
+                return 4 + x.size();
+            }
+
+            static char* write(char* p, std::string_view x) {
+                uint32_t n = static_cast<uint32_t>(x.size());
+                std::memcpy(p, &n, 4);
+                std::memcpy(p + 4, x.data(), n);
+                return p + 4 + n;
+            }
+        };
+
+        template <> struct argument<const char*> : text {};
+        template <> struct argument<char*> : text {};
+        template <> struct argument<std::string> : text {};
+        template <> struct argument<std::string_view> : text {};
+
+        template <typename... X> struct signature {
+            static constexpr char value[] = {argument<std::decay_t<X>>::code..., '\0'};
+        };
+
+        // the types of the arguments of a statement, without evaluating them.
+        template <typename... X> signature<X...> types(const X&...);
+
+        // register a statement and get its id.
+        uint32_t define(const char* channel, severity_level, const char* format,
+            const char* signature, const char* file, uint32_t line);
+
+        // the header of every record.
+        struct header {
+            uint32_t Site;
+            // bytes of arguments after the header.
+            uint32_t Size;
+            // nanoseconds since the epoch.
+            uint64_t Time;
+        };
+
+        // space in the calling thread's buffer for a record with the
+        // given size of arguments, or nullptr if it cannot be logged.
+        char* reserve(uint32_t size);
+
+        // make the record that was reserved last visible to the writer.
+        void commit(char* end);
+
+        extern std::atomic<bool> enabled;
+
+        template <typename... X>
+        void write(uint32_t site, const X&... x) {
+            if (!enabled.load(std::memory_order_relaxed)) return;
+            size_t size = (size_t{0} + ... + argument<std::decay_t<X>>::size(x));
+            char* p = reserve(static_cast<uint32_t>(size));
+            if (p == nullptr) return;
+            header h{site, static_cast<uint32_t>(size), 0};
+            h.Time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            std::memcpy(p, &h, sizeof(header));
+            p += sizeof(header);
+            ((p = argument<std::decay_t<X>>::write(p, x)), ...);
+            commit(p);
+        }
+
+        // wait until every record logged so far has been written.
+        void flush();
+
+        // read a binary log and write it as text in the format of init_logging.
+        // Returns false if the log is not a binary log or was cut short.
+        bool decode(std::istream& in, std::ostream& out);
+
+    }
+
+}
+
+// the format must be a string literal.
+#define DATA_LOG_BINARY_CHANNEL(channel,sev,format,...) if constexpr (data::log::severity_level::sev < DATA_LOG_FLOOR) {} else do { \
+    static const uint32_t data_log_site = data::log::binary::define((channel), data::log::severity_level::sev, "" format, \
+        decltype(data::log::binary::types(__VA_ARGS__))::value, __FILE__, __LINE__); \
+    data::log::binary::write(data_log_site, ##__VA_ARGS__); } while (false)
+#define DATA_LOG_BINARY(sev,format,...) DATA_LOG_BINARY_CHANNEL("data", sev, format, ##__VA_ARGS__)
+
+#endif
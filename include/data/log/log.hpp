@@ -43,9 +43,44 @@ namespace data::log {
     );
 }
     BOOST_LOG_ATTRIBUTE_KEYWORD(severity, "Severity", severity_level)
-#define DATA_LOG_CHANNEL(channel,sev) BOOST_LOG_CHANNEL_SEV((data::log::global_log::get()),(channel),(data::log::severity_level::sev))
-#define DATA_LOG(sev) BOOST_LOG_SEV((data::log::global_log::get()),(data::log::severity_level::sev))
+
+// log statements below this severity are removed at compile time.
+#ifndef DATA_LOG_FLOOR
+#define DATA_LOG_FLOOR 0
+#endif
+
+#define DATA_LOG_CHANNEL(channel,sev) if constexpr (data::log::severity_level::sev < DATA_LOG_FLOOR) {} else \
+    BOOST_LOG_CHANNEL_SEV((data::log::global_log::get()),(channel),(data::log::severity_level::sev))
+#define DATA_LOG(sev) if constexpr (data::log::severity_level::sev < DATA_LOG_FLOOR) {} else \
+    BOOST_LOG_SEV((data::log::global_log::get()),(data::log::severity_level::sev))
 void init_logging(std::string filename);
+
+    // what async logging does when every line is waiting to be written.
+    enum class overflow {
+        drop,
+        block
+    };
+
+    struct async_options {
+        // how many lines may wait to be written.
+        size_t Lines = 8192;
+        // longer lines are cut short.
+        size_t LineSize = 512;
+        overflow Overflow = overflow::drop;
+    };
+
+    // Log to a file from a background thread. A thread that logs formats
+    // its line into a buffer that was allocated beforehand and puts it on
+    // a lock-free queue, and the background thread writes lines in batches
+    // with writev. The file is not rotated.
+    void init_async_logging(std::string filename, async_options options = {});
+
+    // wait until every line logged so far has been written, including by binary logging.
+    void flush_logging();
+
+    // lines that async logging has dropped because the queue was full.
+    uint64_t dropped_log_lines();
+
 void testLog();
 
 }
@@ -6,6 +6,8 @@
 #define DATA_MATH_ARITHMETIC
 
 #include <data/iterable.hpp>
+#include <data/math/associative.hpp>
+#include <data/math/commutative.hpp>
 #include <type_traits>
 
 namespace data {
@@ -218,5 +220,19 @@ namespace data::math::arithmetic {
     
 };
 
+namespace data::math {
+    
+    // machine integers wrap around, so these hold without exception. 
+    template <> struct associative<data::plus<uint32>, uint32> {};
+    template <> struct commutative<data::plus<uint32>, uint32> {};
+    template <> struct associative<data::times<uint32>, uint32> {};
+    template <> struct commutative<data::times<uint32>, uint32> {};
+    template <> struct associative<data::plus<uint64>, uint64> {};
+    template <> struct commutative<data::plus<uint64>, uint64> {};
+    template <> struct associative<data::times<uint64>, uint64> {};
+    template <> struct commutative<data::times<uint64>, uint64> {};
+    
+}
+
 #endif
 
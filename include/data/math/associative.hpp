@@ -5,6 +5,7 @@
 #ifndef DATA_MATH_ASSOCIATIVE
 #define DATA_MATH_ASSOCIATIVE
 
+#include <type_traits>
 #include <data/function.hpp>
 
 namespace data::math {
@@ -13,5 +14,16 @@ namespace data::math {
     
 }
 
+namespace data::meta {
+    
+    // whether math::associative<f, x> has been declared to hold. 
+    template <typename f, typename x, typename = void> 
+    struct is_associative : std::false_type {};
+    
+    template <typename f, typename x> 
+    struct is_associative<f, x, std::void_t<decltype(sizeof(math::associative<f, x>))>> : std::true_type {};
+    
+}
+
 #endif 
 
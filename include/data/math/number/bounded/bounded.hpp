@@ -9,188 +9,292 @@
 #include <data/bytestring.hpp>
 #include <data/math/group.hpp>
 #include <data/math/sign.hpp>
-#include <data/encoding/halves.hpp>
 #include <data/math/number/gmp/gmp.hpp>
 #include <data/math/number/bytes/N.hpp>
-#include <data/encoding/words.hpp>
+#include <data/math/number/bytes/arithmetic.hpp>
 
 namespace data::math::number {
-    
+
+    // Numbers of a fixed size in bytes. Arithmetic is modular and is
+    // done in 64-bit limbs on the stack without allocating.
     template <bool is_signed, endian::order, size_t size> struct bounded;
-    
+
     template <endian::order r, size_t size>
     struct bounded<false, r, size> : bytestring<r, size> {
         using bit32 = uint32;
         using bit64 = uint64;
-        
+
         using array = bytestring<r, size>;
-        
+
         bounded() : array(0x00) {}
-        
+
         bounded(const uint64 x) : array(0x00) {
-            words().set(0, lesser_half(endian::arithmetic<r, false, 8>{x}));
-            words().set(1, greater_half(endian::arithmetic<r, false, 8>{x}));
+            words().set(0, x);
         }
-        
+
         bounded(const array& b) : array{b} {}
-        
+
         explicit bounded(slice<byte, size>);
         explicit bounded(string_view s);
-        
+
         operator slice<byte, size>() const {
             return slice<byte, size>{const_cast<byte*>(array::data())};
         }
-        
-        math::sign sign() const;
-        
+
+        math::sign sign() const {
+            return operator==(0) ? math::zero : math::positive;
+        }
+
+        bool operator==(const bounded& n) const {
+            return std::equal(array::begin(), array::end(), n.begin());
+        }
+
+        bool operator!=(const bounded& n) const {
+            return !operator==(n);
+        }
+
+        bool operator==(const uint64 x) const {
+            return operator==(bounded{x}) && (size >= 8 || x <= uint64(max()));
+        }
+
         bool operator==(const int64 x) const {
-            return x < 0 ? false : (*this == static_cast<data::uint64>(x));
+            return x < 0 ? false : operator==(static_cast<data::uint64>(x));
+        }
+
+        bool operator==(const int x) const {
+            return operator==(static_cast<int64>(x));
         }
-        
+
         // power
         bounded operator^(const bounded&) const;
-        bounded& operator^=(const bounded&);
-        
-        bool operator<(const bounded&) const;
-        bool operator<=(const bounded&) const;
-
-        bool operator>(const bounded& d) const;
-        bool operator>=(const bounded& d) const;
-        
+        bounded& operator^=(const bounded& n) {
+            return operator=(operator^(n));
+        }
+
+        bool operator<(const bounded& n) const {
+            return arithmetic::compare(Limbs, words(), n.words()) < 0;
+        }
+
+        bool operator<=(const bounded& n) const {
+            return arithmetic::compare(Limbs, words(), n.words()) <= 0;
+        }
+
+        bool operator>(const bounded& n) const {
+            return arithmetic::compare(Limbs, words(), n.words()) > 0;
+        }
+
+        bool operator>=(const bounded& n) const {
+            return arithmetic::compare(Limbs, words(), n.words()) >= 0;
+        }
+
+        bounded operator~() const;
+
+        bounded operator+(const bounded& n) const {
+            bounded x = *this;
+            return x += n;
+        }
+
+        bounded operator-(const bounded& n) const {
+            bounded x = *this;
+            return x -= n;
+        }
+
+        bounded operator*(const bounded& n) const;
+
         bounded& operator+=(const bounded&);
         bounded& operator-=(const bounded&);
-        bounded& operator*=(const bounded&);
-        
-        bounded& operator+=(const uint32&);
-        bounded& operator-=(const uint32&);
-        bounded& operator*=(const uint32&);
-        
+        bounded& operator*=(const bounded& n) {
+            return operator=(operator*(n));
+        }
+
+        bounded& operator+=(const uint32& n) {
+            return operator+=(bounded{n});
+        }
+
+        bounded& operator-=(const uint32& n) {
+            return operator-=(bounded{n});
+        }
+
+        bounded& operator*=(const uint32& n) {
+            return operator*=(bounded{n});
+        }
+
         static bounded max();
         static bounded min();
         static N_bytes<r> modulus();
-        
+
         bounded& operator++() {
-            operator+=(1);
-            return *this;
+            return operator+=(1);
         }
-        
+
         bounded& operator--() {
-            operator-=(1);
-            return *this;
+            return operator-=(1);
         }
-        
+
         bounded operator++(int) {
             bounded n = *this;
             ++(*this);
             return n;
         }
-        
+
         bounded operator--(int) {
             bounded n = *this;
-            ++(*this);
+            --(*this);
             return n;
         }
-        
-        bounded& operator<<=(int32);
-        bounded& operator>>=(int32);
-        
+
+        bounded operator<<(int32) const;
+        bounded operator>>(int32) const;
+
+        bounded& operator<<=(int32 x) {
+            return operator=(operator<<(x));
+        }
+
+        bounded& operator>>=(int32 x) {
+            return operator=(operator>>(x));
+        }
+
         math::division<bounded> divide(const bounded&) const;
-        
+
         bounded operator/(const bounded& n) const {
             return divide(n).Quotient;
         }
-        
+
         bounded operator%(const bounded& n) const {
             return divide(n).Remainder;
         }
-        
+
+        // The number as a sequence of 64-bit limbs.
+        arithmetic::limbs<r> words() const {
+            return arithmetic::limbs<r>{array::data(), size};
+        }
+
+        arithmetic::limbs<r, byte> words() {
+            return arithmetic::limbs<r, byte>{array::data(), size};
+        }
+
+        explicit operator uint64() const {
+            return words().get(0);
+        }
+
     private:
-        explicit bounded(const N_bytes<r>& n) : bounded{} {
-            if (n.size() <= size) {
-                if (r == endian::little) {
-                    std::copy(n.begin(), n.end(), array::begin());
-                } else {
-                    std::copy(n.begin(), n.end(), array::begin() + (size - n.size()));
-                }
-            }
-            if (n > N_bytes<r> {max()}) throw std::out_of_range{"N_bytes too big"};
-            if (r == endian::little) {
-                std::copy(n.begin(), n.begin() + size, array::begin());
-            } else {
-                std::copy(n.begin() + (n.size() - size), n.end(), array::begin());
-            }
+        constexpr static size_t Limbs = (size + 7) / 8;
+
+        arithmetic::fixed<Limbs> limbs() const {
+            return arithmetic::load<Limbs, r>(array::data(), size);
         }
-        
-        bounded(const bounded<true, r, size>&) {
-            throw method::unimplemented{"bounded<size, o, false>{bounded<size, o, true>}"};
+
+        bounded(const arithmetic::fixed<Limbs>& x) : array(0x00) {
+            arithmetic::store<Limbs, r>(array::data(), size, x);
         }
-        
+
+        explicit bounded(const N_bytes<r>& n);
+
+        // reinterpret the bits of a signed number.
+        bounded(const bounded<true, r, size>& z) : array{static_cast<const bytestring<r, size>&>(z)} {}
+
         friend struct abs<bounded<false, r, size>, bounded<true, r, size>>;
-        
-        data::arithmetic::words<uint32, r> words() {
-            throw method::unimplemented{"words"};
-        }
+        friend struct bounded<true, r, size>;
     };
-    
+
     template <endian::order r, size_t size>
     struct bounded<true, r, size> : data::bytestring<r, size> {
         using bit32 = int32;
         using bit64 = int64;
-        
+
         using array = data::bytestring<r, size>;
-        
+
         bounded() : array{0} {}
-        
+
         bounded(const int64 x) : array(x < 0 ? 0xff : 0x00) {
-            words().set(0, lesser_half(endian::arithmetic<r, true, 8>{x}));
-            words().set(1, greater_half(endian::arithmetic<r, true, 8>{x}));
+            words().set(0, x);
         }
-        
+
         bounded(const array& x) : array{x} {}
-        
-        bounded(const bounded<false, r, size>&) {
-            throw method::unimplemented{"signed bounded from unsigned bounded"};
-        }
-        
+
+        // throws if the number is too big.
+        explicit bounded(const bounded<false, r, size>&);
+
         explicit bounded(string_view s);
-        
+
         explicit bounded(slice<byte, size>);
-        
+
         operator slice<byte, size>() const {
-            return slice<byte>::data();
-        }
-        
-        bounded& operator=(const bounded& d) {
-            bytes::operator=(static_cast<const bytes&>(d));
-            return *this;
+            return slice<byte, size>{const_cast<byte*>(array::data())};
         }
-        
+
         bounded operator-() const;
-        
-        math::sign sign() const;
-        
+
+        math::sign sign() const {
+            return is_negative() ? math::negative : operator==(0) ? math::zero : math::positive;
+        }
+
+        bool operator==(const bounded& n) const {
+            return std::equal(array::begin(), array::end(), n.begin());
+        }
+
+        bool operator!=(const bounded& n) const {
+            return !operator==(n);
+        }
+
         bool operator==(const int64 x) const {
-            return *this == data::math::number::bounded<true, r, size>(x);
+            return operator==(bounded{x}) && (size >= 8 || (x <= int64(max()) && x >= int64(min())));
         }
-        
+
         // power
-        bounded operator^(const bounded<size, r, false>&) const;
-        bounded& operator^=(const bounded<size, r, false>&);
+        bounded operator^(const bounded<false, r, size>&) const;
+        bounded& operator^=(const bounded<false, r, size>& n) {
+            return operator=(operator^(n));
+        }
+
+        bool operator<(const bounded& d) const {
+            return compare(d) < 0;
+        }
+
+        bool operator<=(const bounded& d) const {
+            return compare(d) <= 0;
+        }
+
+        bool operator>(const bounded& d) const {
+            return compare(d) > 0;
+        }
+
+        bool operator>=(const bounded& d) const {
+            return compare(d) >= 0;
+        }
+
+        bounded operator~() const;
 
-        bool operator<(const bounded& d) const;
-        bool operator<=(const bounded& d) const;
+        bounded operator+(const bounded& n) const {
+            bounded x = *this;
+            return x += n;
+        }
+
+        bounded operator-(const bounded& n) const {
+            bounded x = *this;
+            return x -= n;
+        }
 
-        bool operator>(const bounded& d) const;
-        bool operator>=(const bounded& d) const;
+        bounded operator*(const bounded& n) const;
 
         bounded& operator+=(const bounded&);
         bounded& operator-=(const bounded&);
-        bounded& operator*=(const bounded&);
+        bounded& operator*=(const bounded& n) {
+            return operator=(operator*(n));
+        }
+
+        bounded& operator+=(const int32& n) {
+            return operator+=(bounded{n});
+        }
+
+        bounded& operator-=(const int32& n) {
+            return operator-=(bounded{n});
+        }
+
+        bounded& operator*=(const int32& n) {
+            return operator*=(bounded{n});
+        }
 
-        bounded& operator+=(const int32&);
-        bounded& operator-=(const int32&);
-        bounded& operator*=(const int32&);
-        
         static bounded max();
         static bounded min();
 
@@ -199,15 +303,13 @@ namespace data::math::number {
         }
 
         bounded& operator++() {
-            operator+=(1);
-            return *this;
+            return operator+=(1);
         }
 
         bounded& operator--() {
-            operator-=(1);
-            return *this;
+            return operator-=(1);
         }
-        
+
         bounded operator++(int) {
             bounded z = *this;
             ++(*this);
@@ -220,11 +322,22 @@ namespace data::math::number {
             return z;
         }
 
-        bounded& operator<<=(int32);
-        bounded& operator>>=(int32);
+        bounded operator<<(int32) const;
+
+        // arithmetic shift.
+        bounded operator>>(int32) const;
+
+        bounded& operator<<=(int32 x) {
+            return operator=(operator<<(x));
+        }
+
+        bounded& operator>>=(int32 x) {
+            return operator=(operator>>(x));
+        }
 
+        // the quotient is rounded down, as for Z.
         math::division<bounded> divide(const bounded&) const;
-        
+
         bounded operator/(const bounded& n) const {
             return divide(n).Quotient;
         }
@@ -232,37 +345,68 @@ namespace data::math::number {
         bounded operator%(const bounded& n) const {
             return divide(n).Remainder;
         }
-        
+
+        // The number as a sequence of 64-bit limbs.
+        arithmetic::limbs<r> words() const {
+            return arithmetic::limbs<r>{array::data(), size};
+        }
+
+        arithmetic::limbs<r, byte> words() {
+            return arithmetic::limbs<r, byte>{array::data(), size};
+        }
+
+        explicit operator int64() const {
+            return words().get(0, fill());
+        }
+
     private:
-        explicit bounded(const Z_bytes<r>& z) {
-            if (z > Z_bytes<r> {max()} || z < Z_bytes<r> {min()}) throw std::out_of_range{"Z_bytes too big"};
-            throw method::unimplemented{"bounded{Z_bytes}"};
+        constexpr static size_t Limbs = (size + 7) / 8;
+
+        bool is_negative() const {
+            return words().negative();
         }
-        
-        data::arithmetic::words<int32, r> words() {
-            throw method::unimplemented{"words"};
+
+        arithmetic::limb fill() const {
+            return is_negative() ? arithmetic::max_limb : 0;
+        }
+
+        // sign-extended to a whole number of limbs.
+        arithmetic::fixed<Limbs> limbs() const {
+            return arithmetic::load<Limbs, r>(array::data(), size, fill());
+        }
+
+        bounded(const arithmetic::fixed<Limbs>& x) : array(0x00) {
+            arithmetic::store<Limbs, r>(array::data(), size, x);
+        }
+
+        int compare(const bounded& d) const {
+            return arithmetic::compare(Limbs, words(), d.words(), fill(), d.fill());
         }
+
+        explicit bounded(const Z_bytes<r>& z);
+
+        friend struct bounded<false, r, size>;
     };
-    
+
 }
 
 // Declare the plus and times operations on these types
-// as satisfying the expected relations. 
+// as satisfying the expected relations.
 namespace data::math {
-    template <bool is_signed, endian::order r, size_t size> 
-    struct commutative<data::plus<math::number::bounded<is_signed, r, size>>, 
+    template <bool is_signed, endian::order r, size_t size>
+    struct commutative<data::plus<math::number::bounded<is_signed, r, size>>,
         math::number::bounded<is_signed, r, size>> {};
-    
-    template <bool is_signed, endian::order r, size_t size> 
-    struct associative<data::plus<math::number::bounded<is_signed, r, size>>, 
+
+    template <bool is_signed, endian::order r, size_t size>
+    struct associative<data::plus<math::number::bounded<is_signed, r, size>>,
         math::number::bounded<is_signed, r, size>> {};
-    
-    template <bool is_signed, endian::order r, size_t size> 
-    struct commutative<data::times<math::number::bounded<is_signed, r, size>>, 
+
+    template <bool is_signed, endian::order r, size_t size>
+    struct commutative<data::times<math::number::bounded<is_signed, r, size>>,
         math::number::bounded<is_signed, r, size>> {};
-    
-    template <bool is_signed, endian::order r, size_t size> 
-    struct associative<data::times<math::number::bounded<is_signed, r, size>>, 
+
+    template <bool is_signed, endian::order r, size_t size>
+    struct associative<data::times<math::number::bounded<is_signed, r, size>>,
         math::number::bounded<is_signed, r, size>> {};
 }
 
@@ -276,255 +420,241 @@ inline std::ostream& operator<<(std::ostream& s, const data::math::number::bound
     return s << data::math::number::N_bytes<r>{n};
 }
 
-namespace data::math::number {
-    /*
-    template <size_t size, endian::order o>
-    inline math::sign bounded<size, o, false>::sign() const {
-        return *this == 0 ? math::zero : math::positive;
-    }
-        
-    template <size_t size, endian::order o>
-    inline math::sign bounded<size, o, true>::sign() const {
-        if (*this == 0) return math::zero;
-        return bytes::operator[](o == endian::big ? 0 : size - 1) < 0x80 ? math::positive : math::negative;
-    }
-    
-    template <size_t size, endian::order o>
-    struct abs<bounded<size, o, false>, bounded<size, o, false>> {
-        bounded<size, o, false> operator()(const bounded<size, o, false>& i) {
-            return i;
-        }
-    };
-        
-    template <size_t size, endian::order o, bool is_signed>
-    struct sign<bounded<size, o, is_signed>> {
-        math::sign operator()(const bounded<size, o, is_signed>& i) {
-            return i.sign();
-        }
-    };
-
-    template <size_t size, endian::order o, bool is_signed>
-    struct arg<bounded<size, o, is_signed>> {
-        bounded<size, o, false> operator()(const bounded<size, o, is_signed>& i) {
-            if (i == 0) throw division_by_zero{};
-            return i.sign() == math::negative ? -1 : 1;
-        }
-    };
-    */
-}
-    
 namespace data::encoding::hexidecimal {
-    
+
     template <bool is_signed, endian::order r, size_t size>
     std::string write(const math::number::bounded<is_signed, r, size>& n);
 
 }
 
 namespace data::encoding::decimal {
-    
+
     template <bool is_signed, endian::order r, size_t size>
     std::string write(const math::number::bounded<is_signed, r, size>& n);
-    
+
 }
-    
+
 namespace data::math::number {
-/*
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator<<=(int32 bits) {
-        return operator=(array::operator<<(bits));
+
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size>::bounded(slice<byte, size> x) : array{x} {}
+
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size>::bounded(slice<byte, size> x) : array{x} {}
+
+    template <endian::order r, size_t size>
+    bounded<false, r, size>::bounded(const N_bytes<r>& n) : bounded{} {
+        N_bytes<r> t = n.trim();
+        if (t.size() > size) throw std::out_of_range{"N_bytes too big"};
+        size_t s = std::min(t.size(), size);
+        if (r == endian::little) std::copy(t.begin(), t.begin() + s, array::begin());
+        else std::copy(t.end() - s, t.end(), array::end() - s);
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator>>=(int32 bits) {
-        return operator=(array::operator>>(bits));
+    template <endian::order r, size_t size>
+    bounded<true, r, size>::bounded(const Z_bytes<r>& z) : array(z < 0 ? 0xff : 0x00) {
+        Z_bytes<r> t = z.trim();
+        if (t.size() > size) throw std::out_of_range{"Z_bytes too big"};
+        if (r == endian::little) std::copy(t.begin(), t.end(), array::begin());
+        else std::copy(t.begin(), t.end(), array::end() - t.size());
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator<<=(int32 bits) {
-        return operator=(array::operator<<(bits));
+    template <endian::order r, size_t size>
+    bounded<true, r, size>::bounded(const bounded<false, r, size>& n) : array{static_cast<const bytestring<r, size>&>(n)} {
+        if (is_negative()) throw std::out_of_range{"bounded too big"};
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator>>=(int32 bits) {
-        return operator=(array::operator>>(bits));
+    template <endian::order r, size_t size>
+    bounded<false, r, size>::bounded(string_view s) : bounded{} {
+        if (!encoding::natural::valid(s)) throw std::invalid_argument{"not a natural number"};
+        if (encoding::hexidecimal::valid(s) && s.size() > (2 + 2 * size)) throw std::invalid_argument{"string too long"};
+        *this = bounded{N_bytes<r>{s}};
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator+=(const bounded<size, o, false>& n) {
-        methods::plus(size, array::words(), n.words(), array::words());
-        return *this;
+    // hex strings are read as two's complement.
+    template <endian::order r, size_t size>
+    bounded<true, r, size>::bounded(string_view s) : bounded{} {
+        if (!encoding::integer::valid(s)) throw std::invalid_argument{"not an integer"};
+        if (encoding::hexidecimal::valid(s) && s.size() > (2 + 2 * size)) throw std::invalid_argument{"string too long"};
+        *this = bounded{Z_bytes<r>{s}};
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator+=(const bounded<size, o, true>& n) {
-        methods::plus(size, array::words(), n.words(), array::words());
-        return *this;
+    template <endian::order r, size_t size>
+    bounded<false, r, size> bounded<false, r, size>::min() {
+        return 0;
     }
-    
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator-=(const bounded<size, o, false>& n) {
-        methods::plus(size, array::words(), n.words(), array::words());
-        return *this;
+
+    template <endian::order r, size_t size>
+    bounded<false, r, size> bounded<false, r, size>::max() {
+        return bounded{array(0xff)};
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator-=(const bounded<size, o, true>& n) {
-        methods::plus(array::words_type::Last, array::words(), n.words(), array::words());
-        return *this;
+    template <endian::order r, size_t size>
+    N_bytes<r> bounded<false, r, size>::modulus() {
+        return N_bytes<r>{1} << (8 * size);
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator*=(const bounded<size, o, false>& n) {
-        return operator=(operator*(n));
+    template <endian::order r, size_t size>
+    bounded<true, r, size> bounded<true, r, size>::min() {
+        bounded b{};
+        b.words().digit(size - 1) = 0x80;
+        return b;
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator+=(const bit32& n) {
-        return methods::plus(size, array::words(), n, array::words());
+    template <endian::order r, size_t size>
+    bounded<true, r, size> bounded<true, r, size>::max() {
+        bounded b{array(0xff)};
+        b.words().digit(size - 1) = 0x7f;
+        return b;
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>
-    bounded<size, o, true>::operator-() const {
-        return array::operator~() + 1;
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size> bounded<false, r, size>::operator~() const {
+        bounded n;
+        std::transform(array::begin(), array::end(), n.begin(), [](byte b) -> byte { return ~b; });
+        return n;
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator+=(const bit32& n) {
-        return methods::plus(size, array::words(), n, array::words());
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size> bounded<true, r, size>::operator~() const {
+        bounded n;
+        std::transform(array::begin(), array::end(), n.begin(), [](byte b) -> byte { return ~b; });
+        return n;
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator-=(const bit32& n) {
-        methods::minus(size, array::words(), n, array::words());
-        return *this;
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size> bounded<true, r, size>::operator-() const {
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::negate(x);
+        return bounded{x};
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, true>&
-    bounded<size, o, true>::operator-=(const bit32& n) {
-        words_type out = array::words();
-        methods::minus(size, array::words(), n, out);
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size>& bounded<false, r, size>::operator+=(const bounded& n) {
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::plus(x, n.limbs());
+        arithmetic::store<Limbs, r>(array::data(), size, x);
         return *this;
     }
 
-    template <size_t size, endian::order o>
-    inline bounded<size, o, false>&
-    bounded<size, o, false>::operator*=(const bit32& n) {
-        methods::times(size, array::words(), n, array::words());
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size>& bounded<true, r, size>::operator+=(const bounded& n) {
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::plus(x, n.limbs());
+        arithmetic::store<Limbs, r>(array::data(), size, x);
         return *this;
     }
 
-    template <size_t size, endian::order o>
-    inline math::division<bounded<size, o, false>>
-    bounded<size, o, false>::divide(const bounded& n) const {
-        return math::number::natural::divide(*this, n);
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size>& bounded<false, r, size>::operator-=(const bounded& n) {
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::minus(x, n.limbs());
+        arithmetic::store<Limbs, r>(array::data(), size, x);
+        return *this;
     }
 
-    template <size_t size, endian::order o>
-    inline math::division<bounded<size, o, true>>
-    bounded<size, o, true>::divide(const bounded& n) const {
-        return math::number::integer::divide(*this, n);
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size>& bounded<true, r, size>::operator-=(const bounded& n) {
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::minus(x, n.limbs());
+        arithmetic::store<Limbs, r>(array::data(), size, x);
+        return *this;
     }
 
-    template <size_t size, endian::order o>
-    bool bounded<size, o, false>::operator<(const bounded& n) const {
-        return methods::less(words_type::Last, array::words(), n.words());
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size> bounded<false, r, size>::operator*(const bounded& n) const {
+        return bounded{arithmetic::times(limbs(), n.limbs())};
     }
 
-    template <size_t size, endian::order o>
-    bool bounded<size, o, false>::operator<=(const bounded& n) const {
-        return methods::less_equal(words_type::Last, array::words(), n.words());
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size> bounded<true, r, size>::operator*(const bounded& n) const {
+        return bounded{arithmetic::times(limbs(), n.limbs())};
     }
 
-    template <size_t size, endian::order o>
-    bool bounded<size, o, true>::operator<(const bounded& n) const {
-        return methods::less(words_type::Last, array::words(), n.words());
+    template <endian::order r, size_t size>
+    inline bounded<false, r, size> bounded<false, r, size>::operator^(const bounded& n) const {
+        return bounded{arithmetic::power(limbs(), n.limbs())};
     }
 
-    template <size_t size, endian::order o>
-    bool bounded<size, o, true>::operator<=(const bounded& n) const {
-        return methods::less_equal(words_type::Last, array::words(), n.words());
+    template <endian::order r, size_t size>
+    inline bounded<true, r, size> bounded<true, r, size>::operator^(const bounded<false, r, size>& n) const {
+        return bounded{arithmetic::power(limbs(), n.limbs())};
     }
-*/
-    template <endian::order o, size_t size>
-    bounded<false, o, size>::bounded(string_view s) : bounded{} {
-        if (!encoding::natural::valid(s)) throw std::invalid_argument{"not a natural number"};
 
-        if (encoding::hexidecimal::valid(s) && s.size() > (2 + 2 * size)) throw std::invalid_argument{"string too long"};
-        *this = bounded{N_bytes<o>{s}};
-    }
-/*
-    template <size_t size, endian::order o>
-    bounded<size, o, true>::bounded(string_view s) : bounded{} {
-        if (!encoding::integer::valid(s)) throw std::invalid_argument{"not an integer"};
-            
-        // Is there a minus sign?
-        bool minus_sign = encoding::integer::negative(s);
-        bool hexidecimal = encoding::hexidecimal::valid(s);
-        
-        if (hexidecimal) {
-            if (s.size() > (2 + 2 * size)) throw std::invalid_argument{"string too long"};
-            byte fill = minus_sign ? 0xff : 0x00;
-            for (int i = 0; i < size; i++) this->operator[](i) = fill;
-            bytes b{encoding::hexidecimal::read(s, o)};
-        } else {
-            *this = bounded{Z_bytes<o>{s}};
-        }
-        
+    template <endian::order r, size_t size>
+    bounded<false, r, size> bounded<false, r, size>::operator<<(int32 bits) const {
+        if (bits < 0) return operator>>(-bits);
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::shift_left(Limbs, arithmetic::view(x), arithmetic::view(x), bits);
+        return bounded{x};
     }
-*/
-    template <endian::order o, size_t size>
-    bounded<false, o, size> bounded<false, o, size>::min() {
-        return 0;
+
+    template <endian::order r, size_t size>
+    bounded<false, r, size> bounded<false, r, size>::operator>>(int32 bits) const {
+        if (bits < 0) return operator<<(-bits);
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::shift_right(Limbs, arithmetic::view(x), arithmetic::view(x), bits);
+        return bounded{x};
     }
 
-    template <endian::order o, size_t size>
-    bounded<false, o, size> bounded<false, o, size>::max() {
-        bounded b{};
-        for (int i = 0; i <= size; i++) b[i] = 0xff;
-        return b;
+    template <endian::order r, size_t size>
+    bounded<true, r, size> bounded<true, r, size>::operator<<(int32 bits) const {
+        if (bits < 0) return operator>>(-bits);
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::shift_left(Limbs, arithmetic::view(x), arithmetic::view(x), bits);
+        return bounded{x};
     }
-/*
-    template <size_t size, endian::order o>
-    N_bytes<o> bounded<size, o, false>::modulus() {
-        std::string one = std::string{"0x01"} + encoding::hexidecimal::write(bounded{0}).substr(2);
-        return N_bytes<o> {one};
+
+    template <endian::order r, size_t size>
+    bounded<true, r, size> bounded<true, r, size>::operator>>(int32 bits) const {
+        if (bits < 0) return operator<<(-bits);
+        arithmetic::fixed<Limbs> x = limbs();
+        arithmetic::shift_right(Limbs, arithmetic::view(x), arithmetic::view(x), bits, fill());
+        return bounded{x};
     }
 
-    template <size_t size, endian::order o>
-    bounded<size, o, true> bounded<size, o, true>::min() {
-        bounded b{};
-        words_type w = b.words();
-        w.set(words_type::Last, 0x80000000);
-        return b;
+    template <endian::order r, size_t size>
+    math::division<bounded<false, r, size>> bounded<false, r, size>::divide(const bounded& n) const {
+        arithmetic::fixed<Limbs> v = n.limbs();
+        if (arithmetic::is_zero(v)) throw division_by_zero{};
+        arithmetic::fixed<Limbs> q;
+        arithmetic::fixed<Limbs> m;
+        arithmetic::divide(q, m, limbs(), v);
+        return {bounded{q}, bounded{m}};
     }
 
-    template <size_t size, endian::order o>
-    bounded<size, o, true> bounded<size, o, true>::max() {
-        bounded b{};
-        words_type w = b.words();
-        w.set(words_type::Last, 0x7fffffff);
-        for (int i = 0; i < words_type::Last; i++) w.set(i, 0xffffffff);
-        return b;
+    template <endian::order r, size_t size>
+    math::division<bounded<true, r, size>> bounded<true, r, size>::divide(const bounded& n) const {
+        bool negative_dividend = is_negative();
+        bool negative_divisor = n.is_negative();
+        arithmetic::fixed<Limbs> u = limbs();
+        arithmetic::fixed<Limbs> v = n.limbs();
+        if (arithmetic::is_zero(v)) throw division_by_zero{};
+        if (negative_dividend) arithmetic::negate(u);
+        if (negative_divisor) arithmetic::negate(v);
+
+        arithmetic::fixed<Limbs> q;
+        arithmetic::fixed<Limbs> m;
+        arithmetic::divide(q, m, u, v);
+
+        // round the quotient down.
+        if (negative_dividend != negative_divisor) {
+            if (!arithmetic::is_zero(m)) {
+                arithmetic::plus(q, arithmetic::fixed<Limbs>{1});
+                arithmetic::minus(v, m);
+                m = v;
+            }
+            arithmetic::negate(q);
+        }
+
+        if (negative_divisor) arithmetic::negate(m);
+        return {bounded{q}, bounded{m}};
     }
-*/
+
 }
 
 namespace data {
-    
+
     template <size_t size> using uint = math::number::bounded<false, endian::order::big, size>;
     template <size_t size> using integer = math::number::bounded<true, endian::order::big, size>;
 
@@ -11,6 +11,7 @@
 
 #include <data/math/number/natural.hpp>
 #include <data/math/number/bytes/Z.hpp>
+#include <data/math/number/bytes/arithmetic.hpp>
 #include <data/bytestring.hpp>
 
 namespace data::math::number {
@@ -33,8 +34,7 @@ namespace data::math::number {
         
         explicit N_bytes(string_view s) : N_bytes{read(s)} {}
         
-        // A bit inefficient. 
-        explicit N_bytes(const N& n) : N_bytes(data::encoding::hexidecimal::write(n)) {}
+        explicit N_bytes(const N& n);
         
         explicit N_bytes(bytes_view b) : bytestring<r>{b} {}
         
@@ -44,8 +44,16 @@ namespace data::math::number {
             return operator==(0) ? math::zero : math::positive;
         }
         
+        bool operator==(uint64 n) const {
+            return compare(n) == 0;
+        }
+        
         bool operator==(const N_bytes& n) const {
-            return N{*this} == N{n}; // Inefficient
+            return compare(n) == 0;
+        }
+        
+        bool operator!=(uint64 n) const {
+            return !operator==(n);
         }
         
         bool operator!=(const N_bytes& n) const {
@@ -56,6 +64,8 @@ namespace data::math::number {
         
         N_bytes(size_t size, byte fill) : bytestring<r>(size, fill) {}
         
+        N_bytes(const bytestring<r>& b) : bytestring<r>{b} {}
+        
     public:
         
         using bytestring<r>::size;
@@ -70,22 +80,33 @@ namespace data::math::number {
             return N_bytes(size, 0x00);
         }
         
+        // The number as a sequence of 64-bit limbs. 
+        arithmetic::limbs<r> words() const {
+            return arithmetic::limbs<r>{bytestring<r>::data(), size()};
+        }
+        
+        arithmetic::limbs<r, byte> words() {
+            return arithmetic::limbs<r, byte>{bytestring<r>::data(), size()};
+        }
+        
         bool operator<(uint64 n) const {
-            return operator<(N_bytes<r>{n});
+            return compare(n) < 0;
         }
         
-        bool operator<(const N_bytes& n) const;
+        bool operator<(const N_bytes& n) const {
+            return compare(n) < 0;
+        }
         
         bool operator<(const Z_bytes<r>& z) const {
-            return z.is_negative() ? false : operator<(N_bytes{z.Value});
+            return z.is_negative() ? false : compare(z.words()) < 0;
         }
         
         bool operator<(const N& n) const {
-            return N{*this} < n;
+            return compare(n.Value) < 0;
         }
         
         bool operator<(const Z& n) const {
-            return N{*this} < n;
+            return compare(n) < 0;
         }
         
         bool operator>(uint64 n) const {
@@ -109,82 +130,100 @@ namespace data::math::number {
         }
         
         bool operator<=(uint64 n) const {
-            return operator<=(N_bytes{n});
+            return compare(n) <= 0;
         }
         
-        bool operator<=(const N_bytes& n) const;
+        bool operator<=(const N_bytes& n) const {
+            return compare(n) <= 0;
+        }
         
         bool operator<=(const Z_bytes<r>& z) const {
-            return z.is_negative() ? false : operator<=(N_bytes{z});
+            return z.is_negative() ? false : compare(z.words()) <= 0;
         }
         
         bool operator<=(const N& n) const {
-            return N{*this} <= n;
+            return compare(n.Value) <= 0;
         }
         
         bool operator<=(const Z& n) const {
-            return N{*this} <= n;
+            return compare(n) <= 0;
         }
         
         bool operator>=(uint64 n) const {
-            return operator>=(N_bytes{n});
+            return !operator<(n);
         }
         
-        bool operator>=(const N_bytes& n) const;
+        bool operator>=(const N_bytes& n) const {
+            return !operator<(n);
+        }
         
-        bool operator>=(const Z_bytes<r>& z) const;
+        bool operator>=(const Z_bytes<r>& z) const {
+            return !operator<(z);
+        }
         
         bool operator>=(const N& n) const {
-            return N{*this} >= n;
+            return !operator<(n);
         }
         
         bool operator>=(const Z& n) const {
-            return N{*this} >= n;
+            return !operator<(n);
         }
         
         N_bytes operator~() const;
         
         N_bytes& operator++() {
-            operator+=(1);
-            return *this;
+            return operator+=(1);
         }
         
         N_bytes& operator--() {
-            operator+=(1);
-            return *this;
+            return operator-=(1);
         }
         
-        N_bytes operator++(int) const {
+        N_bytes operator++(int) {
             N_bytes z = *this;
             ++(*this);
             return z;
         }
         
-        N_bytes operator--(int) const {
+        N_bytes operator--(int) {
             N_bytes z = *this;
-            ++(*this);
+            --(*this);
             return z;
         }
         
-        N_bytes operator+(const N_bytes& n) const {
-            // TODO very inefficient. 
-            return N_bytes{N{*this} + N{n}};
+        N_bytes operator+(uint64) const;
+        
+        N_bytes operator+(const N_bytes&) const;
+        
+        N_bytes& operator+=(uint64 n) {
+            return operator=(operator+(n));
         }
         
         N_bytes& operator+=(const N_bytes& n) {
             return operator=(operator+(n));
         }
         
-        N_bytes operator-(const N_bytes& n) const {
-            throw method::unimplemented{"N_bytes::-"};
+        // like N, subtraction stops at zero. 
+        N_bytes operator-(uint64) const;
+        
+        N_bytes operator-(const N_bytes&) const;
+        
+        N_bytes& operator-=(uint64 n) {
+            return operator=(operator-(n));
         }
         
         N_bytes& operator-=(const N_bytes& n) {
             return operator=(operator-(n));
         }
         
+        N_bytes operator*(uint64) const;
+        
         N_bytes operator*(const N_bytes&) const;
         
+        N_bytes& operator*=(uint64 n) {
+            return operator=(operator*(n));
+        }
+        
         N_bytes& operator*=(const N_bytes& n) {
             return operator=(operator*(n));
         }
@@ -195,9 +234,7 @@ namespace data::math::number {
             return operator=(operator^(n));
         }
         
-        math::division<N_bytes> divide(const N_bytes& n) const {
-            return natural::divide<N_bytes>(*this, n);
-        }
+        math::division<N_bytes> divide(const N_bytes&) const;
         
         bool operator|(const N_bytes& n) const {
             return divide(n).Remainder == 0;
@@ -219,9 +256,13 @@ namespace data::math::number {
             return operator=(operator%(n));
         }
         
-        N_bytes operator/(const N&) const;
+        N_bytes operator/(const N& n) const {
+            return operator/(N_bytes{n});
+        }
         
-        N_bytes operator%(const N&) const;
+        N_bytes operator%(const N& n) const {
+            return operator%(N_bytes{n});
+        }
         
         N_bytes& operator/=(const N& n) {
             return operator=(operator/(n));
@@ -231,13 +272,9 @@ namespace data::math::number {
             return operator=(operator%(n));
         }
         
-        N_bytes operator<<(int64 x) const {
-            throw method::unimplemented{"N_bytes::<<"};
-        }
+        N_bytes operator<<(int64) const;
         
-        N_bytes operator>>(int64 x) const {
-            throw method::unimplemented{"N_bytes::>>"};
-        }
+        N_bytes operator>>(int64) const;
         
         N_bytes& operator<<=(int64 x) {
             return operator=(operator<<(x));
@@ -249,62 +286,195 @@ namespace data::math::number {
         
         bytes write(endian::order) const; 
         
+        // remove leading zeros without copying. 
         N_bytes trim() const;
         
         template <size_t size, endian::order o> 
-        explicit N_bytes(const bounded<size, o, false>& b) : N_bytes{bytes_view(b), o} {}
+        explicit N_bytes(const bounded<false, o, size>& b) : N_bytes{bytes_view(b), o} {}
 
     private:
-        N_bytes(bytes_view b, endian::order o) : bytestring<r>{b.size()} {
-            std::copy(b.begin(), b.end(), begin());
+        N_bytes(bytes_view b, endian::order o) : bytestring<r>{b} {
             if (o != r) std::reverse(begin(), end());
         }
         
-        N_bytes(const Z_bytes<r>& z) {
-            throw method::unimplemented{"N_bytes{Z_bytes}"};
+        N_bytes(const Z_bytes<r>& z) : N_bytes{z.is_negative() ? 
+            N_bytes{} : N_bytes{static_cast<const bytestring<r>&>(z)}.trim()} {}
+        
+        int compare(const N_bytes& n) const {
+            return arithmetic::compare(std::max(words().count(), n.words().count()), words(), n.words());
+        }
+        
+        int compare(uint64 n) const {
+            return arithmetic::compare(std::max(words().count(), size_t(1)), words(), arithmetic::native_limbs<>{&n, 1});
+        }
+        
+        int compare(arithmetic::limbs<r> n) const {
+            return arithmetic::compare(std::max(words().count(), n.count()), words(), n);
+        }
+        
+        int compare(const Z& n) const {
+            if (n < 0) return 1;
+            size_t limbs = mpz_size(n.MPZ);
+            return arithmetic::compare(std::max(words().count(), limbs), words(), 
+                arithmetic::native_limbs<>{reinterpret_cast<const arithmetic::limb*>(mpz_limbs_read(n.MPZ)), limbs});
         }
         
         friend struct abs<N_bytes, Z_bytes<r>>;
+        friend struct Z_bytes<r>;
     };
     
-    // Inefficient
-    template <endian::order r>
-    Z_bytes<r>::Z_bytes(const N_bytes<r>& n) : Z_bytes{N{n}} {}
+    static_assert(sizeof(gmp::gmp_uint) == sizeof(arithmetic::limb), "gmp limbs must be 64 bits");
     
-    namespace low {
-        template <typename B, typename E, typename O>
-        void trim(uint32 size, B b, E e, O o) {
-            while(*b == 0) {
-                size--;
-                b++;
-            }
-            std::copy(b, e, o);
-        }
+    template <endian::order r>
+    N_bytes<r>::N_bytes(const N& n) : N_bytes{} {
+        if (!n.valid()) return;
+        size_t limbs = mpz_size(n.Value.MPZ);
+        *this = zero(limbs == 0 ? 1 : (mpz_sizeinbase(n.Value.MPZ, 2) + 7) / 8);
+        arithmetic::copy(words().count(), words(), 
+            arithmetic::native_limbs<>{reinterpret_cast<const arithmetic::limb*>(mpz_limbs_read(n.Value.MPZ)), limbs});
     }
     
     template <endian::order r> 
     N_bytes<r> N_bytes<r>::trim() const {
-        uint32 s = size();
-        if (s == 0) return N_bytes{bytes{}};
-        N_bytes re{};
-        if (r == endian::big) {
-            auto b = begin();
-            while (*b == 0) {
-                s--;
-                b++;
-            }
-            re.Value = bytes(s);
-            std::copy(b, end(), re.begin());
-        } else {
-            auto b = rbegin();
-            while (*b == 0) {
-                s--;
-                b++;
-            }
-            re.Value = bytes(size);
-            std::copy(b, rend(), re.rend());
-        }
-        return re;
+        if (!valid()) return *this;
+        size_t s = std::max(words().significant(), std::min(size(), size_t(1)));
+        if (s == size()) return *this;
+        int offset = bytestring<r>::data() - bytestring<r>::Data->data();
+        if (r == endian::big) return N_bytes{bytestring<r>{bytestring<r>::Data, offset + int(size() - s), offset + int(size())}};
+        return N_bytes{bytestring<r>{bytestring<r>::Data, offset, offset + int(s)}};
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator~() const {
+        N_bytes n = zero(size());
+        arithmetic::bit_negate(words().count(), n.words(), words());
+        return n;
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator+(uint64 x) const {
+        N_bytes n = zero(std::max(words().significant(), size_t(8)) + 1);
+        arithmetic::plus(n.words().count(), n.words(), words(), arithmetic::native_limbs<>{&x, 1});
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator+(const N_bytes& x) const {
+        N_bytes n = zero(std::max(words().significant(), x.words().significant()) + 1);
+        arithmetic::plus(n.words().count(), n.words(), words(), x.words());
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator-(uint64 x) const {
+        if (compare(x) <= 0) return zero(1);
+        N_bytes n = zero(words().significant());
+        arithmetic::minus(n.words().count(), n.words(), words(), arithmetic::native_limbs<>{&x, 1});
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator-(const N_bytes& x) const {
+        if (compare(x) <= 0) return zero(1);
+        N_bytes n = zero(words().significant());
+        arithmetic::minus(n.words().count(), n.words(), words(), x.words());
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator*(uint64 x) const {
+        N_bytes n = zero(words().significant() + 8);
+        arithmetic::times(n.words().count(), n.words(), words(), x);
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator*(const N_bytes& x) const {
+        size_t a = words().significant();
+        size_t b = x.words().significant();
+        N_bytes n = zero(std::max(a + b, size_t(1)));
+        arithmetic::times(n.words().count(), n.words(), (a + 7) / 8, words(), (b + 7) / 8, x.words());
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator^(uint32 n) const {
+        N_bytes pow = 1;
+        N_bytes x = *this;
+        while (n != 0) {
+            if (n & 1) pow *= x;
+            n >>= 1;
+            if (n != 0) x *= x;
+        }
+        return pow;
+    }
+    
+    template <endian::order r> 
+    math::division<N_bytes<r>> N_bytes<r>::divide(const N_bytes& x) const {
+        size_t n = (x.words().significant() + 7) / 8;
+        if (n == 0) throw division_by_zero{};
+        size_t m = (words().significant() + 7) / 8;
+        if (compare(x) < 0) return {zero(1), trim()};
+        
+        // one buffer for the inputs, the quotient, the remainder, and scratch space. 
+        std::vector<arithmetic::limb> buffer(m + n + (m - n + 1) + n + (m + n + 1));
+        arithmetic::limb *u = buffer.data();
+        arithmetic::limb *v = u + m;
+        arithmetic::limb *q = v + n;
+        arithmetic::limb *rem = q + (m - n + 1);
+        for (size_t i = 0; i < m; i++) u[i] = words().get(i);
+        for (size_t i = 0; i < n; i++) v[i] = x.words().get(i);
+        arithmetic::divide(q, rem, u, m, v, n, rem + n);
+        
+        N_bytes quotient = zero(8 * (m - n + 1));
+        N_bytes remainder = zero(8 * n);
+        arithmetic::copy(m - n + 1, quotient.words(), arithmetic::native_limbs<>{q, m - n + 1});
+        arithmetic::copy(n, remainder.words(), arithmetic::native_limbs<>{rem, n});
+        return {quotient.trim(), remainder.trim()};
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator<<(int64 x) const {
+        if (x < 0) return operator>>(-x);
+        N_bytes n = zero(std::max(words().significant(), size_t(1)) + (x + 7) / 8);
+        arithmetic::shift_left(n.words().count(), n.words(), words(), x);
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    N_bytes<r> N_bytes<r>::operator>>(int64 x) const {
+        if (x < 0) return operator<<(-x);
+        size_t s = words().significant();
+        if (static_cast<size_t>(x / 8) >= s) return zero(1);
+        N_bytes n = zero(s - x / 8);
+        arithmetic::shift_right(n.words().count(), n.words(), words(), x);
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    bytes N_bytes<r>::write(endian::order o) const {
+        bytes b(bytes_view(*this));
+        if (o != r) std::reverse(b.begin(), b.end());
+        return b;
+    }
+    
+    template <endian::order r>
+    Z_bytes<r>::Z_bytes(const N_bytes<r>& n) : Z_bytes{zero(n.words().significant() + 1)} {
+        arithmetic::copy(words().count(), words(), n.words());
+        *this = trim();
+    }
+    
+    template <endian::order r>
+    division<Z_bytes<r>> Z_bytes<r>::divide(const Z_bytes& z) const {
+        if (z.is_zero()) throw division_by_zero{};
+        bool negative_dividend = is_negative();
+        bool negative_divisor = z.is_negative();
+        division<N_bytes<r>> d = N_bytes<r>{abs()}.divide(N_bytes<r>{z.abs()});
+        Z_bytes quotient{d.Quotient};
+        Z_bytes remainder{d.Remainder};
+        if (negative_dividend == negative_divisor) return {quotient, negative_divisor ? -remainder : remainder};
+        if (remainder.is_zero()) return {-quotient, remainder};
+        return {-(quotient + 1), negative_divisor ? remainder + z : z - remainder};
     }
 }
 
@@ -11,6 +11,7 @@
 #include <data/math/division.hpp>
 #include <data/bytestring.hpp>
 #include <data/math/number/abs.hpp>
+#include <data/math/number/bytes/arithmetic.hpp>
 #include <algorithm>
 
 namespace data::math::number {
@@ -31,12 +32,7 @@ namespace data::math::number {
         
         Z_bytes(const bytestring<r>& x) : bytestring<r>(x) {}
         
-        // First we write the Z as hex and then read it in again. 
-        // A bit inefficient but it's really not that bad. 
-        explicit Z_bytes(const Z& z) : Z_bytes() {
-            if (!z.valid()) throw std::invalid_argument{"invalid Z provided"};
-            *this = Z_bytes(data::encoding::hexidecimal::write(z));
-        }
+        explicit Z_bytes(const Z& z);
         
         explicit Z_bytes(const N& n) : Z_bytes(Z(n)) {}
         
@@ -63,16 +59,38 @@ namespace data::math::number {
         using bytestring<r>::operator[];
         using bytestring<r>::valid;
         
+        // The number as a sequence of 64-bit limbs in two's complement. 
+        arithmetic::limbs<r> words() const {
+            return arithmetic::limbs<r>{bytestring<r>::data(), size()};
+        }
+        
+        arithmetic::limbs<r, byte> words() {
+            return arithmetic::limbs<r, byte>{bytestring<r>::data(), size()};
+        }
+        
     private:
         
         bool is_negative() const {
-            if (size() == 0) return false;
-            return operator[](r == endian::big ? 0 : size() - 1) >= 0x80;
+            return words().negative();
         }
         
         bool is_zero() const {
-            for (int i = 0; i < size(); i++) if (operator[](i) != 0) return false;
-            return true;
+            return words().significant() == 0;
+        }
+        
+        // the value of limbs past the end of the number.
+        arithmetic::limb fill() const {
+            return is_negative() ? arithmetic::max_limb : 0;
+        }
+        
+        // enough bytes to hold the number with its sign bit. 
+        size_t signed_size() const {
+            return words().significant(is_negative() ? 0xff : 0x00) + 1;
+        }
+        
+        int compare(const Z_bytes& z) const {
+            return arithmetic::compare(std::max(words().count(), z.words().count()), 
+                words(), z.words(), fill(), z.fill());
         }
         
         Z_bytes(size_t size, byte fill) : bytestring<r>(size, fill) {}
@@ -89,37 +107,31 @@ namespace data::math::number {
             return math::positive;
         }
         
-        bool operator==(const Z_bytes& z) const;
+        bool operator==(const Z_bytes& z) const {
+            return compare(z) == 0;
+        }
         
         bool operator!=(const Z_bytes& z) const {
             return !operator==(z);
         }
         
-        bool operator<(const Z_bytes& z) const; /*{
-            bool na = is_negative();
-            bool nz = z.is_negative();
-            return na != nz ? na : methods::less(std::max(size(), z.size()), words(), z.words());
-        }*/
+        bool operator<(const Z_bytes& z) const {
+            return compare(z) < 0;
+        }
         
         bool operator>(const Z_bytes& n) const {
             return !operator<=(n);
         }
         
-        bool operator<=(const Z_bytes& z) const;/* {
-            bool na = is_negative();
-            bool nz = z.is_negative();
-            return na != nz ? na : methods::less_equal(std::max(size(), z.size()), words(), z.words());
-        }*/
+        bool operator<=(const Z_bytes& z) const {
+            return compare(z) <= 0;
+        }
         
         bool operator>=(const Z_bytes& n) const {
             return !operator<(n);
         }
         
-        Z_bytes operator~() const; /*{
-            Z_bytes z(size(), 0);
-            arithmetic::bit_negate(arithmetic::number(z), arithmetic::number(*this));
-            return z;
-        }*/
+        Z_bytes operator~() const;
         
         Z_bytes& operator++() {
             operator+=(1);
@@ -131,13 +143,13 @@ namespace data::math::number {
             return *this;
         }
         
-        Z_bytes operator++(int) const {
+        Z_bytes operator++(int) {
             Z_bytes z = *this;
             ++(*this);
             return z;
         }
         
-        Z_bytes operator--(int) const {
+        Z_bytes operator--(int) {
             Z_bytes z = *this;
             --(*this);
             return z;
@@ -152,7 +164,7 @@ namespace data::math::number {
         Z_bytes operator-(const Z_bytes& z) const;
         
         Z_bytes operator-() const {
-            return ++(~Z_bytes{0});
+            return Z_bytes{0} - *this;
         }
         
         Z_bytes& operator-=(const Z_bytes& n) {
@@ -171,9 +183,8 @@ namespace data::math::number {
             return operator=(operator^(n));
         }
         
-        division<Z_bytes> divide(const Z_bytes& z) const {
-            return integer::divide<Z_bytes>(*this, z);
-        }
+        // rounds down, like gmp::Z. 
+        division<Z_bytes> divide(const Z_bytes& z) const;
         
         bool operator|(const Z_bytes& z) const {
             return divide(z).Remainder == 0;
@@ -196,13 +207,9 @@ namespace data::math::number {
             return operator=(operator%(z));
         }
         
-        Z_bytes operator<<(int64 x) const {
-            throw method::unimplemented{"Z_bytes::<<"};
-        }
+        Z_bytes operator<<(int64) const;
         
-        Z_bytes operator>>(int64 x) const {
-            throw method::unimplemented{"Z_bytes::>>"};
-        }
+        Z_bytes operator>>(int64) const;
         
         Z_bytes& operator<<=(int64 x) {
             return operator=(operator<<(x));
@@ -213,51 +220,107 @@ namespace data::math::number {
         }
         
         Z_bytes<r> abs() const {
-            throw method::unimplemented{"Z_bytes::abs"};
+            return is_negative() ? -*this : *this;
         }
         
+        // remove redundant sign bytes without copying. 
         Z_bytes trim() const;
         
         template <size_t size, endian::order o> 
-        explicit Z_bytes(const bounded<size, o, true>& b) : Z_bytes{bytes_view(b), o} {}
+        explicit Z_bytes(const bounded<true, o, size>& b) : Z_bytes{bytes_view(b), o} {}
         
         template <size_t size, endian::order o> 
-        explicit Z_bytes(const bounded<size, o, false>& b) : Z_bytes{bytes_view(b), o} {}
+        explicit Z_bytes(const bounded<false, o, size>& b) : Z_bytes{N_bytes<r>{b}} {}
+        
+    private:
+        Z_bytes(bytes_view b, endian::order o) : bytestring<r>{b} {
+            if (o != r) std::reverse(begin(), end());
+        }
     };
-    /*
+    
+    template <endian::order r> 
+    Z_bytes<r> Z_bytes<r>::trim() const {
+        if (!valid() || size() == 0) return *this;
+        size_t s = signed_size();
+        // the extra byte is only needed if the byte below it has the wrong sign bit. 
+        if (s > 1 && (words().digit(s - 2) >= 0x80) == is_negative()) s--;
+        if (s >= size()) return *this;
+        int offset = bytestring<r>::data() - bytestring<r>::Data->data();
+        if (r == endian::big) return Z_bytes{bytestring<r>{bytestring<r>::Data, offset + int(size() - s), offset + int(size())}};
+        return Z_bytes{bytestring<r>{bytestring<r>::Data, offset, offset + int(s)}};
+    }
+    
+    template <endian::order r>
+    Z_bytes<r>::Z_bytes(const Z& z) : Z_bytes() {
+        if (!z.valid()) throw std::invalid_argument{"invalid Z provided"};
+        size_t limbs = mpz_size(z.MPZ);
+        *this = zero(limbs == 0 ? 1 : mpz_sizeinbase(z.MPZ, 2) / 8 + 1);
+        arithmetic::copy(words().count(), words(), 
+            arithmetic::native_limbs<>{reinterpret_cast<const arithmetic::limb*>(mpz_limbs_read(z.MPZ)), limbs});
+        if (z < 0) {
+            arithmetic::bit_negate(words().count(), words(), words());
+            arithmetic::plus(words().count(), words(), words(), arithmetic::limb{1});
+        }
+        *this = trim();
+    }
+    
+    template <endian::order r> 
+    Z_bytes<r> Z_bytes<r>::operator~() const {
+        Z_bytes z = zero(size());
+        arithmetic::bit_negate(words().count(), z.words(), words());
+        return z;
+    }
+    
     template <endian::order r> 
     Z_bytes<r> Z_bytes<r>::operator+(const Z_bytes& z) const {
-        uint32 s = std::max(size(), z.size()) + 1;
-        Z_bytes re{bytes{s}};
-        methods::plus(s, words(), z.words(), re.words());
-        return re.trim();
+        Z_bytes n = zero(std::max(signed_size(), z.signed_size()) + 1);
+        arithmetic::plus(n.words().count(), n.words(), words(), z.words(), fill(), z.fill());
+        return n.trim();
     }
     
     template <endian::order r>
     Z_bytes<r> Z_bytes<r>::operator-(const Z_bytes& z) const {
-        uint32 s = std::max(size(), z.size()) + 1;
-        Z_bytes re{bytes{s}};
-        methods::minus(s, words(), z.words(), re.words());
-        return re.trim();
+        Z_bytes n = zero(std::max(signed_size(), z.signed_size()) + 1);
+        arithmetic::minus(n.words().count(), n.words(), words(), z.words(), fill(), z.fill());
+        return n.trim();
     }
     
     template <endian::order r> 
     Z_bytes<r> Z_bytes<r>::operator*(const Z_bytes& z) const {
-        uint32 s = size() + z.size() + 1;
-        Z_bytes re{bytes{s}};
-        methods::times(s, words(), z.words(), re.words());
-        return re.trim();
+        size_t a = signed_size();
+        size_t b = z.signed_size();
+        Z_bytes n = zero(a + b);
+        arithmetic::times(n.words().count(), n.words(), (a + 7) / 8, words(), (b + 7) / 8, z.words(), fill(), z.fill());
+        return n.trim();
     }
-    */
+    
     template <endian::order r> 
-    Z_bytes<r> Z_bytes<r>::trim() const {
-        byte fill = is_negative() ? 0xff : 0x00;
-        int extra_room = 0;
-        while (extra_room < size() && operator[](extra_room) == fill) extra_room++;
-        Z_bytes<r> ru(size() - extra_room, fill);
-        if (r == endian::big) std::copy(this->begin() + extra_room, this->end(), ru.begin());
-        else std::copy(this->begin(), this->begin() + size() - extra_room, ru.begin());
-        return ru;
+    Z_bytes<r> Z_bytes<r>::operator^(uint32 n) const {
+        Z_bytes pow = 1;
+        Z_bytes x = *this;
+        while (n != 0) {
+            if (n & 1) pow *= x;
+            n >>= 1;
+            if (n != 0) x *= x;
+        }
+        return pow;
+    }
+    
+    template <endian::order r> 
+    Z_bytes<r> Z_bytes<r>::operator<<(int64 x) const {
+        if (x < 0) return operator>>(-x);
+        Z_bytes n = zero(signed_size() + (x + 7) / 8);
+        arithmetic::shift_left(n.words().count(), n.words(), words(), x, fill());
+        return n.trim();
+    }
+    
+    template <endian::order r> 
+    Z_bytes<r> Z_bytes<r>::operator>>(int64 x) const {
+        if (x < 0) return operator<<(-x);
+        size_t s = signed_size();
+        Z_bytes n = zero(static_cast<size_t>(x / 8) >= s ? 1 : s - x / 8);
+        arithmetic::shift_right(n.words().count(), n.words(), words(), x, fill());
+        return n.trim();
     }
 
     template <endian::order r> 
@@ -273,38 +336,6 @@ namespace data::math::number {
             return i.abs();
         }
     };
-    
-    template <endian::order r>
-    bool Z_bytes<r>::operator==(const Z_bytes& z) const {
-        bool negative_left = is_negative();
-        bool negative_right = z.is_negative();
-        if (negative_left != negative_right) return false; 
-        size_t left_size = size();
-        size_t right_size = z.size();
-        size_t left_begin;
-        size_t right_begin;
-        size_t left_end;
-        size_t right_end;
-        size_t min_size = std::min(left_size, right_size);
-        if (r == endian::big) {
-            left_begin = 0;
-            right_begin = 0;
-            left_end = min_size;
-            right_end = min_size;
-        } else {
-            left_end = left_size;
-            right_end = right_size;
-            if (left_size > right_size) {
-                left_begin = left_end - min_size;
-                right_begin = 0;
-            } else {
-                left_begin = 0;
-                right_begin = right_end - min_size;
-            }
-        }
-        
-        return operator bytes_view().substr(left_begin, left_end) == bytes_view(z).substr(right_begin, right_end);
-    }
 
 }
 
@@ -0,0 +1,450 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_MATH_NUMBER_BYTES_ARITHMETIC
+#define DATA_MATH_NUMBER_BYTES_ARITHMETIC
+
+#include <array>
+#include <utility>
+#include <cstring>
+#include <data/types.hpp>
+#include <data/encoding/endian.hpp>
+
+// Arithmetic on natural numbers and two's complement integers
+// stored in byte strings. Numbers are processed 64 bits at a time.
+namespace data::math::arithmetic {
+
+    __extension__ typedef unsigned __int128 uint128;
+
+    using limb = uint64;
+
+    constexpr limb max_limb = ~limb{0};
+
+    // A byte string of either endian order seen as a sequence
+    // of native 64-bit limbs, least significant first.
+    template <endian::order r, typename word = const byte> struct limbs {
+        word *Data;
+        size_t Size;
+
+        limbs(word *d, size_t size) : Data{d}, Size{size} {}
+
+        // number of limbs required to hold the whole string.
+        size_t count() const {
+            return (Size + 7) / 8;
+        }
+
+        // the i'th least significant byte.
+        word &digit(size_t i) const {
+            return r == endian::little ? Data[i] : Data[Size - 1 - i];
+        }
+
+        bool negative() const {
+            return Size > 0 && digit(Size - 1) >= 0x80;
+        }
+
+        // the number of bytes that remain when leading bytes equal to fill are removed.
+        size_t significant(byte fill = 0x00) const {
+            size_t s = Size;
+            while (s > 0 && digit(s - 1) == fill) s--;
+            return s;
+        }
+
+        // limbs past the end of the string are read as fill.
+        limb get(size_t i, limb fill = 0) const {
+            size_t b = 8 * i;
+            limb x;
+            if (b + 8 <= Size) {
+                if constexpr (r == endian::little) {
+                    std::memcpy(&x, Data + b, 8);
+                    return boost::endian::little_to_native(x);
+                } else {
+                    std::memcpy(&x, Data + Size - b - 8, 8);
+                    return boost::endian::big_to_native(x);
+                }
+            }
+            x = fill;
+            for (size_t j = 0; b + j < Size; j++)
+                x = (x & ~(limb{0xff} << (8 * j))) | (limb(digit(b + j)) << (8 * j));
+            return x;
+        }
+
+        // bits that would go past the end of the string are dropped.
+        void set(size_t i, limb x) const {
+            size_t b = 8 * i;
+            if (b + 8 <= Size) {
+                if constexpr (r == endian::little) {
+                    x = boost::endian::native_to_little(x);
+                    std::memcpy(Data + b, &x, 8);
+                } else {
+                    x = boost::endian::native_to_big(x);
+                    std::memcpy(Data + Size - b - 8, &x, 8);
+                }
+                return;
+            }
+            for (size_t j = 0; b + j < Size; j++) digit(b + j) = byte(x >> (8 * j));
+        }
+    };
+
+    // native limbs in an array, least significant first.
+    template <typename word = const limb> struct native_limbs {
+        word *Data;
+        size_t Size;
+
+        native_limbs(word *d, size_t size) : Data{d}, Size{size} {}
+
+        size_t count() const {
+            return Size;
+        }
+
+        limb get(size_t i, limb fill = 0) const {
+            return i < Size ? Data[i] : fill;
+        }
+
+        void set(size_t i, limb x) const {
+            if (i < Size) Data[i] = x;
+        }
+    };
+
+    inline limb add_with_carry(limb a, limb b, limb &carry) {
+        limb x = a + b;
+        limb c = x < a;
+        limb y = x + carry;
+        carry = c + (y < x);
+        return y;
+    }
+
+    inline limb subtract_with_borrow(limb a, limb b, limb &borrow) {
+        limb x = a - b;
+        limb c = a < b;
+        limb y = x - borrow;
+        borrow = c + (x < borrow);
+        return y;
+    }
+
+    // Functions below take accessors with get and set methods, such as
+    // limbs or native_limbs above. n is always a number of limbs. Output may
+    // alias input except where noted.
+
+    // compare numbers as unsigned, or as two's complement if the fill
+    // values are given as sign extensions.
+    template <typename A, typename B>
+    int compare(size_t n, const A a, const B b, limb fill_a = 0, limb fill_b = 0) {
+        if (fill_a != fill_b) return fill_a != 0 ? -1 : 1;
+        for (size_t i = n; i > 0; i--) {
+            limb x = a.get(i - 1, fill_a);
+            limb y = b.get(i - 1, fill_b);
+            if (x != y) return x < y ? -1 : 1;
+        }
+        return 0;
+    }
+
+    template <typename O, typename A, typename B>
+    limb plus(size_t n, O out, const A a, const B b, limb fill_a = 0, limb fill_b = 0) {
+        limb carry = 0;
+        for (size_t i = 0; i < n; i++) out.set(i, add_with_carry(a.get(i, fill_a), b.get(i, fill_b), carry));
+        return carry;
+    }
+
+    template <typename O, typename A>
+    limb plus(size_t n, O out, const A a, limb b, limb fill_a = 0) {
+        limb carry = b;
+        for (size_t i = 0; i < n; i++) out.set(i, add_with_carry(a.get(i, fill_a), 0, carry));
+        return carry;
+    }
+
+    // returns the borrow, which is nonzero if b > a.
+    template <typename O, typename A, typename B>
+    limb minus(size_t n, O out, const A a, const B b, limb fill_a = 0, limb fill_b = 0) {
+        limb borrow = 0;
+        for (size_t i = 0; i < n; i++) out.set(i, subtract_with_borrow(a.get(i, fill_a), b.get(i, fill_b), borrow));
+        return borrow;
+    }
+
+    template <typename O, typename A>
+    limb minus(size_t n, O out, const A a, limb b, limb fill_a = 0) {
+        limb borrow = b;
+        for (size_t i = 0; i < n; i++) out.set(i, subtract_with_borrow(a.get(i, fill_a), 0, borrow));
+        return borrow;
+    }
+
+    template <typename O, typename A>
+    void copy(size_t n, O out, const A a, limb fill_a = 0) {
+        for (size_t i = 0; i < n; i++) out.set(i, a.get(i, fill_a));
+    }
+
+    template <typename O, typename A>
+    void bit_negate(size_t n, O out, const A a, limb fill_a = 0) {
+        for (size_t i = 0; i < n; i++) out.set(i, ~a.get(i, fill_a));
+    }
+
+    // out = a * b + c, returning the limb that carries past n.
+    template <typename O, typename A>
+    limb times(size_t n, O out, const A a, limb b, limb c = 0, limb fill_a = 0) {
+        for (size_t i = 0; i < n; i++) {
+            uint128 p = uint128(a.get(i, fill_a)) * b + c;
+            out.set(i, limb(p));
+            c = limb(p >> 64);
+        }
+        return c;
+    }
+
+    // Schoolbook multiplication of the first na limbs of a by the first nb
+    // limbs of b, truncated to n limbs. out must not alias a or b. The
+    // result is also correct for two's complement numbers as long as it
+    // fits in n limbs and the inputs are sign-extended to n limbs.
+    template <typename O, typename A, typename B>
+    void times(size_t n, O out, size_t na, const A a, size_t nb, const B b, limb fill_a = 0, limb fill_b = 0) {
+        if (fill_a != 0) na = n;
+        if (fill_b != 0) nb = n;
+        for (size_t i = 0; i < n; i++) out.set(i, 0);
+        for (size_t i = 0; i < na && i < n; i++) {
+            limb ai = a.get(i, fill_a);
+            if (ai == 0) continue;
+            limb carry = 0;
+            size_t j = 0;
+            for (; j < nb && i + j < n; j++) {
+                uint128 p = uint128(ai) * b.get(j, fill_b) + out.get(i + j) + carry;
+                out.set(i + j, limb(p));
+                carry = limb(p >> 64);
+            }
+            if (i + j < n) out.set(i + j, carry);
+        }
+    }
+
+    // out = a << bits, for an output of n limbs.
+    template <typename O, typename A>
+    void shift_left(size_t n, O out, const A a, size_t bits, limb fill_a = 0) {
+        size_t q = bits / 64;
+        size_t s = bits % 64;
+        // go from the top down so that out may be the same as a.
+        for (size_t i = n; i > 0; i--) {
+            size_t k = i - 1;
+            limb x = k >= q ? a.get(k - q, fill_a) << s : 0;
+            if (s != 0 && k >= q + 1) x |= a.get(k - q - 1, fill_a) >> (64 - s);
+            out.set(k, x);
+        }
+    }
+
+    // out = a >> bits, for an output of n limbs. Set fill_a to
+    // max_limb for an arithmetic shift of a negative number.
+    template <typename O, typename A>
+    void shift_right(size_t n, O out, const A a, size_t bits, limb fill_a = 0) {
+        size_t q = bits / 64;
+        size_t s = bits % 64;
+        for (size_t i = 0; i < n; i++) {
+            limb x = a.get(i + q, fill_a) >> s;
+            if (s != 0) x |= a.get(i + q + 1, fill_a) << (64 - s);
+            out.set(i, x);
+        }
+    }
+
+    // divide u by a single limb, returning the remainder.
+    inline limb divide(limb *q, const limb *u, size_t m, limb v) {
+        limb k = 0;
+        for (size_t j = m; j > 0; j--) {
+            uint128 x = (uint128(k) << 64) | u[j - 1];
+            q[j - 1] = limb(x / v);
+            k = limb(x % v);
+        }
+        return k;
+    }
+
+    // Knuth's algorithm D. u has m limbs and v has n limbs, with
+    // m >= n and v[n - 1] != 0. q receives m - n + 1 limbs and r
+    // receives n limbs. scratch must have room for m + n + 1 limbs.
+    inline void divide(limb *q, limb *r, const limb *u, size_t m, const limb *v, size_t n, limb *scratch) {
+        if (n == 1) {
+            r[0] = divide(q, u, m, v[0]);
+            return;
+        }
+
+        int s = __builtin_clzll(v[n - 1]);
+        limb *vn = scratch;
+        limb *un = scratch + n;
+
+        // normalize so that the top bit of the divisor is set.
+        for (size_t i = n - 1; i > 0; i--) vn[i] = (v[i] << s) | (s == 0 ? 0 : v[i - 1] >> (64 - s));
+        vn[0] = v[0] << s;
+
+        un[m] = s == 0 ? 0 : u[m - 1] >> (64 - s);
+        for (size_t i = m - 1; i > 0; i--) un[i] = (u[i] << s) | (s == 0 ? 0 : u[i - 1] >> (64 - s));
+        un[0] = u[0] << s;
+
+        for (size_t j = m - n + 1; j > 0; j--) {
+            size_t k = j - 1;
+
+            // estimate the next limb of the quotient.
+            uint128 num = (uint128(un[k + n]) << 64) | un[k + n - 1];
+            uint128 qhat = num / vn[n - 1];
+            uint128 rhat = num % vn[n - 1];
+            while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[k + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if ((rhat >> 64) != 0) break;
+            }
+
+            // multiply and subtract.
+            limb borrow = 0;
+            limb carry = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint128 p = qhat * vn[i] + carry;
+                carry = limb(p >> 64);
+                un[i + k] = subtract_with_borrow(un[i + k], limb(p), borrow);
+            }
+            un[k + n] = subtract_with_borrow(un[k + n], carry, borrow);
+
+            q[k] = limb(qhat);
+
+            // the estimate was one too big, so add back.
+            if (borrow != 0) {
+                q[k]--;
+                carry = 0;
+                for (size_t i = 0; i < n; i++) un[i + k] = add_with_carry(un[i + k], vn[i], carry);
+                un[k + n] += carry;
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) r[i] = (un[i] >> s) | (s == 0 ? 0 : un[i + 1] << (64 - s));
+    }
+
+    // Fixed-width numbers held in native limbs on the stack. Loops
+    // over the limbs are unrolled at compile time.
+    template <size_t n> using fixed = std::array<limb, n>;
+
+    template <typename F, size_t ... i>
+    inline void unroll(F f, std::index_sequence<i...>) {
+        (f(std::integral_constant<size_t, i>{}), ...);
+    }
+
+    // call f with each index from 0 to n - 1 as an integral_constant.
+    template <size_t n, typename F>
+    inline void unroll(F f) {
+        unroll(f, std::make_index_sequence<n>{});
+    }
+
+    template <size_t n, endian::order r>
+    inline fixed<n> load(const byte *d, size_t size, limb fill = 0) {
+        fixed<n> x;
+        limbs<r> l{d, size};
+        unroll<n>([&](auto i) {
+            x[i] = l.get(i, fill);
+        });
+        return x;
+    }
+
+    template <size_t n, endian::order r>
+    inline void store(byte *d, size_t size, const fixed<n> &x) {
+        limbs<r, byte> l{d, size};
+        unroll<n>([&](auto i) {
+            l.set(i, x[i]);
+        });
+    }
+
+    template <size_t n>
+    inline native_limbs<limb> view(fixed<n> &x) {
+        return native_limbs<limb>{x.data(), n};
+    }
+
+    template <size_t n>
+    inline native_limbs<const limb> view(const fixed<n> &x) {
+        return native_limbs<const limb>{x.data(), n};
+    }
+
+    // unsigned comparison.
+    template <size_t n>
+    inline int compare(const fixed<n> &a, const fixed<n> &b) {
+        int result = 0;
+        unroll<n>([&](auto i) {
+            constexpr size_t k = n - 1 - decltype(i)::value;
+            if (result == 0 && a[k] != b[k]) result = a[k] < b[k] ? -1 : 1;
+        });
+        return result;
+    }
+
+    template <size_t n>
+    inline bool is_zero(const fixed<n> &a) {
+        limb x = 0;
+        unroll<n>([&](auto i) {
+            x |= a[i];
+        });
+        return x == 0;
+    }
+
+    // a += b, returning the carry.
+    template <size_t n>
+    inline limb plus(fixed<n> &a, const fixed<n> &b) {
+        limb carry = 0;
+        unroll<n>([&](auto i) {
+            a[i] = add_with_carry(a[i], b[i], carry);
+        });
+        return carry;
+    }
+
+    // a -= b, returning the borrow.
+    template <size_t n>
+    inline limb minus(fixed<n> &a, const fixed<n> &b) {
+        limb borrow = 0;
+        unroll<n>([&](auto i) {
+            a[i] = subtract_with_borrow(a[i], b[i], borrow);
+        });
+        return borrow;
+    }
+
+    // two's complement negation.
+    template <size_t n>
+    inline void negate(fixed<n> &a) {
+        limb carry = 1;
+        unroll<n>([&](auto i) {
+            a[i] = add_with_carry(~a[i], 0, carry);
+        });
+    }
+
+    // a * b truncated to n limbs, which is also correct for
+    // two's complement numbers.
+    template <size_t n>
+    inline fixed<n> times(const fixed<n> &a, const fixed<n> &b) {
+        fixed<n> out{};
+        unroll<n>([&](auto i) {
+            limb carry = 0;
+            unroll<n - decltype(i)::value>([&](auto j) {
+                uint128 p = uint128(a[i]) * b[j] + out[i + j] + carry;
+                out[i + j] = limb(p);
+                carry = limb(p >> 64);
+            });
+        });
+        return out;
+    }
+
+    // a to the power of e by repeated squaring.
+    template <size_t n>
+    inline fixed<n> power(fixed<n> a, const fixed<n> &e) {
+        fixed<n> pow{1};
+        for (size_t i = 0; i < n; i++) for (limb b = e[i]; b != 0; b >>= 1) {
+            if (b & 1) pow = times(pow, a);
+            a = times(a, a);
+        }
+        return pow;
+    }
+
+    // unsigned division with Knuth's algorithm D, using only stack memory.
+    // v must not be zero.
+    template <size_t n>
+    inline void divide(fixed<n> &q, fixed<n> &r, const fixed<n> &u, const fixed<n> &v) {
+        q = fixed<n>{};
+        r = fixed<n>{};
+        size_t m = n;
+        while (m > 0 && u[m - 1] == 0) m--;
+        size_t d = n;
+        while (d > 0 && v[d - 1] == 0) d--;
+        if (m < d) {
+            r = u;
+            return;
+        }
+        std::array<limb, 2 * n + 1> scratch;
+        divide(q.data(), r.data(), u.data(), m, v.data(), d, scratch.data());
+    }
+
+}
+
+#endif
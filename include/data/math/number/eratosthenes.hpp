@@ -30,7 +30,7 @@ namespace data::math::number {
             }
         };
         
-        using heap = tool::priority_queue<entry, tool::linked_stack<entry>>;
+        using heap = tool::priority_queue<entry, tool::linked_stack<entry>, tool::pooled_allocation>;
         heap Sieve;
         
         eratosthenes(list<prime<N>> p, N m, heap sieve) : Primes{p}, Next{m}, Sieve{sieve} {}
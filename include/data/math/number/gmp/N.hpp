@@ -292,6 +292,12 @@ namespace data::math::number::gmp {
         return operator*=(n.Value);
     }
     
+    // n with gmp's digits for a base from 2 to 62, which encoding::write_base 
+    // and encoding::read_base use. gmp converts large numbers in subquadratic time. 
+    std::string write_digits(const N& n, uint32 base);
+    
+    void read_digits(N& n, const std::string& digits, uint32 base);
+    
 }
 
 namespace data::math::number {
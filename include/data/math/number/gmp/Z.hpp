@@ -329,8 +329,8 @@ namespace data::math::number::gmp {
         
         template <endian::order o> 
         explicit Z(const Z_bytes<o>& b) : Z(bytes_view(b), o) {
-            if (b[0] < 0x80) return;
-            *this -= (Z{2} << (b.size() * 8));
+            if (b.sign() != math::negative) return;
+            *this -= (Z{1} << (b.size() * 8));
         }
         
         template <endian::order o> 
@@ -347,15 +347,7 @@ namespace data::math::number::gmp {
         explicit operator uint64() const;
         
         Z(bytes_view b, endian::order o) : Z{0} {
-            int i;
-            if (o == endian::big) for(i = 0; i < static_cast<int>(b.size()) - 1; i++) {
-                operator+=(b[i]);
-                operator<<(8);
-            } else for(i = b.size() - 1; i > 0; i--) {
-                operator+=(b[i]);
-                operator<<(8);
-            }
-            operator+=(b[i]);
+            if (b.size() > 0) mpz_import(MPZ, b.size(), o == endian::big ? 1 : -1, 1, 0, 0, b.data());
         }
         
         void write_bytes(bytes&, endian::order o) const {
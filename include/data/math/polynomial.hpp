@@ -105,7 +105,7 @@ namespace data::math {
             division<ordering> operator/(const ordering& o) const;
         };
         
-        using terms = tool::ordered_list<ordering>;
+        using terms = tool::ordered_list<ordering, tool::pooled_allocation>;
         
         terms Terms;
         
@@ -10,22 +10,62 @@
 #include <boost/beast/http.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/version.hpp>
+#include <boost/asio/async_result.hpp>
 #include <boost/asio/connect.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <data/tools.hpp>
 
 namespace data::networking {
     struct http {
         using header = boost::beast::http::field;
         using method = boost::beast::http::verb;
+        using status = boost::beast::http::status;
+        
+        // Connections are kept open and used again for requests to the same 
+        // host and port. TLS sessions are resumed when a connection must 
+        // be opened again, and addresses are looked up again only once they 
+        // are older than DNSLifetime, since the resolver does not give us TTLs. 
+        struct options {
+            // idle connections kept for each host. With zero, every
+            // request opens a connection and closes it afterwards. 
+            size_t Connections = 8;
+            // idle connections older than this are closed rather than used. 
+            std::chrono::steady_clock::duration IdleTimeout = std::chrono::seconds(30);
+            std::chrono::steady_clock::duration DNSLifetime = std::chrono::seconds(60);
+            // requests that are sent before waiting for a response. 
+            size_t Pipeline = 16;
+            // without TLS, for hosts that only speak plain HTTP. 
+            bool TLS = true;
+        };
         
         http();
+        explicit http(options);
+        
+        // requests are run on an io_context that belongs to someone else, so that 
+        // many requests can be in flight at once on the threads that run it. 
+        explicit http(boost::asio::io_context&);
+        http(boost::asio::io_context&, options);
+        
+        ~http();
         
+        // keys and values are URL-encoded. 
         static string append_params(string path, const std::map<string, string>& params);
         
+        // escape every character but letters, digits and -._~ with %. 
+        static string url_encode(string_view);
+        
         string request(
             string port, 
             method verb, 
@@ -69,10 +109,106 @@ namespace data::networking {
             const std::map<header, string>& headers={},
             const std::map<string, string>& form_data={});
         
+        struct call {
+            method Method;
+            string Path;
+            std::map<header, string> Headers;
+            string Body;
+        };
+        
+        // send several requests to one host without waiting for each response. 
+        // The bodies of the responses are returned in the same order. 
+        std::vector<string> pipeline(string port, string hostname, const std::vector<call>& calls);
+        
+        std::vector<string> pipeline(string hostname, const std::vector<call>& calls) {
+            return pipeline("https", hostname, calls);
+        }
+        
+        // Send a request and give the body of the response to the sink in pieces 
+        // as it is read, so that it is never all in memory at once. Returns the 
+        // status of the response, and throws if the response cannot be read. 
+        using sink = std::function<void(string_view)>;
+        status stream(string port, string hostname, const call& c, const sink& f);
+        
+        using clock = std::chrono::steady_clock;
+        
+        // the signature of the completion of async_request. 
+        using completion = void(boost::system::error_code, string);
+        
+        // Start a request and return at once. The token may be a callback with
+        // the signature above, boost::asio::use_future, or boost::asio::use_awaitable 
+        // in a coroutine. The request fails with boost::beast::error::timeout if it 
+        // has not connected, been sent and been answered by the deadline (looking up 
+        // the address is not timed). The http must outlive the request.
+        template <typename token>
+        auto async_request(string port, string hostname, call c, clock::time_point deadline, token&& t) {
+            return boost::asio::async_initiate<token, completion>(
+                [this](auto handler, string port, string hostname, call c, clock::time_point deadline) {
+                    // the handler is called with its own executor, or with ours if it has none. 
+                    auto work = boost::asio::make_work_guard(boost::asio::get_associated_executor(handler, ioc.get_executor()));
+                    auto h = std::make_shared<decltype(handler)>(std::move(handler));
+                    start(key{hostname, port}, std::move(c), deadline,
+                        [h, work](boost::system::error_code ec, string body) mutable {
+                            boost::asio::dispatch(work.get_executor(), [h, ec, body = std::move(body)]() mutable {
+                                (*h)(ec, std::move(body));
+                            });
+                            work.reset();
+                        });
+                }, t, std::move(port), std::move(hostname), std::move(c), deadline);
+        }
+        
+        template <typename token>
+        auto async_request(string port, string hostname, call c, clock::duration timeout, token&& t) {
+            return async_request(std::move(port), std::move(hostname), std::move(c), clock::now() + timeout, std::forward<token>(t));
+        }
+        
     private:
-        boost::asio::io_context ioc;
+        struct connection;
+        
+        struct host {
+            std::vector<std::unique_ptr<connection>> Idle;
+            // the last TLS session, to resume when we connect again. 
+            SSL_SESSION* Session = nullptr;
+            
+            boost::asio::ip::tcp::resolver::results_type Addresses;
+            std::chrono::steady_clock::time_point Resolved;
+        };
+        
+        using key = std::pair<string, string>;
+        using addresses = boost::asio::ip::tcp::resolver::results_type;
+        
+        bool resolved(const key&, addresses&);
+        void resolved(const key&, const addresses&);
+        // a connection that has not connected yet. 
+        std::unique_ptr<connection> make(const key&, boost::system::error_code&);
+        void save(const key&, connection&);
+        // the body of a request is not copied into it. 
+        using request_message = boost::beast::http::request<boost::beast::http::span_body<const char>>;
+        request_message prepare(const key&, const call&) const;
+        // put a request in the connection's buffer and write the buffer if we are told 
+        // to or it is full. A large body is written from where it is rather than 
+        // copied into the buffer. Returns how many requests were written. 
+        size_t send(connection&, const key&, const call&, bool flush, boost::system::error_code&);
+        
+        std::unique_ptr<connection> open(const key&);
+        std::unique_ptr<connection> take(const key&);
+        void give(const key&, std::unique_ptr<connection>);
+        
+        // send calls from the given index on one connection and read as many responses 
+        // as we can, until the connection is closed. Returns how many were read. 
+        size_t exchange(const key&, const std::vector<call>&, size_t, std::vector<string>&);
+        
+        struct async_call;
+        void start(const key&, call, clock::time_point, std::function<completion>);
+        
+        const options Options;
+        
+        std::unique_ptr<boost::asio::io_context> Owned;
+        boost::asio::io_context& ioc;
         boost::asio::ssl::context ssl_ctx;
-        boost::asio::ip::tcp::resolver resolver;
+        
+        std::mutex Mutex;
+        std::map<key, host> Hosts;
  
     };
 }
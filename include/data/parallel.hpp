@@ -0,0 +1,219 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_PARALLEL
+#define DATA_PARALLEL
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include <data/iterable.hpp>
+#include <data/math/associative.hpp>
+#include <data/math/commutative.hpp>
+#include <data/tools/executor.hpp>
+#include <data/tools/linked_tree.hpp>
+#include <data/tools/rb_map.hpp>
+
+// for_each, fold and reduce over containers whose elements can be divided
+// among the threads of an executor. A function given to any of these may
+// be called from several threads at once.
+//
+// fold and reduce group the elements differently from their sequential
+// versions in data/fold.hpp, so they require math::associative<f, x> to
+// be declared. If math::commutative<f, x> is declared as well, fold over
+// a cross lets each thread claim pieces as it is ready for them and
+// combines the results in whatever order they come.
+
+namespace data::parallel {
+    using executor = tool::executor;
+
+    // how many pieces to divide the work into, so that
+    // a thread that finishes early has something to steal.
+    inline size_t pieces(const executor& e) {
+        return 8 * e.size();
+    }
+
+    inline size_t grain(const executor& e, size_t n) {
+        return std::max<size_t>(1, n / pieces(e));
+    }
+
+    // how many levels of a balanced tree to divide.
+    inline int depth(const executor& e) {
+        int d = 0;
+        for (size_t p = 1; p < pieces(e); p <<= 1) d++;
+        return d;
+    }
+
+    // run a and b with the executor if they are worth dividing.
+    template <typename A, typename B>
+    void join(executor& e, bool divide, A a, B b) {
+        if (divide) return e.join(a, b);
+        a();
+        b();
+    }
+
+    // call f(begin, end) on pieces of the range that are no bigger than grain.
+    template <typename F>
+    void divide(executor& e, size_t begin, size_t end, size_t grain, F& f) {
+        if (end - begin <= grain) return f(begin, end);
+        size_t mid = begin + (end - begin) / 2;
+        e.join(
+            [&e, begin, mid, grain, &f]() { divide(e, begin, mid, grain, f); },
+            [&e, mid, end, grain, &f]() { divide(e, mid, end, grain, f); });
+    }
+
+    // the elements of a cross combined in order, or nothing if there are none.
+    template <typename F, typename X>
+    std::optional<X> combine(executor& e, F& f, const cross<X>& c, size_t begin, size_t end, size_t grain) {
+        if (begin == end) return {};
+        auto x = c.begin();
+        if (end - begin <= grain) {
+            X r = x[begin];
+            for (size_t i = begin + 1; i < end; i++) r = f(r, x[i]);
+            return r;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        std::optional<X> l, r;
+        e.join(
+            [&]() { l = combine(e, f, c, begin, mid, grain); },
+            [&]() { r = combine(e, f, c, mid, end, grain); });
+        return f(*l, *r);
+    }
+
+    // the elements of a cross combined in any order. Each thread
+    // claims the next piece when it is done with the last.
+    template <typename F, typename X>
+    std::optional<X> combine_unordered(executor& e, F& f, const cross<X>& c, size_t grain) {
+        std::atomic<size_t> next{0};
+        std::vector<std::optional<X>> results(e.size());
+        auto x = c.begin();
+        size_t n = c.size();
+
+        auto work = [&](size_t i, size_t) {
+            std::optional<X>& r = results[i];
+            for (size_t begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain)) {
+                size_t end = std::min(n, begin + grain);
+                for (size_t j = begin; j < end; j++) r = r ? f(*r, x[j]) : x[j];
+            }
+        };
+
+        divide(e, 0, results.size(), 1, work);
+
+        std::optional<X> r;
+        for (const std::optional<X>& y : results) if (y) r = r ? f(*r, *y) : *y;
+        return r;
+    }
+
+    template <typename F, typename X>
+    std::optional<X> combine(executor& e, F& f, const cross<X>& c) {
+        if constexpr (meta::is_commutative<F, X>::value) return combine_unordered(e, f, c, grain(e, c.size()));
+        else return combine(e, f, c, 0, c.size(), grain(e, c.size()));
+    }
+
+    // a tree is combined in the order of its iterator:
+    // the root, then the left branch, then the right.
+    template <typename F, typename X, typename alloc>
+    std::optional<X> combine(executor& e, F& f, const tool::linked_tree<X, alloc>& t, size_t grain) {
+        if (t.empty()) return {};
+        std::optional<X> l, r;
+        join(e, t.size() > grain,
+            [&]() { l = combine(e, f, t.left(), grain); },
+            [&]() { r = combine(e, f, t.right(), grain); });
+        X x = t.root();
+        if (l) x = f(x, *l);
+        if (r) x = f(x, *r);
+        return x;
+    }
+
+    template <typename F, typename X, typename alloc>
+    std::optional<X> combine(executor& e, F& f, const tool::linked_tree<X, alloc>& t) {
+        return combine(e, f, t, grain(e, t.size()));
+    }
+
+    // the values of a map are combined in the order of their keys.
+    template <typename F, typename K, typename V, typename alloc>
+    std::optional<V> combine(executor& e, F& f, const milewski::okasaki::RBMap<K, V, alloc>& t, int depth) {
+        if (t.isEmpty()) return {};
+        if (depth <= 0) {
+            auto c = t.first();
+            V x = c.value();
+            for (c.next(); !c.isEnd(); c.next()) x = f(x, c.value());
+            return x;
+        }
+        
+        std::optional<V> l, r;
+        e.join(
+            [&]() { l = combine(e, f, t.left(), depth - 1); },
+            [&]() { r = combine(e, f, t.right(), depth - 1); });
+        V x = l ? f(*l, t.rootValue()) : t.rootValue();
+        return r ? f(x, *r) : x;
+    }
+
+    template <typename F, typename K, typename V, typename alloc>
+    std::optional<V> combine(executor& e, F& f, const tool::rb_map<K, V, alloc>& m) {
+        return combine(e, f, m.tree(), depth(e));
+    }
+
+    // a cross of f applied to every element.
+    template <typename F, typename X>
+    cross<std::invoke_result_t<F&, const X&>> for_each(F f, const cross<X>& c, executor& e = executor::standard()) {
+        cross<std::invoke_result_t<F&, const X&>> result(c.size());
+        auto x = c.begin();
+        auto y = result.begin();
+        auto work = [&f, x, y](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) y[i] = f(x[i]);
+        };
+        divide(e, 0, c.size(), grain(e, c.size()), work);
+        return result;
+    }
+
+    template <typename Y, typename F, typename X, typename alloc>
+    tool::linked_tree<Y, alloc> for_each(executor& e, F& f, const tool::linked_tree<X, alloc>& t, size_t grain) {
+        if (t.empty()) return {};
+        tool::linked_tree<Y, alloc> l, r;
+        join(e, t.size() > grain,
+            [&]() { l = for_each<Y>(e, f, t.left(), grain); },
+            [&]() { r = for_each<Y>(e, f, t.right(), grain); });
+        return tool::linked_tree<Y, alloc>{f(t.root()), l, r};
+    }
+
+    // a tree of the same shape with f applied to every element.
+    template <typename F, typename X, typename alloc>
+    tool::linked_tree<std::invoke_result_t<F&, const X&>, alloc>
+    for_each(F f, const tool::linked_tree<X, alloc>& t, executor& e = executor::standard()) {
+        return for_each<std::invoke_result_t<F&, const X&>>(e, f, t, grain(e, t.size()));
+    }
+
+    // a map with the same keys in which f is applied to every value.
+    template <typename F, typename K, typename V, typename alloc>
+    tool::rb_map<K, std::invoke_result_t<F&, const V&>, alloc>
+    for_each(F f, const tool::rb_map<K, V, alloc>& m, executor& e = executor::standard()) {
+        int d = depth(e);
+        return m.map_values(f, [&e, d](int depth, auto a, auto b) {
+            join(e, depth < d, a, b);
+        });
+    }
+
+    // the same as data::fold if f is associative.
+    template <typename F, typename X, typename C>
+    X fold(F f, X init, const C& c, executor& e = executor::standard()) {
+        static_assert(meta::is_associative<F, X>::value, "parallel fold requires math::associative<F, X>");
+        std::optional<X> x = combine(e, f, c);
+        return x ? f(init, *x) : init;
+    }
+
+    // the same as data::reduce if f is associative.
+    template <typename X, typename F, typename C>
+    X reduce(F f, const C& c, executor& e = executor::standard()) {
+        static_assert(meta::is_associative<F, X>::value, "parallel reduce requires math::associative<F, X>");
+        std::optional<X> x = combine(e, f, c);
+        return x ? f(*x, X{}) : X{};
+    }
+
+}
+
+#endif
@@ -40,15 +40,13 @@ namespace data {
 namespace data::functional::stack {
     
     template <typename L>
-    L reverse(L list) {        
-        struct inner {
-            L operator()(L reversed, L list) {
-                if (data::empty(list)) return reversed;
-                return inner{}(reversed << first(list), rest(list));
-            }
-        };
-        
-        return inner{}(L{}, list);
+    L reverse(L list) {
+        L reversed{};
+        while (!data::empty(list)) {
+            reversed = reversed << first(list);
+            list = rest(list);
+        }
+        return reversed;
     }
     
     template <typename L>
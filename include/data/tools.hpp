@@ -24,7 +24,9 @@
 // A implementations of data structures. 
 #include <data/tools/linked_stack.hpp>
 #include <data/tools/rb_map.hpp>
+#include <data/tools/hash_map.hpp>
 #include <data/tools/functional_queue.hpp>
+#include <data/tools/persistent_vector.hpp>
 #include <data/tools/linked_tree.hpp>
 #include <data/tools/map_set.hpp>
 #include <data/tools/priority_queue.hpp>
@@ -34,8 +36,14 @@ namespace data {
     
     template <typename X> using stack = tool::linked_stack<X>;
     
+#ifdef DATA_LIST_VECTOR
+    // persistent vector, for elements that are small and 
+    // are read far more often than they are prepended. 
+    template <typename X> using list = tool::persistent_vector<X>;
+#else
     // functional queue built using the list. 
     template <typename X> using list = tool::functional_queue<stack<X>>;
+#endif
     
     // tree. 
     template <typename X> using tree = tool::linked_tree<X>;
@@ -47,6 +55,12 @@ namespace data {
     // set implemented as a map. 
     template <typename X> using set = tool::map_set<map<X, tool::unit>>;
     
+    // an unordered map implemented as a hash array mapped trie. 
+    template <typename K, typename V> using hash_map = tool::hash_map<K, V>;
+    
+    // unordered set implemented as a hash map. 
+    template <typename X> using hash_set = tool::map_set<hash_map<X, tool::unit>>;
+    
     // priority queue. wrapper of Milewski's implementation of Okasaki.
     template <typename X> using priority_queue = tool::priority_queue<X, stack<X>>;
     
@@ -0,0 +1,254 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_ALLOCATOR
+#define DATA_TOOLS_ALLOCATOR
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Allocation policies for the nodes of the persistent containers
+// (linked_stack, linked_tree, OrdList, RBMap and Heap). A policy
+// provides the pointer type that holds a node and a function to make one.
+//
+//   shared_allocation   std::make_shared. The default.
+//   pooled_allocation   std::allocate_shared from per-thread slab pools.
+//   local_allocation    like pooled_allocation but the reference count is
+//                       not atomic, so a container using it must never be
+//                       shared between threads.
+
+namespace data::tool {
+
+    // Fixed-size blocks carved out of large slabs. Each thread has its own
+    // free list, so allocation and deallocation take no lock. A block freed
+    // on a different thread from the one that allocated it joins the free
+    // list of the thread that frees it. A free list that grows past two slabs
+    // hands a slab's worth of blocks to a shared depot, where threads that
+    // need blocks take them before they make a new slab, so memory stays
+    // bounded when one thread allocates and another frees. When a thread
+    // exits, its free list goes to the depot too. Slabs are never returned,
+    // since their blocks can outlive the thread that made them.
+    template <size_t size, size_t align>
+    class slab_pool {
+        struct block {
+            block* Next;
+        };
+
+        static constexpr size_t block_align = align < alignof(block) ? alignof(block) : align;
+        static constexpr size_t block_size =
+            ((size < sizeof(block) ? sizeof(block) : size) + block_align - 1) / block_align * block_align;
+        static constexpr size_t slab_blocks = block_size > 1024 ? 64 : 65536 / block_size;
+
+        static_assert(block_align <= alignof(std::max_align_t));
+
+        // never destroyed, so that blocks can be freed during static destruction.
+        struct depot {
+            std::mutex Mutex;
+            block* First{nullptr};
+            size_t Count{0};
+
+            static depot& get() {
+                static depot* d = new depot{};
+                return *d;
+            }
+
+            // the blocks from first to last, which are count long.
+            void put(block* first, block* last, size_t count) {
+                std::lock_guard<std::mutex> lock{Mutex};
+                last->Next = First;
+                First = first;
+                Count += count;
+            }
+
+            // up to a slab's worth of blocks.
+            block* take(size_t& count) {
+                std::lock_guard<std::mutex> lock{Mutex};
+                if (First == nullptr) return nullptr;
+                block* first = First;
+                block* last = First;
+                count = 1;
+                while (count < slab_blocks && last->Next != nullptr) {
+                    last = last->Next;
+                    count++;
+                }
+                First = last->Next;
+                Count -= count;
+                last->Next = nullptr;
+                return first;
+            }
+        };
+
+        block* Free;
+        size_t Count;
+
+        inline static std::atomic<size_t> Slabs{0};
+
+        // set once this thread's pool has been destroyed, after which
+        // blocks freed on this thread go straight to the depot.
+        inline static thread_local bool Destroyed{false};
+
+        slab_pool() : Free{nullptr}, Count{0} {}
+
+        ~slab_pool() {
+            Destroyed = true;
+            if (Free == nullptr) return;
+            block* last = Free;
+            while (last->Next != nullptr) last = last->Next;
+            depot::get().put(Free, last, Count);
+            Free = nullptr;
+        }
+
+        void refill() {
+            Free = depot::get().take(Count);
+            if (Free != nullptr) return;
+
+            char* slab = static_cast<char*>(::operator new(block_size * slab_blocks));
+            Slabs++;
+            for (size_t i = 0; i < slab_blocks; i++) {
+                block* b = reinterpret_cast<block*>(slab + i * block_size);
+                b->Next = Free;
+                Free = b;
+            }
+            Count = slab_blocks;
+        }
+
+        void spill() {
+            block* first = Free;
+            block* last = Free;
+            for (size_t i = 1; i < slab_blocks; i++) last = last->Next;
+            Free = last->Next;
+            last->Next = nullptr;
+            Count -= slab_blocks;
+            depot::get().put(first, last, slab_blocks);
+        }
+
+    public:
+        slab_pool(const slab_pool&) = delete;
+        slab_pool& operator=(const slab_pool&) = delete;
+
+        // nullptr once the thread's pool has been destroyed.
+        static slab_pool* local() {
+            if (Destroyed) return nullptr;
+            thread_local slab_pool pool{};
+            return &pool;
+        }
+
+        void* allocate() {
+            if (Free == nullptr) refill();
+            block* b = Free;
+            Free = b->Next;
+            Count--;
+            return b;
+        }
+
+        void deallocate(void* p) {
+            block* b = static_cast<block*>(p);
+            b->Next = Free;
+            Free = b;
+            if (++Count >= 2 * slab_blocks) spill();
+        }
+
+        // for when the thread's pool is gone.
+        static void* allocate_unpooled() {
+            return ::operator new(block_size);
+        }
+
+        static void deallocate_unpooled(void* p) {
+            block* b = static_cast<block*>(p);
+            depot::get().put(b, b, 1);
+        }
+
+        // the number of blocks in this thread's free list.
+        size_t free() const {
+            return Count;
+        }
+
+        // the number of slabs made by every thread.
+        static size_t slabs() {
+            return Slabs;
+        }
+
+        static constexpr size_t blocks_per_slab = slab_blocks;
+    };
+
+    // standard allocator interface over slab_pool. Single objects come
+    // from the pool; arrays go to operator new.
+    template <typename X>
+    struct slab_allocator {
+        using value_type = X;
+
+        slab_allocator() noexcept = default;
+
+        template <typename Y>
+        slab_allocator(const slab_allocator<Y>&) noexcept {}
+
+        X* allocate(size_t n) {
+            if (n != 1) return static_cast<X*>(::operator new(n * sizeof(X)));
+            auto pool = slab_pool<sizeof(X), alignof(X)>::local();
+            if (pool == nullptr) return static_cast<X*>(slab_pool<sizeof(X), alignof(X)>::allocate_unpooled());
+            return static_cast<X*>(pool->allocate());
+        }
+
+        void deallocate(X* p, size_t n) noexcept {
+            if (n != 1) return ::operator delete(p);
+            auto pool = slab_pool<sizeof(X), alignof(X)>::local();
+            if (pool == nullptr) return slab_pool<sizeof(X), alignof(X)>::deallocate_unpooled(p);
+            pool->deallocate(p);
+        }
+
+        template <typename Y>
+        bool operator==(const slab_allocator<Y>&) const noexcept {
+            return true;
+        }
+
+        template <typename Y>
+        bool operator!=(const slab_allocator<Y>&) const noexcept {
+            return false;
+        }
+    };
+
+    struct shared_allocation {
+        template <typename X>
+        using pointer = std::shared_ptr<X>;
+
+        template <typename X, typename ... P>
+        static pointer<X> make(P&& ... p) {
+            return std::make_shared<X>(std::forward<P>(p)...);
+        }
+    };
+
+    struct pooled_allocation {
+        template <typename X>
+        using pointer = std::shared_ptr<X>;
+
+        template <typename X, typename ... P>
+        static pointer<X> make(P&& ... p) {
+            return std::allocate_shared<X>(slab_allocator<std::remove_cv_t<X>>{}, std::forward<P>(p)...);
+        }
+    };
+
+#ifdef __GLIBCXX__
+    // libstdc++ lets us choose the locking policy of the reference count.
+    struct local_allocation {
+        template <typename X>
+        using pointer = std::__shared_ptr<X, __gnu_cxx::_S_single>;
+
+        template <typename X, typename ... P>
+        static pointer<X> make(P&& ... p) {
+            return std::__allocate_shared<X, __gnu_cxx::_S_single>(slab_allocator<std::remove_cv_t<X>>{}, std::forward<P>(p)...);
+        }
+    };
+#else
+    // no portable non-atomic shared pointer, so fall back on pooling alone.
+    using local_allocation = pooled_allocation;
+#endif
+
+}
+
+#endif
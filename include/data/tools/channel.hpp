@@ -1,100 +1,351 @@
-// adapted from https://st.xorian.net/blog/2012/08/go-style-channel-in-c/ 
+// adapted from https://st.xorian.net/blog/2012/08/go-style-channel-in-c/
 
 #ifndef DATA_TOOLS_CHANNEL
 #define DATA_TOOLS_CHANNEL
 
-#include <list>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iterator>
 #include <mutex>
 #include <condition_variable>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include <data/types.hpp>
+#include <data/tools/ring.hpp>
 
 namespace data::tool {
+
+    // whether a channel may have more than one thread at each end.
+    enum class access {
+        multiple,
+        single
+    };
+
+    // something waiting on several channels at once, which any of them may wake.
+    class waiter {
+        std::mutex M;
+        std::condition_variable C;
+        bool Ready;
+        
+    public:
+        waiter() : Ready{false} {}
+        
+        void notify() {
+            {
+                std::lock_guard<std::mutex> lock{M};
+                Ready = true;
+            }
+            C.notify_one();
+        }
+        
+        // false if the deadline passed first. 
+        bool wait_until(std::chrono::steady_clock::time_point deadline) {
+            std::unique_lock<std::mutex> lock{M};
+            bool ready = C.wait_until(lock, deadline, [this]() -> bool {
+                return Ready;
+            });
+            Ready = false;
+            return ready;
+        }
+        
+        void wait() {
+            std::unique_lock<std::mutex> lock{M};
+            C.wait(lock, [this]() -> bool {
+                return Ready;
+            });
+            Ready = false;
+        }
+    };
+    
+    // the waiters registered with a channel. 
+    class waiters {
+        std::mutex M;
+        std::vector<waiter*> Waiting;
+        std::atomic<uint32> Count;
+        
+    public:
+        waiters() : M{}, Waiting{}, Count{0} {}
+        
+        // check the channel again after adding a waiter, in case 
+        // it changed before the waiter could be notified. 
+        void add(waiter* w) {
+            std::lock_guard<std::mutex> lock{M};
+            Waiting.push_back(w);
+            Count.fetch_add(1);
+        }
+        
+        void remove(waiter* w) {
+            std::lock_guard<std::mutex> lock{M};
+            Waiting.erase(std::find(Waiting.begin(), Waiting.end(), w));
+            Count.fetch_sub(1);
+        }
+        
+        // must come after a fence that follows the change to the channel. 
+        void notify() {
+            if (Count.load(std::memory_order_relaxed) == 0) return;
+            std::lock_guard<std::mutex> lock{M};
+            for (waiter* w : Waiting) w->notify();
+        }
+    };
+    
+    class select;
+    
     // a golang-like communication channel between different threads.
-    template <class item> class channel {
+    // A channel of size n holds at least n items in a lock-free ring
+    // and put waits while it is full. A channel of size 0 is unbounded
+    // and is kept in a queue behind a lock. A channel with single access
+    // must have only one thread putting and one thread getting at a time.
+    template <class item, access a = access::multiple> class channel {
+        using ring = typename std::conditional<a == access::single, spsc_ring<item>, mpmc_ring<item>>::type;
+
         struct inner {
-            std::list<item> Queue;
+            // null if the channel is unbounded.
+            std::unique_ptr<ring> Ring;
+            std::deque<item> Queue;
+            std::mutex QueueMutex;
+
+            // threads that wait hold M.
             std::mutex M;
             std::condition_variable Receive;
             std::condition_variable Send;
-            uint32 Size; 
-            bool Closed;
-            
-            inner() : Size{0}, Closed{false} { }
-            inner(uint32 n) : Size{n}, Closed{false} {}
-            
+            std::atomic<uint32> Receivers;
+            std::atomic<uint32> Senders;
+            std::atomic<bool> Closed;
             
+            // selects waiting on this channel. 
+            waiters Selects;
+
+            inner() : inner{0} {}
+            inner(uint32 n) : Ring{n == 0 ? nullptr : new ring{n}}, Receivers{0}, Senders{0}, Closed{false} {}
+
             void close();
             bool closed() const;
-            void put(const item &i);
-            bool get(item &out, bool wait = true);
+
+            template <typename it> size_t try_put(it begin, size_t n);
+            template <typename it> size_t try_get(it out, size_t n);
+
+            // wait until f succeeds or the channel is closed.
+            template <typename F> bool wait(std::atomic<uint32>& waiting, std::condition_variable& c, F f);
+            void wake(std::atomic<uint32>& waiting, std::condition_variable& c, bool all);
+
+            template <typename it> void put(it begin, size_t n);
+            bool try_put(const item* i);
+            template <typename it> size_t get(it out, size_t n, bool wait);
         };
-        
+
     public:
         class to {
             ptr<inner> Inner;
             to() : Inner{} {}
             to(ptr<inner> i) : Inner{i} {}
-            
+
         public:
             void close() {
                 Inner->close();
             }
-            
+
             bool closed() const {
                 return Inner->closed();
             }
-            
+
             void put(const item &i) {
-                Inner->put(i);
+                Inner->put(&i, 1);
+            }
+
+            template <typename it>
+            void put_batch(it begin, it end) {
+                Inner->put(begin, std::distance(begin, end));
             }
             
+            // put without waiting. False if the channel is full or closed. 
+            bool try_put(const item &i) {
+                return Inner->try_put(&i);
+            }
+
             friend class channel;
+            friend class tool::select;
         };
-        
+
         class from {
-            ptr<inner> Inner; 
+            ptr<inner> Inner;
             from() : Inner{} {}
             from(ptr<inner> i) : Inner{i} {}
         public:
             bool get(item &out, bool wait = true) {
-                return Inner->get(out, wait);
+                return Inner->get(&out, 1, wait) == 1;
             }
-            
+
+            // get up to max items, returning how many. If wait is true,
+            // this waits for at least one unless the channel is closed.
+            template <typename it>
+            size_t get_batch(it out, size_t max, bool wait = true) {
+                return Inner->get(out, max, wait);
+            }
+
             friend class channel;
+            friend class tool::select;
         };
-        
+
         to To;
         from From;
-        
+
     private:
         channel(ptr<inner> i) : To{i}, From{i} {}
-        
+
     public:
-        channel(uint32 size) : channel{std::make_shared<channel<item>::inner>(size)} {}
+        channel(uint32 size) : channel{std::make_shared<inner>(size)} {}
         channel() : channel{0} {}
         channel(const channel& c) : To{c.To}, From{c.From} {}
         channel(channel&& c) : To{c.To}, From{c.From} {
             c.To = to{};
             c.From = from{};
         }
-        
+
         void close() {
             To.close();
         }
-        
+
         bool closed() const {
             return To.closed();
         }
-        
+
         void put(const item &i) {
             To.put(i);
         }
+
+        template <typename it>
+        void put_batch(it begin, it end) {
+            To.put_batch(begin, end);
+        }
         
+        bool try_put(const item &i) {
+            return To.try_put(i);
+        }
+
         bool get(item &out, bool wait = true) {
             return From.get(out, wait);
         }
+
+        template <typename it>
+        size_t get_batch(it out, size_t max, bool wait = true) {
+            return From.get_batch(out, max, wait);
+        }
     };
 
+    template <class item, access a>
+    void channel<item, a>::inner::close() {
+        Closed.store(true);
+        {
+            std::lock_guard<std::mutex> lock{M};
+        }
+        Receive.notify_all();
+        Send.notify_all();
+        Selects.notify();
+    }
+
+    template <class item, access a>
+    inline bool channel<item, a>::inner::closed() const {
+        return Closed.load();
+    }
+
+    template <class item, access a>
+    template <typename it>
+    inline size_t channel<item, a>::inner::try_put(it begin, size_t n) {
+        if (Ring != nullptr) return Ring->try_push(begin, n);
+        std::lock_guard<std::mutex> lock{QueueMutex};
+        for (size_t i = 0; i < n; i++, ++begin) Queue.push_back(*begin);
+        return n;
+    }
+
+    template <class item, access a>
+    template <typename it>
+    inline size_t channel<item, a>::inner::try_get(it out, size_t n) {
+        if (Ring != nullptr) return Ring->try_pop(out, n);
+        std::lock_guard<std::mutex> lock{QueueMutex};
+        size_t m = std::min(n, Queue.size());
+        for (size_t i = 0; i < m; i++, ++out) {
+            *out = std::move(Queue.front());
+            Queue.pop_front();
+        }
+        return m;
+    }
+
+    template <class item, access a>
+    template <typename F>
+    bool channel<item, a>::inner::wait(std::atomic<uint32>& waiting, std::condition_variable& c, F f) {
+        // the other end is usually not far behind, so try a few times before sleeping.
+        for (int i = 0; i < 32; i++) {
+            if (f()) return true;
+            if (Closed.load()) return f();
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock{M};
+        waiting.fetch_add(1);
+        // pairs with the fence in wake, so that either we see what the
+        // other end has done or it sees that we are waiting.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool done;
+        while (true) {
+            if ((done = f())) break;
+            if (Closed.load()) {
+                done = f();
+                break;
+            }
+            c.wait(lock);
+        }
+        waiting.fetch_sub(1);
+        return done;
+    }
+
+    template <class item, access a>
+    inline void channel<item, a>::inner::wake(std::atomic<uint32>& waiting, std::condition_variable& c, bool all) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Selects.notify();
+        if (waiting.load(std::memory_order_relaxed) == 0) return;
+        {
+            // a waiting thread holds M until it is asleep.
+            std::lock_guard<std::mutex> lock{M};
+        }
+        if (all) c.notify_all();
+        else c.notify_one();
+    }
+
+    template <class item, access a>
+    template <typename it>
+    void channel<item, a>::inner::put(it begin, size_t n) {
+        while (n > 0) {
+            if (Closed.load()) throw std::logic_error("put to closed channel");
+            size_t m = 0;
+            if (!wait(Senders, Send, [this, &m, begin, n]() -> bool {
+                return (m = try_put(begin, n)) > 0;
+            })) throw std::logic_error("put to closed channel");
+            wake(Receivers, Receive, m > 1);
+            std::advance(begin, m);
+            n -= m;
+        }
+    }
+
+    template <class item, access a>
+    bool channel<item, a>::inner::try_put(const item* i) {
+        if (Closed.load() || try_put(i, 1) == 0) return false;
+        wake(Receivers, Receive, false);
+        return true;
+    }
+
+    template <class item, access a>
+    template <typename it>
+    size_t channel<item, a>::inner::get(it out, size_t n, bool block) {
+        size_t m = try_get(out, n);
+        if (m == 0 && block) wait(Receivers, Receive, [this, &m, out, n]() -> bool {
+            return (m = try_get(out, n)) > 0;
+        });
+        if (m > 0) wake(Senders, Send, m > 1);
+        return m;
+    }
+
 }
 
 #endif
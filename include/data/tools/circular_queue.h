@@ -5,29 +5,224 @@
 #ifndef DATA_CIRCULAR_QUEUE_H
 #define DATA_CIRCULAR_QUEUE_H
 
-#include <ostream>
+#include <atomic>
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace data::tools {
+
+        // what a circular_queue does when it is full.
+        enum class queue_mode {
+            // push fails.
+            reject,
+            // push drops the oldest element, as for a window of recent samples.
+            overwrite,
+            // push fails, and one thread may push while another pops.
+            spsc
+        };
+
+        // A ring buffer of elements of type T. If N is not zero, the capacity
+        // is N, which must be a power of two, and the elements are kept inside
+        // the queue. Otherwise the capacity is given to the constructor and
+        // the elements are allocated once when the queue is made.
+        template <typename T, size_t N = 0, queue_mode mode = queue_mode::reject>
         class circular_queue {
+            static_assert(N == 0 || (N & (N - 1)) == 0, "capacity must be a power of two");
+
+            using storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+            using elements = typename std::conditional<N == 0, std::unique_ptr<storage[]>, storage[N == 0 ? 1 : N]>::type;
+            using index = typename std::conditional<mode == queue_mode::spsc, std::atomic<size_t>, size_t>::type;
+
+            static constexpr size_t cache_line = 64;
+
+            const size_t m_capacity;
+            elements m_elements;
+
+            // the producer and the consumer of an spsc queue write
+            // to different indices, so they go on different lines.
+            alignas(cache_line) index m_tail;
+            alignas(cache_line) index m_head;
+
+            T* slot(size_t i) {
+                if constexpr (N == 0) return std::launder(reinterpret_cast<T*>(&m_elements[i % m_capacity]));
+                else return std::launder(reinterpret_cast<T*>(&m_elements[i & (N - 1)]));
+            }
+
+            const T* slot(size_t i) const {
+                return const_cast<circular_queue*>(this)->slot(i);
+            }
+
+            size_t load(const index& i, std::memory_order o) const {
+                if constexpr (mode == queue_mode::spsc) return i.load(o);
+                else return i;
+            }
+
+            void store(index& i, size_t x, std::memory_order o) {
+                if constexpr (mode == queue_mode::spsc) i.store(x, o);
+                else i = x;
+            }
+
         public:
-            // Initialize front and rear
-           int cur;
-
-            // Circular Queue
-            int size;
-            long *circularQueue;
-
-            explicit circular_queue (int sz, long init_value=0) {
-                cur = 0;
-                size = sz;
-                circularQueue = new long[sz];
-                std::fill(circularQueue,circularQueue+sz,init_value);
-            }
-            void setValue(long val);
-            void next();
-            long getValue();
+            template <size_t n = N, typename = typename std::enable_if<n != 0>::type>
+            circular_queue() : m_capacity(N), m_tail(0), m_head(0) {}
+
+            template <size_t n = N, typename = typename std::enable_if<n == 0>::type>
+            explicit circular_queue(size_t capacity) :
+                m_capacity(capacity == 0 ? 1 : capacity), m_elements(new storage[m_capacity]), m_tail(0), m_head(0) {}
+
+            ~circular_queue() {
+                clear();
+            }
+
+            circular_queue(const circular_queue&) = delete;
+            circular_queue& operator=(const circular_queue&) = delete;
+
+            size_t capacity() const {
+                return m_capacity;
+            }
+
+            size_t size() const {
+                return load(m_tail, std::memory_order_acquire) - load(m_head, std::memory_order_acquire);
+            }
+
+            bool empty() const {
+                return size() == 0;
+            }
+
+            bool full() const {
+                return size() == m_capacity;
+            }
+
+            // false if the queue is full, unless the mode is overwrite.
+            template <typename... P>
+            bool emplace(P&&... p) {
+                size_t tail = load(m_tail, std::memory_order_relaxed);
+                if (tail - load(m_head, std::memory_order_acquire) == m_capacity) {
+                    if constexpr (mode != queue_mode::overwrite) return false;
+                    else {
+                        slot(m_head)->~T();
+                        m_head++;
+                    }
+                }
+                new (slot(tail)) T(std::forward<P>(p)...);
+                store(m_tail, tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool push(const T& x) {
+                return emplace(x);
+            }
+
+            bool push(T&& x) {
+                return emplace(std::move(x));
+            }
+
+            // move the oldest element into x. False if there is none.
+            bool pop(T& x) {
+                size_t head = load(m_head, std::memory_order_relaxed);
+                if (load(m_tail, std::memory_order_acquire) == head) return false;
+                T* e = slot(head);
+                x = std::move(*e);
+                e->~T();
+                store(m_head, head + 1, std::memory_order_release);
+                return true;
+            }
+
+            void clear() {
+                size_t tail = load(m_tail, std::memory_order_acquire);
+                for (size_t i = load(m_head, std::memory_order_relaxed); i != tail; i++) slot(i)->~T();
+                store(m_head, tail, std::memory_order_release);
+            }
+
+            // The rest may not be used while another thread uses an spsc queue.
+
+            // the ith oldest element.
+            T& operator[](size_t i) {
+                return *slot(load(m_head, std::memory_order_relaxed) + i);
+            }
+
+            const T& operator[](size_t i) const {
+                return *slot(load(m_head, std::memory_order_relaxed) + i);
+            }
+
+            T& front() {
+                return (*this)[0];
+            }
+
+            const T& front() const {
+                return (*this)[0];
+            }
+
+            T& back() {
+                return (*this)[size() - 1];
+            }
+
+            const T& back() const {
+                return (*this)[size() - 1];
+            }
+
+            // iterates from the oldest element to the newest.
+            template <typename Q, typename X>
+            struct iterator_of {
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = X*;
+                using reference = X&;
+
+                Q* Queue;
+                size_t Index;
+
+                X& operator*() const {
+                    return (*Queue)[Index];
+                }
+
+                X* operator->() const {
+                    return &(*Queue)[Index];
+                }
+
+                iterator_of& operator++() {
+                    Index++;
+                    return *this;
+                }
+
+                iterator_of operator++(int) {
+                    iterator_of i = *this;
+                    Index++;
+                    return i;
+                }
+
+                bool operator==(const iterator_of& i) const {
+                    return Index == i.Index;
+                }
+
+                bool operator!=(const iterator_of& i) const {
+                    return Index != i.Index;
+                }
+            };
+
+            using iterator = iterator_of<circular_queue, T>;
+            using const_iterator = iterator_of<const circular_queue, const T>;
+
+            iterator begin() {
+                return iterator{this, 0};
+            }
+
+            iterator end() {
+                return iterator{this, size()};
+            }
+
+            const_iterator begin() const {
+                return const_iterator{this, 0};
+            }
+
+            const_iterator end() const {
+                return const_iterator{this, size()};
+            }
         };
     }
 #endif //DATA_CIRCULAR_QUEUE_H
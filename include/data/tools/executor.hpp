@@ -0,0 +1,375 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_EXECUTOR
+#define DATA_TOOLS_EXECUTOR
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <data/types.hpp>
+
+namespace data::tool {
+
+    // a piece of work that some thread will run once.
+    struct job {
+        void (*Run)(job*);
+        std::atomic<bool> Done;
+
+        job(void (*r)(job*)) : Run{r}, Done{false} {}
+
+        void run() {
+            Run(this);
+            Done.store(true, std::memory_order_release);
+        }
+    };
+
+    // a job that runs a function kept wherever the job is, and keeps what it throws.
+    template <typename F>
+    struct function_job : job {
+        F Function;
+        std::exception_ptr Error;
+
+        function_job(F f) : job{&function_job::execute}, Function{f}, Error{} {}
+
+        static void execute(job* j) {
+            function_job* f = static_cast<function_job*>(j);
+            try {
+                f->Function();
+            } catch (...) {
+                f->Error = std::current_exception();
+            }
+        }
+    };
+
+    // Chase and Lev's work-stealing deque, with the memory orders of Lê,
+    // Pop, Cohen and Zappa Nardelli. The owner pushes and takes at the
+    // bottom and other threads steal from the top. Arrays that have been
+    // outgrown are kept until the deque is destroyed, since a thief may
+    // still be reading one.
+    class work_deque {
+        struct array {
+            const int64 Size;
+            std::unique_ptr<std::atomic<job*>[]> Jobs;
+
+            array(int64 size) : Size{size}, Jobs{new std::atomic<job*>[size]} {}
+
+            job* get(int64 i) const {
+                return Jobs[i & (Size - 1)].load(std::memory_order_relaxed);
+            }
+
+            void put(int64 i, job* j) {
+                Jobs[i & (Size - 1)].store(j, std::memory_order_relaxed);
+            }
+        };
+
+        alignas(64) std::atomic<int64> Top;
+        alignas(64) std::atomic<int64> Bottom;
+        std::atomic<array*> Array;
+        std::vector<std::unique_ptr<array>> Arrays;
+
+        array* grow(array* a, int64 top, int64 bottom) {
+            Arrays.emplace_back(new array{a->Size * 2});
+            array* b = Arrays.back().get();
+            for (int64 i = top; i < bottom; i++) b->put(i, a->get(i));
+            Array.store(b, std::memory_order_release);
+            return b;
+        }
+
+    public:
+        work_deque() : Top{0}, Bottom{0}, Array{}, Arrays{} {
+            Arrays.emplace_back(new array{64});
+            Array.store(Arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        work_deque(const work_deque&) = delete;
+        work_deque& operator=(const work_deque&) = delete;
+
+        // only the owner may push.
+        void push(job* j) {
+            int64 b = Bottom.load(std::memory_order_relaxed);
+            int64 t = Top.load(std::memory_order_acquire);
+            array* a = Array.load(std::memory_order_relaxed);
+            if (b - t > a->Size - 1) a = grow(a, t, b);
+            a->put(b, j);
+            // the paper has a release fence and a relaxed store, 
+            // which is the same but is not understood by tsan. 
+            Bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // only the owner may take. Returns the job pushed most recently.
+        job* take() {
+            int64 b = Bottom.load(std::memory_order_relaxed) - 1;
+            array* a = Array.load(std::memory_order_relaxed);
+            Bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 t = Top.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                Bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            job* j = a->get(b);
+            if (t == b) {
+                // the last job, which a thief may be after as well.
+                if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) j = nullptr;
+                Bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return j;
+        }
+
+        // any thread may steal. Returns the job pushed longest ago,
+        // or nullptr if there is none or another thread got it first.
+        job* steal() {
+            int64 t = Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 b = Bottom.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+
+            array* a = Array.load(std::memory_order_acquire);
+            job* j = a->get(t);
+            if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+            return j;
+        }
+
+        bool empty() const {
+            return Bottom.load(std::memory_order_relaxed) <= Top.load(std::memory_order_relaxed);
+        }
+    };
+
+    // A pool of threads that share work by stealing it. Work is divided by
+    // join(a, b), which runs a itself and offers b to be stolen by an idle
+    // thread. A thread that waits for a stolen job steals other work in
+    // the meantime, so nothing blocks while there is work to do.
+    //
+    // Work from outside the pool enters through run, which hands its
+    // function to a worker and waits for it to finish.
+    class executor {
+        struct worker {
+            work_deque Deque;
+            std::minstd_rand Random;
+
+            worker(uint32 seed) : Deque{}, Random{seed} {}
+        };
+
+        std::vector<std::unique_ptr<worker>> Workers;
+        std::vector<std::thread> Threads;
+
+        // jobs from outside the pool.
+        std::mutex M;
+        std::condition_variable Wake;
+        std::vector<job*> Injected;
+        std::atomic<size_t> InjectedSize;
+        std::atomic<uint32> Sleeping;
+        std::atomic<bool> Stopped;
+
+        static worker*& current_worker() {
+            thread_local worker* Current{nullptr};
+            return Current;
+        }
+
+        static executor*& current_executor() {
+            thread_local executor* Current{nullptr};
+            return Current;
+        }
+
+        worker* current() const {
+            return current_executor() == this ? current_worker() : nullptr;
+        }
+
+        // wake a sleeping worker if there is one.
+        void notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (Sleeping.load(std::memory_order_relaxed) == 0) return;
+            {
+                std::lock_guard<std::mutex> lock{M};
+            }
+            Wake.notify_one();
+        }
+
+        job* find(worker* w) {
+            job* j = w->Deque.take();
+            if (j != nullptr) return j;
+            return steal(w);
+        }
+
+        // try every other worker once from a random place and then the injected jobs.
+        job* steal(worker* w) {
+            size_t n = Workers.size();
+            size_t start = w->Random() % n;
+            for (size_t i = 0; i < n; i++) {
+                worker* v = Workers[(start + i) % n].get();
+                if (v == w) continue;
+                job* j = v->Deque.steal();
+                if (j != nullptr) return j;
+            }
+
+            if (InjectedSize.load(std::memory_order_relaxed) == 0) return nullptr;
+            std::lock_guard<std::mutex> lock{M};
+            if (Injected.empty()) return nullptr;
+            job* j = Injected.back();
+            Injected.pop_back();
+            InjectedSize.store(Injected.size(), std::memory_order_relaxed);
+            return j;
+        }
+
+        bool idle() const {
+            if (!Injected.empty()) return false;
+            for (const auto& w : Workers) if (!w->Deque.empty()) return false;
+            return true;
+        }
+
+        void work(worker* w) {
+            current_worker() = w;
+            current_executor() = this;
+
+            while (true) {
+                job* j = nullptr;
+                for (int i = 0; i < 64 && j == nullptr; i++) {
+                    j = find(w);
+                    if (j == nullptr) std::this_thread::yield();
+                }
+
+                if (j != nullptr) {
+                    j->run();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{M};
+                Sleeping.fetch_add(1);
+                // pairs with the fence in notify.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!Stopped.load() && idle()) Wake.wait(lock);
+                Sleeping.fetch_sub(1);
+                if (Stopped.load()) return;
+            }
+        }
+
+    public:
+        explicit executor(uint32 threads = std::thread::hardware_concurrency()) :
+            Workers{}, Threads{}, M{}, Wake{}, Injected{}, InjectedSize{0}, Sleeping{0}, Stopped{false} {
+            if (threads == 0) threads = 1;
+            for (uint32 i = 0; i < threads; i++) Workers.emplace_back(new worker{i + 1});
+            for (uint32 i = 0; i < threads; i++) Threads.emplace_back([this, i]() {
+                work(Workers[i].get());
+            });
+        }
+
+        ~executor() {
+            {
+                std::lock_guard<std::mutex> lock{M};
+                Stopped.store(true);
+            }
+            Wake.notify_all();
+            for (std::thread& t : Threads) t.join();
+        }
+
+        executor(const executor&) = delete;
+        executor& operator=(const executor&) = delete;
+
+        uint32 size() const {
+            return static_cast<uint32>(Workers.size());
+        }
+
+        // a pool with a thread for each core.
+        static executor& standard() {
+            static executor Standard{};
+            return Standard;
+        }
+
+        // run f on the pool and wait for it.
+        template <typename F>
+        void run(F f) {
+            if (current() != nullptr) return f();
+
+            std::mutex m;
+            std::condition_variable c;
+            bool finished = false;
+
+            struct finish {
+                std::mutex& M;
+                std::condition_variable& C;
+                bool& Finished;
+
+                ~finish() {
+                    {
+                        std::lock_guard<std::mutex> lock{M};
+                        Finished = true;
+                    }
+                    C.notify_one();
+                }
+            };
+
+            auto g = [&f, &m, &c, &finished]() {
+                finish x{m, c, finished};
+                f();
+            };
+
+            function_job<decltype(g)> j{g};
+            {
+                std::lock_guard<std::mutex> lock{M};
+                Injected.push_back(&j);
+                InjectedSize.store(Injected.size(), std::memory_order_relaxed);
+            }
+            Wake.notify_one();
+
+            {
+                std::unique_lock<std::mutex> lock{m};
+                c.wait(lock, [&finished]() -> bool {
+                    return finished;
+                });
+            }
+
+            // the worker is about to let go of the job.
+            while (!j.Done.load(std::memory_order_acquire)) std::this_thread::yield();
+            if (j.Error) std::rethrow_exception(j.Error);
+        }
+
+        // run a and b, perhaps at the same time, and return when both are done.
+        template <typename A, typename B>
+        void join(A a, B b) {
+            worker* w = current();
+            if (w == nullptr) return run([this, &a, &b]() {
+                join(a, b);
+            });
+
+            function_job<B> j{b};
+            w->Deque.push(&j);
+            notify();
+
+            std::exception_ptr error{};
+            try {
+                a();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // j is taken back unless it has been stolen, in which
+            // case we do other work until the thief is finished.
+            while (!j.Done.load(std::memory_order_acquire)) {
+                job* k = w->Deque.take();
+                if (k == &j) {
+                    j.run();
+                    break;
+                }
+
+                if (k == nullptr) k = steal(w);
+                if (k != nullptr) k->run();
+                else std::this_thread::yield();
+            }
+
+            if (error) std::rethrow_exception(error);
+            if (j.Error) std::rethrow_exception(j.Error);
+        }
+    };
+
+}
+
+#endif
@@ -10,8 +10,13 @@
     
 namespace data::tool {
     
-    // functional queue based on Milewski's implementation of Okasaki. 
-    // it is built out of any stack. 
+    // real-time functional queue of Hood and Melville, as presented 
+    // by Okasaki. It is built out of any stack. The front stack is 
+    // rebuilt incrementally: a rotation that reverses the rear stack 
+    // onto the front is begun when the rear becomes longer than the 
+    // front, and every operation advances it by two steps. Thus first, 
+    // rest and append of a single element are O(1) in the worst case and 
+    // the queue is an ordinary value that can be shared between threads. 
     template <typename stack, 
         typename element = std::remove_reference_t<decltype(std::declval<stack>().first())>>
     struct functional_queue {
@@ -36,6 +41,9 @@ namespace data::tool {
         
         functional_queue append(const element e) const;
         functional_queue prepend(const element e) const;
+        
+        // O(|this| + |q|), since the first prepend to q finishes 
+        // the rotation that q is in the middle of. 
         functional_queue append(functional_queue q) const;
         
         template <typename X, typename Y, typename ... P>
@@ -54,27 +62,87 @@ namespace data::tool {
         template <typename A, typename ... M>
         static functional_queue make(const A x, M... m);
         
-        using const_iterator = typename stack::const_iterator;
+        // walks the queue by taking rest(), so every step is O(1). 
+        struct const_iterator {
+            const_iterator() : Queue{} {}
+            
+            const element& operator*() const {
+                return Queue.first();
+            }
+            
+            const_iterator& operator++() {
+                Queue = Queue.rest();
+                return *this;
+            }
+            
+            const_iterator operator++(int) {
+                const_iterator i = *this;
+                operator++();
+                return i;
+            }
+            
+            // iterators are only compared with those of the same queue. 
+            bool operator==(const const_iterator& i) const {
+                return Queue.size() == i.Queue.size();
+            }
+            
+            bool operator!=(const const_iterator& i) const {
+                return !operator==(i);
+            }
+            
+            int operator-(const const_iterator& i) const {
+                return static_cast<int>(i.Queue.size()) - static_cast<int>(Queue.size());
+            }
+            
+        private:
+            functional_queue Queue;
+            const_iterator(const functional_queue& q) : Queue{q} {}
+            
+            friend struct functional_queue;
+        };
         
-        const const_iterator begin() const {
-            return values().begin();
+        const_iterator begin() const {
+            return const_iterator{*this};
         }
         
-        const const_iterator end() const {
-            return values().end();
+        const_iterator end() const {
+            return const_iterator{};
         }
         
     private:
-        stack Left;
-        stack Right;
-
-        functional_queue(stack l, stack r);
+        // the state of a rotation in progress. The front is reversed 
+        // onto Reversed while the rear is reversed onto Rotated, and 
+        // then Reversed is moved back onto Rotated, which becomes the new 
+        // front. Valid counts how many elements of Reversed still 
+        // belong to the queue, since the front shrinks meanwhile. 
+        struct rotation {
+            enum phase {idle, reversing, appending, done};
+            
+            phase Phase;
+            int64 Valid;
+            stack Front;
+            stack Reversed;
+            stack Rear;
+            stack Rotated;
+            
+            rotation() : Phase{idle}, Valid{0}, Front{}, Reversed{}, Rear{}, Rotated{} {}
+            rotation(phase p, int64 v, stack f, stack x, stack r, stack y) : 
+                Phase{p}, Valid{v}, Front{f}, Reversed{x}, Rear{r}, Rotated{y} {}
+            
+            rotation step() const;
+            rotation invalidate() const;
+        };
         
-        static functional_queue check(const stack& l, const stack& r);
+        size_t FrontSize;
+        stack Front;
+        rotation Rotation;
+        size_t RearSize;
+        stack Rear;
         
-        const stack values() const {
-            return data::join(data::reverse(Right), data::reverse(Left));
-        }
+        functional_queue(size_t fs, stack f, rotation x, size_t rs, stack r);
+        
+        static functional_queue advance(size_t fs, stack f, rotation x, size_t rs, stack r);
+        static functional_queue check(size_t fs, stack f, rotation x, size_t rs, stack r);
     
     };
 
@@ -87,16 +155,58 @@ namespace data::tool {
 
 namespace data::tool {
     template <typename stack, typename element>
-    inline functional_queue<stack, element>::functional_queue(stack l, stack r) : Left{l}, Right{r} {}
+    typename functional_queue<stack, element>::rotation functional_queue<stack, element>::rotation::step() const {
+        switch (Phase) {
+            case reversing: 
+                if (!data::empty(Front)) 
+                    return {reversing, Valid + 1, Front.rest(), Reversed << Front.first(), Rear.rest(), Rotated << Rear.first()};
+                return {appending, Valid, stack{}, Reversed, stack{}, Rotated << Rear.first()};
+            case appending: 
+                if (Valid == 0) return {done, 0, stack{}, stack{}, stack{}, Rotated};
+                return {appending, Valid - 1, stack{}, Reversed.rest(), stack{}, Rotated << Reversed.first()};
+            default: 
+                return *this;
+        }
+    }
     
     template <typename stack, typename element>
-    inline functional_queue<stack, element>::functional_queue() : Left{}, Right{} {}
+    typename functional_queue<stack, element>::rotation functional_queue<stack, element>::rotation::invalidate() const {
+        switch (Phase) {
+            case reversing: 
+                return {reversing, Valid - 1, Front, Reversed, Rear, Rotated};
+            case appending: 
+                if (Valid == 0) return {done, 0, stack{}, stack{}, stack{}, Rotated.rest()};
+                return {appending, Valid - 1, stack{}, Reversed, stack{}, Rotated};
+            default: 
+                return *this;
+        }
+    }
+    
+    template <typename stack, typename element>
+    inline functional_queue<stack, element>::functional_queue(size_t fs, stack f, rotation x, size_t rs, stack r) : 
+        FrontSize{fs}, Front{f}, Rotation{x}, RearSize{rs}, Rear{r} {}
     
     template <typename stack, typename element>
-    inline functional_queue<stack, element>::functional_queue(const element& x) : Left{x}, Right{} {}
+    functional_queue<stack, element> functional_queue<stack, element>::advance(size_t fs, stack f, rotation x, size_t rs, stack r) {
+        rotation y = x.step().step();
+        if (y.Phase == rotation::done) return functional_queue{fs, y.Rotated, rotation{}, rs, r};
+        return functional_queue{fs, f, y, rs, r};
+    }
     
     template <typename stack, typename element>
-    inline functional_queue<stack, element>::functional_queue(stack l) : Left{l}, Right{} {}
+    functional_queue<stack, element> functional_queue<stack, element>::check(size_t fs, stack f, rotation x, size_t rs, stack r) {
+        if (rs <= fs) return advance(fs, f, x, rs, r);
+        return advance(fs + rs, f, rotation{rotation::reversing, 0, f, stack{}, r, stack{}}, 0, stack{});
+    }
+    
+    template <typename stack, typename element>
+    inline functional_queue<stack, element>::functional_queue() : FrontSize{0}, Front{}, Rotation{}, RearSize{0}, Rear{} {}
+    
+    template <typename stack, typename element>
+    inline functional_queue<stack, element>::functional_queue(const element& x) : functional_queue{stack{x}} {}
+    
+    template <typename stack, typename element>
+    inline functional_queue<stack, element>::functional_queue(stack l) : FrontSize{data::size(l)}, Front{l}, Rotation{}, RearSize{0}, Rear{} {}
     
     template <typename stack, typename element>
     template <typename X, typename Y, typename ... P>
@@ -105,64 +215,79 @@ namespace data::tool {
     
     template <typename stack, typename element>
     inline bool functional_queue<stack, element>::empty() const {
-        return data::empty(Left);
+        return FrontSize == 0;
     }
     
     template <typename stack, typename element>
     inline size_t functional_queue<stack, element>::size() const {
-        return data::size(Left) + data::size(Right);
+        return FrontSize + RearSize;
     }
     
     template <typename stack, typename element>
-    inline bool functional_queue<stack, element>::valid() const {
-        return Left.valid() && Right.valid();
+    bool functional_queue<stack, element>::valid() const {
+        for (const element& x : *this) if (!data::valid(x)) return false;
+        return true;
     }
     
     template <typename stack, typename element>
     inline const element& functional_queue<stack, element>::first() const {
-        return data::first(Left);
+        return data::first(Front);
     }
     
     template <typename stack, typename element>
     const element& functional_queue<stack, element>::operator[](uint32 i) {
         if (i >= size()) throw std::out_of_range("queue index");
-        uint32 left = Left.size();
-        if (i >= left) return Right[Right.size() - (i - left) - 1];
-        return Left[i];
-    }
-    
-    template <typename stack, typename element>
-    functional_queue<stack, element> functional_queue<stack, element>::check(const stack& l, const stack& r) {
-        if (l.empty()) {
-            if (!r.empty()) return functional_queue{data::reverse(r), stack{}};
-            return functional_queue{};
-        } else return functional_queue(l, r);
+        if (i >= FrontSize) return Rear[RearSize - (i - FrontSize) - 1];
+        auto x = begin();
+        for (; i > 0; i--) ++x;
+        return *x;
     }
     
     template <typename stack, typename element>
     inline functional_queue<stack, element> functional_queue<stack, element>::rest() const {
-        return check(Left.rest(), Right);
+        if (empty()) return {};
+        return check(FrontSize - 1, Front.rest(), Rotation.invalidate(), RearSize, Rear);
     }
     
     template <typename stack, typename element>
-    inline const element functional_queue<stack, element>::last() const {
-        return check(Right, Left).Left.first();
+    const element functional_queue<stack, element>::last() const {
+        if (RearSize != 0) return Rear.first();
+        auto x = begin();
+        for (size_t i = 1; i < FrontSize; i++) ++x;
+        return *x;
     }
     
     template <typename stack, typename element>
     inline functional_queue<stack, element> functional_queue<stack, element>::append(const element e) const {
-        return check(Left, Right << e);
+        return check(FrontSize, Front, Rotation, RearSize + 1, Rear << e);
     }
     
+    // A rotation in progress will replace the front, so it 
+    // must be finished before anything is put in front. 
     template <typename stack, typename element>
-    inline functional_queue<stack, element> functional_queue<stack, element>::prepend(const element e) const {
-        return check(Left << e, Right);
+    functional_queue<stack, element> functional_queue<stack, element>::prepend(const element e) const {
+        stack f = Front;
+        rotation x = Rotation;
+        while (x.Phase != rotation::idle && x.Phase != rotation::done) x = x.step();
+        if (x.Phase == rotation::done) f = x.Rotated;
+        return functional_queue{FrontSize + 1, f << e, rotation{}, RearSize, Rear};
     }
     
     template <typename stack, typename element>
-    inline functional_queue<stack, element> functional_queue<stack, element>::append(functional_queue q) const {
-        if (q.empty()) return *this;
-        return append(q.first()).append(q.rest());
+    functional_queue<stack, element> functional_queue<stack, element>::append(functional_queue q) const {
+        if (q.size() <= size()) {
+            functional_queue x = *this;
+            for (const element& e : q) x = x.append(e);
+            return x;
+        }
+        
+        stack r{};
+        for (const element& e : *this) r = r << e;
+        while (!data::empty(r)) {
+            q = q.prepend(r.first());
+            r = r.rest();
+        }
+        return q;
     }
     
     template <typename stack, typename element>
@@ -182,17 +307,22 @@ namespace data::tool {
     }
     
     template <typename stack, typename element>
-    inline functional_queue<stack, element> functional_queue<stack, element>::reverse() const {
-        return check(Right, Left);
+    functional_queue<stack, element> functional_queue<stack, element>::reverse() const {
+        stack r{};
+        for (const element& e : *this) r = r << e;
+        return functional_queue{r};
     }
     
     template <typename stack, typename element>
     bool functional_queue<stack, element>::operator==(const functional_queue& q) const {
         if (this == &q) return true;
         if (size() != q.size()) return false;
-        if (size() == 0) return true;
-        if (first() != q.first()) return false;
-        return rest() == q.rest();
+        auto a = q.begin();
+        for (const element& e : *this) {
+            if (e != *a) return false;
+            ++a;
+        }
+        return true;
     }
     
     template <typename stack, typename element>
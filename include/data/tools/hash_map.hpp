@@ -0,0 +1,539 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_HASH_MAP
+#define DATA_TOOLS_HASH_MAP
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <data/types.hpp>
+#include <data/iterable.hpp>
+#include <data/map.hpp>
+#include <data/tools/allocator.hpp>
+#include <data/tools/linked_stack.hpp>
+
+namespace data::tool {
+
+    // matches any section of bytes of fixed size, such as bytestring or uint.
+    template <size_t size> std::true_type is_byte_section(const section<byte, size>*);
+    std::false_type is_byte_section(const void*);
+
+    // the hash of a key, by default std::hash. A type can supply its own
+    // by defining hash_key in its namespace, as crypto::digest does.
+    template <typename K>
+    inline std::enable_if_t<!decltype(is_byte_section(std::declval<const K*>()))::value, uint64> hash_key(const K& k) {
+        return std::hash<K>{}(k);
+    }
+
+    inline uint64 hash_key(bytes_view b) {
+        return std::hash<string_view>{}(string_view{reinterpret_cast<const char*>(b.data()), b.size()});
+    }
+
+    inline uint64 hash_key(const bytes& b) {
+        return hash_key(bytes_view(b));
+    }
+
+    // all the bytes, since many fixed size types, such as big endian numbers, 
+    // start with bytes that hardly vary. crypto::digest uses its first eight. 
+    template <size_t size>
+    inline uint64 hash_key(const section<byte, size>& b) {
+        return hash_key(bytes_view{b.Data.data(), size});
+    }
+
+    template <typename K>
+    struct hash {
+        uint64 operator()(const K& k) const {
+            return hash_key(k);
+        }
+    };
+
+    // persistent unordered map as a hash array mapped trie (Bagwell), in
+    // the compressed form of Steindorfer and Vinju. Each node takes five
+    // bits of the hash and has one bitmap for the entries it holds and
+    // another for its subnodes, so that lookup compares keys only once
+    // the hashes match, and takes at most 13 steps. Keys whose hashes
+    // are entirely equal go together in a collision node at the bottom.
+    //
+    // Removal pulls a lone entry back up into its parent, so a map has
+    // the same shape however it was built.
+    template <typename K, typename V, typename hasher = hash<K>, typename alloc = shared_allocation>
+    struct hash_map {
+        using entry = data::entry<K, V>;
+
+    private:
+        static constexpr uint32 bits = 5;
+        static constexpr uint32 mask = (1 << bits) - 1;
+        static constexpr uint32 depth = 64;
+
+        struct item {
+            uint64 Hash;
+            K Key;
+            V Value;
+        };
+
+        struct node;
+        using link = typename alloc::template pointer<const node>;
+
+        struct node {
+            uint32 DataMap;
+            uint32 NodeMap;
+            std::vector<item> Items;
+            std::vector<link> Children;
+
+            bool singleton() const {
+                return Items.size() == 1 && Children.empty();
+            }
+        };
+
+        link Root;
+        size_t Size;
+
+        hash_map(link r, size_t x) : Root{r}, Size{x} {}
+
+        static uint32 bit(uint64 h, uint32 shift) {
+            return uint32(1) << ((h >> shift) & mask);
+        }
+
+        static uint32 index(uint32 map, uint32 b) {
+            return __builtin_popcount(map & (b - 1));
+        }
+
+        const item* find(uint64 h, const K& k) const;
+
+        static link make(node&& n) {
+            return alloc::template make<const node>(std::move(n));
+        }
+
+        static link merge(item&& a, item&& b, uint32 shift);
+        static link inserted(const node& n, uint32 shift, item&& x);
+        static link removed(const link& n, uint32 shift, uint64 h, const K& k);
+        static bool equal(const node* a, const node* b);
+
+    public:
+        const V& operator[](const K& k) const;
+        bool contains(const K& k) const;
+        bool contains(const entry& e) const;
+
+        hash_map insert(const K& k, const V& v) const;
+        hash_map insert(const entry& e) const;
+
+        hash_map operator<<(const entry& e) const;
+
+        hash_map remove(const K& k) const;
+        hash_map remove(const entry& e) const;
+
+        bool valid() const {
+            return values().valid();
+        }
+
+        bool empty() const;
+        size_t size() const;
+
+        hash_map() : Root{}, Size{0} {}
+        hash_map(const entry& e) : hash_map{hash_map{} << e} {}
+        hash_map(const K& k, const V& v) : hash_map{entry{k, v}} {}
+
+        hash_map(std::initializer_list<std::pair<K, V>> init);
+
+        // Set operations. Where both maps have a
+        // key, the value is taken from *this.
+        hash_map unite(const hash_map&) const;
+        hash_map intersect(const hash_map&) const;
+        hash_map subtract(const hash_map&) const;
+
+        // keys and entries in the order of their hashes.
+        const linked_stack<K> keys() const;
+        const linked_stack<entry> values() const;
+
+        bool operator==(const hash_map& map) const;
+
+        bool operator!=(const hash_map& map) const {
+            return !(*this == map);
+        }
+
+        // iterates over the entries in the order of their hashes.
+        struct const_iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = entry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const entry*;
+            using reference = const entry;
+
+            const_iterator() : Root{}, Depth{0}, Stack{} {}
+
+            const entry operator*() const {
+                const item& i = Stack[Depth - 1].Node->Items[Stack[Depth - 1].Item];
+                return entry{i.Key, i.Value};
+            }
+
+            const_iterator& operator++();
+
+            const_iterator operator++(int) {
+                const_iterator i = *this;
+                ++(*this);
+                return i;
+            }
+
+            bool operator==(const const_iterator& i) const {
+                if (Depth != i.Depth) return false;
+                return Depth == 0 || (Stack[Depth - 1].Node == i.Stack[Depth - 1].Node &&
+                    Stack[Depth - 1].Item == i.Stack[Depth - 1].Item);
+            }
+
+            bool operator!=(const const_iterator& i) const {
+                return !(*this == i);
+            }
+
+        private:
+            struct frame {
+                const node* Node;
+                uint32 Item;
+                uint32 Child;
+            };
+
+            link Root;
+            uint32 Depth;
+            // one frame for each level and one for a collision node.
+            std::array<frame, depth / bits + 2> Stack;
+
+            const_iterator(link r);
+
+            // go down to the next item from the top frame.
+            void settle();
+
+            friend struct hash_map;
+        };
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    };
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline std::ostream& operator<<(std::ostream& o, const hash_map<K, V, hasher, alloc>& x) {
+        return functional::stack::write(o << "map", x.values());
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc>::hash_map(std::initializer_list<std::pair<K, V>> init) : hash_map{} {
+        for (const auto& p : init) *this = insert(p.first, p.second);
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    const typename hash_map<K, V, hasher, alloc>::item* hash_map<K, V, hasher, alloc>::find(uint64 h, const K& k) const {
+        const node* n = Root.get();
+        uint32 shift = 0;
+        while (n != nullptr) {
+            if (shift >= depth) {
+                for (const item& i : n->Items) if (i.Key == k) return &i;
+                return nullptr;
+            }
+
+            uint32 b = bit(h, shift);
+            if (n->DataMap & b) {
+                const item& i = n->Items[index(n->DataMap, b)];
+                return i.Hash == h && i.Key == k ? &i : nullptr;
+            }
+
+            if (!(n->NodeMap & b)) return nullptr;
+            n = n->Children[index(n->NodeMap, b)].get();
+            shift += bits;
+        }
+        return nullptr;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    typename hash_map<K, V, hasher, alloc>::link hash_map<K, V, hasher, alloc>::merge(item&& a, item&& b, uint32 shift) {
+        if (shift >= depth) {
+            node n{0, 0, {}, {}};
+            n.Items.reserve(2);
+            n.Items.push_back(std::move(a));
+            n.Items.push_back(std::move(b));
+            return make(std::move(n));
+        }
+
+        uint32 ba = bit(a.Hash, shift);
+        uint32 bb = bit(b.Hash, shift);
+        if (ba == bb) {
+            node n{0, ba, {}, {}};
+            n.Children.push_back(merge(std::move(a), std::move(b), shift + bits));
+            return make(std::move(n));
+        }
+
+        node n{ba | bb, 0, {}, {}};
+        n.Items.reserve(2);
+        if (ba < bb) {
+            n.Items.push_back(std::move(a));
+            n.Items.push_back(std::move(b));
+        } else {
+            n.Items.push_back(std::move(b));
+            n.Items.push_back(std::move(a));
+        }
+        return make(std::move(n));
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    typename hash_map<K, V, hasher, alloc>::link hash_map<K, V, hasher, alloc>::inserted(const node& n, uint32 shift, item&& x) {
+        node m = n;
+
+        if (shift >= depth) {
+            for (item& i : m.Items) if (i.Key == x.Key) {
+                i = std::move(x);
+                return make(std::move(m));
+            }
+            m.Items.push_back(std::move(x));
+            return make(std::move(m));
+        }
+
+        uint32 b = bit(x.Hash, shift);
+        if (m.DataMap & b) {
+            uint32 i = index(m.DataMap, b);
+            if (m.Items[i].Hash == x.Hash && m.Items[i].Key == x.Key) {
+                m.Items[i] = std::move(x);
+                return make(std::move(m));
+            }
+
+            // two entries in the same place go down into a new node.
+            link child = merge(std::move(m.Items[i]), std::move(x), shift + bits);
+            m.Items.erase(m.Items.begin() + i);
+            m.DataMap ^= b;
+            m.NodeMap |= b;
+            m.Children.insert(m.Children.begin() + index(m.NodeMap, b), child);
+            return make(std::move(m));
+        }
+
+        if (m.NodeMap & b) {
+            link& child = m.Children[index(m.NodeMap, b)];
+            child = inserted(*child, shift + bits, std::move(x));
+            return make(std::move(m));
+        }
+
+        m.DataMap |= b;
+        m.Items.insert(m.Items.begin() + index(m.DataMap, b), std::move(x));
+        return make(std::move(m));
+    }
+
+    // the new node, or an empty link if nothing is left.
+    template <typename K, typename V, typename hasher, typename alloc>
+    typename hash_map<K, V, hasher, alloc>::link hash_map<K, V, hasher, alloc>::removed(
+        const link& n, uint32 shift, uint64 h, const K& k) {
+
+        if (shift >= depth) {
+            if (n->Items.size() == 1) return link{};
+            node m = *n;
+            for (auto i = m.Items.begin(); i != m.Items.end(); i++) if (i->Key == k) {
+                m.Items.erase(i);
+                break;
+            }
+            return make(std::move(m));
+        }
+
+        uint32 b = bit(h, shift);
+        if (n->DataMap & b) {
+            if (n->Items.size() == 1 && n->Children.empty()) return link{};
+            node m = *n;
+            m.Items.erase(m.Items.begin() + index(m.DataMap, b));
+            m.DataMap ^= b;
+            return make(std::move(m));
+        }
+
+        uint32 c = index(n->NodeMap, b);
+        link child = removed(n->Children[c], shift + bits, h, k);
+        node m = *n;
+        if (child->singleton()) {
+            // the last entry of a subnode moves up into this one.
+            m.Children.erase(m.Children.begin() + c);
+            m.NodeMap ^= b;
+            m.DataMap |= b;
+            m.Items.insert(m.Items.begin() + index(m.DataMap, b), child->Items[0]);
+        } else m.Children[c] = child;
+        return make(std::move(m));
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    bool hash_map<K, V, hasher, alloc>::equal(const node* a, const node* b) {
+        if (a == b) return true;
+        if (a->DataMap != b->DataMap || a->NodeMap != b->NodeMap ||
+            a->Items.size() != b->Items.size() || a->Children.size() != b->Children.size()) return false;
+
+        if (a->DataMap == 0 && a->NodeMap == 0) {
+            // a collision node, whose entries may be in any order.
+            for (const item& i : a->Items) {
+                auto j = std::find_if(b->Items.begin(), b->Items.end(), [&i](const item& j) -> bool {
+                    return i.Key == j.Key;
+                });
+                if (j == b->Items.end() || !(i.Value == j->Value)) return false;
+            }
+            return true;
+        }
+
+        for (size_t i = 0; i < a->Items.size(); i++)
+            if (a->Items[i].Hash != b->Items[i].Hash ||
+                !(a->Items[i].Key == b->Items[i].Key) ||
+                !(a->Items[i].Value == b->Items[i].Value)) return false;
+
+        for (size_t i = 0; i < a->Children.size(); i++)
+            if (!equal(a->Children[i].get(), b->Children[i].get())) return false;
+
+        return true;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline const V& hash_map<K, V, hasher, alloc>::operator[](const K& k) const {
+        static V Default{};
+        const item* i = find(hasher{}(k), k);
+        return i == nullptr ? Default : i->Value;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline bool hash_map<K, V, hasher, alloc>::contains(const K& k) const {
+        return find(hasher{}(k), k) != nullptr;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline bool hash_map<K, V, hasher, alloc>::contains(const entry& e) const {
+        const item* i = find(hasher{}(e.Key), e.Key);
+        return i != nullptr && i->Value == e.Value;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::insert(const K& k, const V& v) const {
+        uint64 h = hasher{}(k);
+        if (Root == nullptr) return hash_map{make(node{bit(h, 0), 0, {item{h, k, v}}, {}}), 1};
+        const item* i = find(h, k);
+        if (i != nullptr && i->Value == v) return *this;
+        return hash_map{inserted(*Root, 0, item{h, k, v}), i == nullptr ? Size + 1 : Size};
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::insert(const entry& e) const {
+        return insert(e.Key, e.Value);
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::operator<<(const entry& e) const {
+        return insert(e.Key, e.Value);
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::remove(const K& k) const {
+        uint64 h = hasher{}(k);
+        if (find(h, k) == nullptr) return *this;
+        return hash_map{removed(Root, 0, h, k), Size - 1};
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::remove(const entry& e) const {
+        return contains(e) ? remove(e.Key) : *this;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline bool hash_map<K, V, hasher, alloc>::empty() const {
+        return Size == 0;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline size_t hash_map<K, V, hasher, alloc>::size() const {
+        return Size;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::unite(const hash_map& m) const {
+        if (Size >= m.Size) {
+            hash_map x = *this;
+            for (const entry& e : m) if (!x.contains(e.Key)) x = x.insert(e);
+            return x;
+        }
+
+        hash_map x = m;
+        for (const entry& e : *this) x = x.insert(e);
+        return x;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::intersect(const hash_map& m) const {
+        hash_map x{};
+        if (Size <= m.Size) {
+            for (const entry& e : *this) if (m.contains(e.Key)) x = x.insert(e);
+        } else for (const entry& e : m) {
+            const item* i = find(hasher{}(e.Key), e.Key);
+            if (i != nullptr) x = x.insert(i->Key, i->Value);
+        }
+        return x;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc> hash_map<K, V, hasher, alloc>::subtract(const hash_map& m) const {
+        hash_map x = *this;
+        if (m.Size <= Size) {
+            for (const entry& e : m) x = x.remove(e.Key);
+        } else for (const entry& e : *this) if (m.contains(e.Key)) x = x.remove(e.Key);
+        return x;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    const linked_stack<K> hash_map<K, V, hasher, alloc>::keys() const {
+        linked_stack<K> kk{};
+        for (const entry& e : *this) kk = kk << e.Key;
+        return functional::stack::reverse(kk);
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    const linked_stack<entry<K, V>> hash_map<K, V, hasher, alloc>::values() const {
+        linked_stack<entry> kk{};
+        for (const entry& e : *this) kk = kk << e;
+        return functional::stack::reverse(kk);
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    bool hash_map<K, V, hasher, alloc>::operator==(const hash_map& map) const {
+        if (Size != map.Size) return false;
+        if (Size == 0) return true;
+        return equal(Root.get(), map.Root.get());
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    hash_map<K, V, hasher, alloc>::const_iterator::const_iterator(link r) : Root{r}, Depth{0}, Stack{} {
+        if (Root == nullptr) return;
+        Stack[0] = frame{Root.get(), 0, 0};
+        Depth = 1;
+        settle();
+    }
+
+    // the items of a node come before those of its children.
+    template <typename K, typename V, typename hasher, typename alloc>
+    void hash_map<K, V, hasher, alloc>::const_iterator::settle() {
+        while (Depth > 0) {
+            frame& f = Stack[Depth - 1];
+            if (f.Item < f.Node->Items.size()) return;
+            if (f.Child < f.Node->Children.size()) {
+                const node* n = f.Node->Children[f.Child++].get();
+                Stack[Depth++] = frame{n, 0, 0};
+            } else Depth--;
+        }
+        Root = link{};
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    typename hash_map<K, V, hasher, alloc>::const_iterator& hash_map<K, V, hasher, alloc>::const_iterator::operator++() {
+        if (Depth == 0) return *this;
+        Stack[Depth - 1].Item++;
+        settle();
+        return *this;
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline typename hash_map<K, V, hasher, alloc>::const_iterator hash_map<K, V, hasher, alloc>::begin() const {
+        return const_iterator{Root};
+    }
+
+    template <typename K, typename V, typename hasher, typename alloc>
+    inline typename hash_map<K, V, hasher, alloc>::const_iterator hash_map<K, V, hasher, alloc>::end() const {
+        return const_iterator{};
+    }
+
+}
+
+#endif
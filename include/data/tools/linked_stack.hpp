@@ -8,22 +8,35 @@
 #include <ostream>
 #include <data/list.hpp>
 #include <data/functional/stack.hpp>
+#include <data/tools/allocator.hpp>
     
 namespace data::tool {
-    template <typename elem>
+    // alloc is one of the policies in data/tools/allocator.hpp.
+    template <typename elem, typename alloc = shared_allocation>
     class linked_stack {
         
         using node = functional::stack_node<elem, linked_stack>;
-        using next = ptr<node>;
+        using next = typename alloc::template pointer<node>;
         
         next Next;
         linked_stack(next n);
         
+        template <typename, typename> friend class linked_stack;
+        
     public:
         linked_stack();
         linked_stack(const elem& e, const linked_stack& l);
         linked_stack(const elem& e);
         
+        linked_stack(const linked_stack&) = default;
+        linked_stack(linked_stack&&) = default;
+        linked_stack& operator=(const linked_stack&) = default;
+        linked_stack& operator=(linked_stack&&) = default;
+        
+        // releases nodes in a loop so that dropping
+        // a long list does not overflow the stack. 
+        ~linked_stack();
+        
         template<typename ... P>
         linked_stack(const elem& a, const elem& b, P... p);
         
@@ -71,153 +84,166 @@ namespace data::tool {
         const_iterator end() const;
 
         template <typename X> 
-        bool operator==(const data::tool::linked_stack<X>& x) const {
-            if ((void*)(Next.get()) == (void*)(x.Next.get())) return true;
+        bool operator==(const data::tool::linked_stack<X, alloc>& x) const {
             if (size() != x.size()) return false;
-            if (empty()) return true;
-            if (first() != x.first()) return false;
-            return (rest() == x.rest());
+            auto a = Next.get();
+            auto b = x.Next.get();
+            while ((void*)(a) != (void*)(b)) {
+                if (a->First != b->First) return false;
+                a = a->Rest.Next.get();
+                b = b->Rest.Next.get();
+            }
+            return true;
         }
 
         template <typename X> 
-        bool operator!=(const data::tool::linked_stack<X>& x) const {
+        bool operator!=(const data::tool::linked_stack<X, alloc>& x) const {
             return !(*this == x);
         }
         
     };
     
-    template <typename elem> inline std::ostream& operator<<(std::ostream& o, const linked_stack<elem>& x) {
+    template <typename elem, typename alloc> inline std::ostream& operator<<(std::ostream& o, const linked_stack<elem, alloc>& x) {
         return functional::stack::write(o << "stack", x);
     }
 
-    template <typename elem>
-    inline linked_stack<elem>::linked_stack(next n) : Next{n} {}
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc>::linked_stack(next n) : Next{n} {}
+    
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc>::linked_stack() : Next{nullptr} {}
     
-    template <typename elem>
-    inline linked_stack<elem>::linked_stack() : Next{nullptr} {}
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc>::linked_stack(const elem& e, const linked_stack& l) : linked_stack{alloc::template make<node>(e, l)} {}
     
-    template <typename elem>
-    inline linked_stack<elem>::linked_stack(const elem& e, const linked_stack& l) : linked_stack{std::make_shared<node>(e, l)} {}
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc>::linked_stack(const elem& e) : linked_stack{e, linked_stack{}} {}
     
-    template <typename elem>
-    inline linked_stack<elem>::linked_stack(const elem& e) : linked_stack{e, linked_stack{}} {}
+    template <typename elem, typename alloc>
+    linked_stack<elem, alloc>::~linked_stack() {
+        // once a node is shared, the rest of the list is kept by someone else. 
+        while (Next != nullptr && Next.use_count() == 1) {
+            next n = std::move(Next->Rest.Next);
+            Next = std::move(n);
+        }
+    }
     
-    template <typename elem>
+    template <typename elem, typename alloc>
     template <typename ... P>
-    inline linked_stack<elem>::linked_stack(const elem& a, const elem& b, P... p) : 
+    inline linked_stack<elem, alloc>::linked_stack(const elem& a, const elem& b, P... p) : 
         linked_stack{a, linked_stack{b, linked_stack{p...}}} {} 
     
     // if the list is empty, then this function
     // will dereference a nullptr. It is your
     // responsibility to check. 
-    template <typename elem>
-    inline const elem& linked_stack<elem>::first() const {
+    template <typename elem, typename alloc>
+    inline const elem& linked_stack<elem, alloc>::first() const {
         return Next->First;
     }
     
-    template <typename elem>
-    inline elem& linked_stack<elem>::first() {
+    template <typename elem, typename alloc>
+    inline elem& linked_stack<elem, alloc>::first() {
         return Next->First;
     }
     
-    template <typename elem>
-    inline bool linked_stack<elem>::empty() const {
+    template <typename elem, typename alloc>
+    inline bool linked_stack<elem, alloc>::empty() const {
         return Next == nullptr;
     }
     
-    template <typename elem>
-    inline linked_stack<elem> linked_stack<elem>::rest() const {
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc> linked_stack<elem, alloc>::rest() const {
         if (empty()) return {};
         
         return Next->rest();
     }
     
-    template <typename elem>
-    inline bool linked_stack<elem>::valid() const {
-        if (empty()) return true;
-        if (!data::valid(first())) return false;
-        return rest().valid();
+    template <typename elem, typename alloc>
+    bool linked_stack<elem, alloc>::valid() const {
+        for (auto n = Next.get(); n != nullptr; n = n->Rest.Next.get()) if (!data::valid(n->First)) return false;
+        return true;
     }
     
-    template <typename elem>
-    inline bool linked_stack<elem>::contains(elem x) const {
-        if (empty()) return false;
-            
-        Next->contains(x);
+    template <typename elem, typename alloc>
+    bool linked_stack<elem, alloc>::contains(elem x) const {
+        for (auto n = Next.get(); n != nullptr; n = n->Rest.Next.get()) if (n->First == x) return true;
+        return false;
     }
     
-    template <typename elem>
-    inline size_t linked_stack<elem>::size() const {
+    template <typename elem, typename alloc>
+    inline size_t linked_stack<elem, alloc>::size() const {
         if (empty()) return 0;
             
         return Next->size();
     }
     
-    template <typename elem>
-    inline linked_stack<elem> linked_stack<elem>::operator<<(elem x) const {
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc> linked_stack<elem, alloc>::operator<<(elem x) const {
         return {x, *this};
     }
     
-    template <typename elem>
-    inline linked_stack<elem> linked_stack<elem>::prepend(elem x) const {
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc> linked_stack<elem, alloc>::prepend(elem x) const {
         return {x, *this};
     }
     
-    template <typename elem>
-    inline linked_stack<elem>& linked_stack<elem>::operator<<=(elem x) {
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc>& linked_stack<elem, alloc>::operator<<=(elem x) {
         return operator=(prepend(x));
     }
     
-    template <typename elem>
-    linked_stack<elem> linked_stack<elem>::prepend(linked_stack l) const {
+    template <typename elem, typename alloc>
+    linked_stack<elem, alloc> linked_stack<elem, alloc>::prepend(linked_stack l) const {
         linked_stack x = *this;
         while (!l.empty()) {
-            x = x + l.first();
+            x = x.prepend(l.first());
             l = l.rest();
         }
         return x;
     }
     
-    template <typename elem>
+    template <typename elem, typename alloc>
     template <typename X, typename Y, typename ... P>
-    inline linked_stack<elem> linked_stack<elem>::prepend(X x, Y y, P ... p) const {
+    inline linked_stack<elem, alloc> linked_stack<elem, alloc>::prepend(X x, Y y, P ... p) const {
         return prepend(x).prepend(y, p...);
     }
     
-    template <typename elem>
-    inline linked_stack<elem> linked_stack<elem>::operator^(linked_stack l) const {
+    template <typename elem, typename alloc>
+    inline linked_stack<elem, alloc> linked_stack<elem, alloc>::operator^(linked_stack l) const {
         return prepend(l);
     }
     
-    template <typename elem>
-    linked_stack<elem> linked_stack<elem>::from(uint32 n) const {
-        if (empty()) return {};
-        if (n == 0) return *this;
-        return rest().from(n - 1);
+    template <typename elem, typename alloc>
+    linked_stack<elem, alloc> linked_stack<elem, alloc>::from(uint32 n) const {
+        const next* x = &Next;
+        for (; n > 0 && *x != nullptr; n--) x = &(*x)->Rest.Next;
+        return linked_stack{*x};
     }
     
-    template <typename elem>
-    inline const elem& linked_stack<elem>::operator[](uint32 n) const {
-        return from(n).first();
+    template <typename elem, typename alloc>
+    inline const elem& linked_stack<elem, alloc>::operator[](uint32 n) const {
+        auto x = Next.get();
+        for (; n > 0; n--) x = x->Rest.Next.get();
+        return x->First;
     }
     
-    template <typename elem>
-    inline typename linked_stack<elem>::iterator linked_stack<elem>::begin() {
+    template <typename elem, typename alloc>
+    inline typename linked_stack<elem, alloc>::iterator linked_stack<elem, alloc>::begin() {
         return iterator{Next};
     }
     
-    template <typename elem>
-    inline typename linked_stack<elem>::iterator linked_stack<elem>::end() {
+    template <typename elem, typename alloc>
+    inline typename linked_stack<elem, alloc>::iterator linked_stack<elem, alloc>::end() {
         return iterator{size()};
     }
     
-    template <typename elem>
-    inline typename linked_stack<elem>::const_iterator linked_stack<elem>::begin() const {
+    template <typename elem, typename alloc>
+    inline typename linked_stack<elem, alloc>::const_iterator linked_stack<elem, alloc>::begin() const {
         return const_iterator{Next};
     }
     
-    template <typename elem>
-    inline typename linked_stack<elem>::const_iterator linked_stack<elem>::end() const {
+    template <typename elem, typename alloc>
+    inline typename linked_stack<elem, alloc>::const_iterator linked_stack<elem, alloc>::end() const {
         return const_iterator{size()};
     }
 
@@ -10,11 +10,12 @@
     
 namespace data::tool {
 
-    template <typename value>
+    // alloc is one of the policies in data/tools/allocator.hpp.
+    template <typename value, typename alloc = shared_allocation>
     struct linked_tree {
         
         using node = functional::tree::node<value, linked_tree>;
-        using next = ptr<node>;
+        using next = typename alloc::template pointer<node>;
         
         next Node;
         size_t Size;
@@ -41,7 +42,7 @@ namespace data::tool {
         linked_tree& operator=(const linked_tree& t);
         
         template <typename X> 
-        bool operator==(const data::tool::linked_tree<X>& x) const {
+        bool operator==(const data::tool::linked_tree<X, alloc>& x) const {
             if (Node == x.Node) return true;
             if (Node == nullptr || x.Node == nullptr) return false;
             if (root() != x.root()) return false;
@@ -50,13 +51,13 @@ namespace data::tool {
         }
         
         template <typename X> 
-        bool operator!=(const data::tool::linked_tree<X>& x) const {
+        bool operator!=(const data::tool::linked_tree<X, alloc>& x) const {
             return ! (*this == x);
         }
         
         template <typename val>
         struct tree_iterator {
-            linked_stack<linked_tree> Branches;
+            linked_stack<linked_tree, alloc> Branches;
             linked_tree Current;
             tree_iterator() : Branches{}, Current{} {}
             tree_iterator(linked_tree t) : Branches{}, Current{t} {}
@@ -67,7 +68,7 @@ namespace data::tool {
             bool operator==(tree_iterator) const;
             bool operator!=(tree_iterator) const;
         private:
-            tree_iterator(linked_stack<linked_tree> b, linked_tree c) : Branches{b}, Current{c} {}
+            tree_iterator(linked_stack<linked_tree, alloc> b, linked_tree c) : Branches{b}, Current{c} {}
         };
         
         using iterator = tree_iterator<value>;
@@ -84,115 +85,115 @@ namespace data::tool {
         std::ostream& write(std::ostream& o) const;
     };
 
-    template <typename X> 
-    inline std::ostream& operator<<(std::ostream& o, const linked_tree<X>& x) {
+    template <typename X, typename alloc> 
+    inline std::ostream& operator<<(std::ostream& o, const linked_tree<X, alloc>& x) {
         return x.write(o << "tree");
     }
     
-    template <typename value>
-    inline bool linked_tree<value>::empty() const {
+    template <typename value, typename alloc>
+    inline bool linked_tree<value, alloc>::empty() const {
         return Node == nullptr;
     }
     
-    template <typename value>
-    inline const value& linked_tree<value>::root() const {
+    template <typename value, typename alloc>
+    inline const value& linked_tree<value, alloc>::root() const {
         return Node->Value;
     }
     
-    template <typename value>
-    inline linked_tree<value> linked_tree<value>::left() const {
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc> linked_tree<value, alloc>::left() const {
         return Node == nullptr ? linked_tree{} : Node->Left;
     } 
     
-    template <typename value>
-    inline linked_tree<value> linked_tree<value>::right() const {
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc> linked_tree<value, alloc>::right() const {
         return Node == nullptr ? linked_tree{} : Node->Right;
     }
     
-    template <typename value>
-    bool linked_tree<value>::contains(const value& v) const {
+    template <typename value, typename alloc>
+    bool linked_tree<value, alloc>::contains(const value& v) const {
         if (Node == nullptr) return false;
         if (Node->Value == v) return true;
         if (Node->Left.contains(v)) return true;
         return Node->Right.contains(v);
     }
     
-    template <typename value>
-    inline size_t linked_tree<value>::size() const {
+    template <typename value, typename alloc>
+    inline size_t linked_tree<value, alloc>::size() const {
         return Size;
     }
     
-    template <typename value>
-    inline linked_tree<value>::linked_tree() : Node{nullptr}, Size{0} {}
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc>::linked_tree() : Node{nullptr}, Size{0} {}
     
-    template <typename value>
-    inline linked_tree<value>::linked_tree(const value& v, linked_tree l, linked_tree r) : 
-        Node{std::make_shared<node>(v, l, r)}, Size{1 + l.size() + r.size()} {}
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc>::linked_tree(const value& v, linked_tree l, linked_tree r) : 
+        Node{alloc::template make<node>(v, l, r)}, Size{1 + l.size() + r.size()} {}
     
-    template <typename value>
-    inline linked_tree<value>::linked_tree(const value& v) : linked_tree{v, linked_tree{}, linked_tree{}} {}
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc>::linked_tree(const value& v) : linked_tree{v, linked_tree{}, linked_tree{}} {}
     
-    template <typename value>
-    inline linked_stack<value> linked_tree<value>::values() const {
+    template <typename value, typename alloc>
+    inline linked_stack<value> linked_tree<value, alloc>::values() const {
         linked_stack<value> vals{};
         for (auto x = begin(); x != end(); ++x) vals = vals << *x;
         return data::reverse(vals);
     }
     
-    template <typename value>
-    inline typename linked_tree<value>::iterator linked_tree<value>::begin() {
+    template <typename value, typename alloc>
+    inline typename linked_tree<value, alloc>::iterator linked_tree<value, alloc>::begin() {
         return iterator{*this};
     } 
     
-    template <typename value>
-    inline typename linked_tree<value>::iterator linked_tree<value>::end() {
+    template <typename value, typename alloc>
+    inline typename linked_tree<value, alloc>::iterator linked_tree<value, alloc>::end() {
         return iterator{};
     }
     
-    template <typename value>
-    inline typename linked_tree<value>::const_iterator linked_tree<value>::begin() const {
+    template <typename value, typename alloc>
+    inline typename linked_tree<value, alloc>::const_iterator linked_tree<value, alloc>::begin() const {
         return const_iterator{*this};
     } 
     
-    template <typename value>
-    inline typename linked_tree<value>::const_iterator linked_tree<value>::end() const {
+    template <typename value, typename alloc>
+    inline typename linked_tree<value, alloc>::const_iterator linked_tree<value, alloc>::end() const {
         return const_iterator{};
     }
     
-    template <typename value>
-    inline linked_tree<value>::linked_tree(const linked_tree& t) {
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc>::linked_tree(const linked_tree& t) {
         Node = t.Node;
         Size = t.Size;
     }
     
-    template <typename value>
-    inline linked_tree<value>& linked_tree<value>::operator=(const linked_tree& t) {
+    template <typename value, typename alloc>
+    inline linked_tree<value, alloc>& linked_tree<value, alloc>::operator=(const linked_tree& t) {
         Node = t.Node;
         Size = t.Size;
         return *this;
     }
     
-    template <typename value>
+    template <typename value, typename alloc>
     template <typename val>
-    inline val linked_tree<value>::tree_iterator<val>::operator*() const {
+    inline val linked_tree<value, alloc>::tree_iterator<val>::operator*() const {
         return Current.root();
     }
     
-    template <typename value>
+    template <typename value, typename alloc>
     template <typename val>
-    inline bool linked_tree<value>::tree_iterator<val>::operator==(tree_iterator i) const {
+    inline bool linked_tree<value, alloc>::tree_iterator<val>::operator==(tree_iterator i) const {
         return Current == i.Current && Branches == i.Branches;
     }
     
-    template <typename value>
+    template <typename value, typename alloc>
     template <typename val>
-    inline bool linked_tree<value>::tree_iterator<val>::operator!=(tree_iterator i) const {
+    inline bool linked_tree<value, alloc>::tree_iterator<val>::operator!=(tree_iterator i) const {
         return !(*this == i);
     }
     
-    template <typename value>
+    template <typename value, typename alloc>
     template <typename val>
-    typename linked_tree<value>::template tree_iterator<val>& linked_tree<value>::tree_iterator<val>::operator++() {
+    typename linked_tree<value, alloc>::template tree_iterator<val>& linked_tree<value, alloc>::tree_iterator<val>::operator++() {
         if (Current.left().size() != 0) {
             if (Current.right().size() != 0) *this = tree_iterator{Branches << Current.right(), Current.left()};
             else *this = tree_iterator{Branches, Current.left()};
@@ -202,8 +203,8 @@ namespace data::tool {
         return *this;
     }
     
-    template <typename value>
-    std::ostream& linked_tree<value>::write(std::ostream& o) const {
+    template <typename value, typename alloc>
+    std::ostream& linked_tree<value, alloc>::write(std::ostream& o) const {
         if (Size == 0) return o << "{}";
         if (Size == 1) return o << "{" << root() << "}";
         return right().write(left().write(o << "{" << root() << ", ") << ", ") << "}";
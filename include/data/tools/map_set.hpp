@@ -16,11 +16,11 @@ namespace data::tool {
         unit(bool b) : Valid{b} {}
         unit() : Valid{false} {}
         
-        bool operator==(unit x) {
+        bool operator==(unit x) const {
             return Valid == x.Valid;
         }
         
-        bool operator!=(unit x) {
+        bool operator!=(unit x) const {
             return Valid != x.Valid;
         }
     };
@@ -65,13 +65,7 @@ namespace data::tool {
         }
         
         map_set insert(map_set m) const {
-            auto v = m.values();
-            auto q = *this;
-            while (!v.empty()) {
-                q = q.insert(v.first());
-                v = v.rest();
-            }
-            return q;
+            return map_set{Map.unite(m.Map)};
         }
         
         map_set operator<<(const key& k) const {
@@ -79,68 +73,43 @@ namespace data::tool {
         }
         
         map_set remove(const key& k) const {
-            return map_set{Map.remove(k, value{true})};
+            return map_set{Map.remove(k)};
         }
         
-        const ordered_list<key> values() const {
+        decltype(std::declval<const M>().keys()) values() const {
             return Map.keys();
         }
         
         map_set() : Map{} {}
         map_set(M m) : Map(m) {}
-        map_set(list<key> keys) : Map{} {
-            insert(keys);
+        map_set(list<key> keys) : Map{map_set{}.insert(keys).Map} {}
+        
+        // build a set in linear time from a range of strictly increasing keys. 
+        template <typename it>
+        static map_set from_sorted(it begin, it end) {
+            return map_set{M::from_sorted(begin, end, value{true})};
         }
         
         bool operator==(const map_set& m) const {
-            return values() == m.values();
+            return Map == m.Map;
         }
         
         bool operator!=(const map_set& m) const {
             return !operator==(m);
         }
         
+        // union
         map_set operator&(const map_set& m) const {
-            return map_set{}.insert(*this).insert(m);
+            return map_set{Map.unite(m.Map)};
         }
         
+        // intersection
         map_set operator|(const map_set& m) const {
-            auto a = values();
-            auto b = values();
-            map_set x{};
-            
-            while(!a.empty() && !b.empty()) {
-                auto i = a.first();
-                auto j = b.first();
-                if (i == j) {
-                    x = x.insert(i);
-                    a = a.rest();
-                    b = b.rest();
-                } else if(i < j) a = a.rest();
-                else b = b.rest();
-            }
-            
-            return x;
+            return map_set{Map.intersect(m.Map)};
         }
         
         map_set operator-(const map_set& m) const {
-            auto a = values();
-            auto b = values();
-            map_set x{};
-            
-            while(!a.empty() && !b.empty()) {
-                auto i = a.first();
-                auto j = b.first();
-                if (i == j) {
-                    a = a.rest();
-                    b = b.rest();
-                } if(i < j) {
-                    x = x.insert(i);
-                    a = a.rest();
-                } else b = b.rest();
-            }
-            
-            return x;
+            return map_set{Map.subtract(m.Map)};
         }
     };
     
@@ -11,10 +11,10 @@
     
 namespace data::tool {
     
-    template <typename element> 
+    template <typename element, typename alloc = shared_allocation> 
     class ordered_list {
         uint32 Size;
-        milewski::okasaki::OrdList<element> Ordered;
+        milewski::okasaki::OrdList<element, alloc> Ordered;
     public:
         ordered_list();
         explicit ordered_list(const functional_queue<linked_stack<element>>& l);
@@ -50,8 +50,8 @@ namespace data::tool {
             bool operator==(const const_iterator) const;
             bool operator!=(const const_iterator) const;
         private:
-            milewski::okasaki::OrdList<element> Ordered;
-            const_iterator(milewski::okasaki::OrdList<element> o) : Ordered{o} {}
+            milewski::okasaki::OrdList<element, alloc> Ordered;
+            const_iterator(milewski::okasaki::OrdList<element, alloc> o) : Ordered{o} {}
             
             friend class ordered_list;
         };
@@ -67,14 +67,14 @@ namespace data::tool {
     private:
         const element& last_private() const;
         
-        ordered_list(uint32 size, milewski::okasaki::OrdList<element> ordered);
+        ordered_list(uint32 size, milewski::okasaki::OrdList<element, alloc> ordered);
     };
 
-    template <typename element>
-    std::ostream& operator<<(std::ostream& o, const data::tool::ordered_list<element>& l) {
+    template <typename element, typename alloc>
+    std::ostream& operator<<(std::ostream& o, const data::tool::ordered_list<element, alloc>& l) {
         o << "ordered_list{";
         if (!l.empty()) {
-            data::tool::ordered_list<element> x = l;
+            data::tool::ordered_list<element, alloc> x = l;
             while(true) {
                 o << x.first();
                 x = x.rest();
@@ -85,18 +85,18 @@ namespace data::tool {
         return o << "}";
     }
     
-    template <typename element>
-    bool ordered_list<element>::valid() const {
+    template <typename element, typename alloc>
+    bool ordered_list<element, alloc>::valid() const {
         if (empty()) return true;
         if (!data::valid(first())) return false;
         return rest().valid();
     }
     
-    template <typename element>
-    inline ordered_list<element>::ordered_list() : Size{0}, Ordered{} {}
+    template <typename element, typename alloc>
+    inline ordered_list<element, alloc>::ordered_list() : Size{0}, Ordered{} {}
         
-    template <typename element>
-    ordered_list<element>::ordered_list(const functional_queue<linked_stack<element>>& l) : ordered_list{} {
+    template <typename element, typename alloc>
+    ordered_list<element, alloc>::ordered_list(const functional_queue<linked_stack<element>>& l) : ordered_list{} {
         functional_queue<linked_stack<element>> g = l;
         while(!data::empty(g)) {
             *this << g.first();
@@ -104,100 +104,100 @@ namespace data::tool {
         }
     }
         
-    template <typename element>
+    template <typename element, typename alloc>
     template <typename seq>
-    bool ordered_list<element>::operator==(const seq& x) const {
+    bool ordered_list<element, alloc>::operator==(const seq& x) const {
         if (Size != x.size()) return false;
         if (Size == 0) return true;
         if (first() != x.first()) return false;
         return rest() == x.rest();
     }
     
-    template <typename element>
+    template <typename element, typename alloc>
     template <typename seq>
-    bool ordered_list<element>::operator!=(const seq& x) const {
+    bool ordered_list<element, alloc>::operator!=(const seq& x) const {
         return !operator==(x);
     }
     
-    template <typename element>
-    bool ordered_list<element>::empty() const {
+    template <typename element, typename alloc>
+    bool ordered_list<element, alloc>::empty() const {
         return Size == 0;
     }
     
-    template <typename element>
-    size_t ordered_list<element>::size() const {
+    template <typename element, typename alloc>
+    size_t ordered_list<element, alloc>::size() const {
         return Size;
     }
     
-    template <typename element>
-    ordered_list<element> ordered_list<element>::insert(const element& x) const {
+    template <typename element, typename alloc>
+    ordered_list<element, alloc> ordered_list<element, alloc>::insert(const element& x) const {
         return {Size + 1, Ordered.inserted(x)};
     }
     
-    template <typename element>
-    ordered_list<element> ordered_list<element>::operator<<(const element& x) const {
+    template <typename element, typename alloc>
+    ordered_list<element, alloc> ordered_list<element, alloc>::operator<<(const element& x) const {
         return {Size + 1, Ordered.inserted(x)};
     }
     
-    template <typename element>
-    ordered_list<element> ordered_list<element>::operator<<(const linked_stack<element> l) const {
+    template <typename element, typename alloc>
+    ordered_list<element, alloc> ordered_list<element, alloc>::operator<<(const linked_stack<element> l) const {
         if (l.empty()) return *this;
         return *this << l.first() << l.rest();
     }
     
-    template <typename element>
-    ordered_list<element> ordered_list<element>::rest() const {
+    template <typename element, typename alloc>
+    ordered_list<element, alloc> ordered_list<element, alloc>::rest() const {
         if (Size == 0) return {};
         return {Size - 1, Ordered.popped_front()};
     }
     
-    template <typename element>
-    const element& ordered_list<element>::first() const {
+    template <typename element, typename alloc>
+    const element& ordered_list<element, alloc>::first() const {
         return Ordered.front();
     }
     
-    template <typename element>
-    const element& ordered_list<element>::operator[](uint32 n) const {
+    template <typename element, typename alloc>
+    const element& ordered_list<element, alloc>::operator[](uint32 n) const {
         if (n >= Size) throw std::out_of_range{"ordered list"};
         if (n == 0) return first();
         return rest()[n - 1];
     }
     
-    template <typename element>
-    const element& ordered_list<element>::last() const {
+    template <typename element, typename alloc>
+    const element& ordered_list<element, alloc>::last() const {
         if (Size == 0) throw std::out_of_range{"ordered list"};
         return last_private();
     }
     
-    template <typename element>
-    const element& ordered_list<element>::last_private() const {
+    template <typename element, typename alloc>
+    const element& ordered_list<element, alloc>::last_private() const {
         if (Size == 1) return first();
         return rest().last_private();
     }
     
-    template <typename element>
-    inline const element& ordered_list<element>::const_iterator::operator*() const {
+    template <typename element, typename alloc>
+    inline const element& ordered_list<element, alloc>::const_iterator::operator*() const {
         return Ordered.front();
     }
     
-    template <typename element>
-    inline bool ordered_list<element>::const_iterator::operator==(const const_iterator i) const {
+    template <typename element, typename alloc>
+    inline bool ordered_list<element, alloc>::const_iterator::operator==(const const_iterator i) const {
         return Ordered == i.Ordered;
     }
     
-    template <typename element>
-    inline bool ordered_list<element>::const_iterator::operator!=(const const_iterator i) const {
+    template <typename element, typename alloc>
+    inline bool ordered_list<element, alloc>::const_iterator::operator!=(const const_iterator i) const {
         return !(*this == i);
     }
     
-    template <typename element>
-    typename ordered_list<element>::const_iterator& ordered_list<element>::const_iterator::operator++() {
+    template <typename element, typename alloc>
+    typename ordered_list<element, alloc>::const_iterator& ordered_list<element, alloc>::const_iterator::operator++() {
         if (!Ordered.isEmpty()) Ordered = Ordered.popped_front();
         return *this;
     }
     
-    template <typename element>
-    ordered_list<element>::ordered_list(uint32 size, milewski::okasaki::OrdList<element> ordered) : Size{size}, Ordered{ordered} {}
+    template <typename element, typename alloc>
+    ordered_list<element, alloc>::ordered_list(uint32 size, milewski::okasaki::OrdList<element, alloc> ordered) : Size{size}, Ordered{ordered} {}
 }
 
 #endif
@@ -0,0 +1,423 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_PERSISTENT_VECTOR
+#define DATA_TOOLS_PERSISTENT_VECTOR
+
+#include <array>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <data/types.hpp>
+#include <data/valid.hpp>
+#include <data/tools/allocator.hpp>
+
+namespace data::tool {
+
+    // persistent vector as a 32-way bitmapped trie with a tail, after
+    // Bagwell and Hickey. Elements are kept in leaves of 32 that sit
+    // contiguously in memory, so iteration is cache-friendly, random
+    // access takes O(log32 n) steps and append copies only the tail.
+    //
+    // Positions are absolute: the elements occupy [Start, End). rest()
+    // moves Start and releases leaves as they are passed, and prepend
+    // writes into the space before Start, which is made by rebuilding
+    // with room in front when there is none.
+    template <typename X, typename alloc = shared_allocation>
+    class persistent_vector {
+        using value = std::remove_reference_t<X>;
+
+        // references are stored as pointers.
+        using slot = std::conditional_t<std::is_reference<X>::value, const value*, X>;
+
+        static constexpr uint32 bits = 5;
+        static constexpr size_t width = size_t(1) << bits;
+        static constexpr size_t mask = width - 1;
+
+        // slots [Low, High) are constructed.
+        struct leaf {
+            uint32 Low;
+            uint32 High;
+            alignas(slot) unsigned char Data[sizeof(slot) * width];
+
+            const slot* slots() const {
+                return reinterpret_cast<const slot*>(Data);
+            }
+
+            slot* slots() {
+                return reinterpret_cast<slot*>(Data);
+            }
+
+            // a copy of l with x at i, which must be within
+            // or next to the slots that l already has.
+            leaf(const leaf* l, uint32 i, const slot& x);
+            ~leaf();
+
+            leaf(const leaf&) = delete;
+            leaf& operator=(const leaf&) = delete;
+        };
+
+        using link = typename alloc::template pointer<const void>;
+        using leaf_link = typename alloc::template pointer<const leaf>;
+
+        struct branch {
+            std::array<link, width> Children;
+        };
+
+        link Root;
+        leaf_link Tail;
+        size_t Start;
+        size_t End;
+        size_t TailOffset;
+        uint32 Shift;
+
+        // an empty vector whose first element will go at the given position.
+        static persistent_vector empty_at(size_t offset);
+
+        static const value& get(const slot& x);
+        static slot put(const value& x);
+
+        const leaf* leaf_at(size_t i) const;
+
+        static link assoc(const void* n, uint32 level, size_t i, link l);
+        void grow(size_t i);
+
+    public:
+        persistent_vector();
+        persistent_vector(const value& x);
+
+        // prepend, so that this is a stack.
+        persistent_vector(const value& x, const persistent_vector& v);
+
+        template <typename A, typename B, typename ... P>
+        persistent_vector(const A& a, const B& b, P... p);
+
+        bool empty() const;
+        size_t size() const;
+        bool valid() const;
+
+        const value& first() const;
+        const value& last() const;
+        const value& operator[](size_t i) const;
+
+        persistent_vector rest() const;
+
+        persistent_vector append(const value& x) const;
+        persistent_vector prepend(const value& x) const;
+
+        // linear in the size of v.
+        persistent_vector append(const persistent_vector& v) const;
+
+        template <typename A, typename B, typename ... P>
+        persistent_vector append(const A& a, const B& b, P... p) const;
+
+        persistent_vector operator<<(const value& x) const;
+        persistent_vector operator<<(const persistent_vector& v) const;
+
+        persistent_vector reverse() const;
+
+        bool operator==(const persistent_vector& v) const;
+        bool operator!=(const persistent_vector& v) const;
+
+        static persistent_vector make();
+
+        template <typename A, typename ... M>
+        static persistent_vector make(const A x, M... m);
+
+        // keeps a pointer to the current leaf and only
+        // descends the trie when it moves to the next one.
+        struct const_iterator {
+            const_iterator() : Vector{}, Index{0}, Leaf{nullptr} {}
+
+            const value& operator*() const {
+                return get(Leaf[Index & mask]);
+            }
+
+            const_iterator& operator++() {
+                Index++;
+                if ((Index & mask) == 0 || Index == Vector.TailOffset) load();
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator i = *this;
+                operator++();
+                return i;
+            }
+
+            // iterators are only compared with those of the same vector.
+            bool operator==(const const_iterator& i) const {
+                return Index == i.Index;
+            }
+
+            bool operator!=(const const_iterator& i) const {
+                return Index != i.Index;
+            }
+
+            int operator-(const const_iterator& i) const {
+                return static_cast<int>(Index) - static_cast<int>(i.Index);
+            }
+
+        private:
+            persistent_vector Vector;
+            size_t Index;
+            const slot* Leaf;
+
+            const_iterator(const persistent_vector& v, size_t i) : Vector{v}, Index{i}, Leaf{nullptr} {
+                load();
+            }
+
+            void load() {
+                if (Index < Vector.End) Leaf = Vector.leaf_at(Index)->slots();
+            }
+
+            friend class persistent_vector;
+        };
+
+        const_iterator begin() const {
+            return const_iterator{*this, Start};
+        }
+
+        const_iterator end() const {
+            return const_iterator{persistent_vector{}, End};
+        }
+
+    };
+
+    template <typename X, typename alloc>
+    std::ostream& operator<<(std::ostream& o, const persistent_vector<X, alloc>& v) {
+        o << "{";
+        auto i = v.begin();
+        if (i != v.end()) {
+            o << *i;
+            for (++i; i != v.end(); ++i) o << ", " << *i;
+        }
+        return o << "}";
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc>::leaf::leaf(const leaf* l, uint32 i, const slot& x) : Low{i}, High{i + 1} {
+        if (l != nullptr) {
+            if (l->Low < Low) Low = l->Low;
+            if (l->High > High) High = l->High;
+            for (uint32 j = l->Low; j < l->High; j++) if (j != i) new (slots() + j) slot(l->slots()[j]);
+        }
+        new (slots() + i) slot(x);
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc>::leaf::~leaf() {
+        for (uint32 j = Low; j < High; j++) slots()[j].~slot();
+    }
+
+    template <typename X, typename alloc>
+    inline const typename persistent_vector<X, alloc>::value& persistent_vector<X, alloc>::get(const slot& x) {
+        if constexpr (std::is_reference<X>::value) return *x;
+        else return x;
+    }
+
+    template <typename X, typename alloc>
+    inline typename persistent_vector<X, alloc>::slot persistent_vector<X, alloc>::put(const value& x) {
+        if constexpr (std::is_reference<X>::value) return &x;
+        else return x;
+    }
+
+    template <typename X, typename alloc>
+    const typename persistent_vector<X, alloc>::leaf* persistent_vector<X, alloc>::leaf_at(size_t i) const {
+        if (i >= TailOffset) return Tail.get();
+        const void* n = Root.get();
+        for (uint32 level = Shift; level > 0 && n != nullptr; level -= bits)
+            n = static_cast<const branch*>(n)->Children[(i >> level) & mask].get();
+        return static_cast<const leaf*>(n);
+    }
+
+    // path copy that puts l at the leaf containing position i.
+    // Branches left with no children are removed.
+    template <typename X, typename alloc>
+    typename persistent_vector<X, alloc>::link persistent_vector<X, alloc>::assoc(const void* n, uint32 level, size_t i, link l) {
+        if (level == 0) return l;
+        branch b = n == nullptr ? branch{} : *static_cast<const branch*>(n);
+        link& child = b.Children[(i >> level) & mask];
+        child = assoc(child.get(), level - bits, i, l);
+        for (const link& c : b.Children) if (c != nullptr) return alloc::template make<const branch>(b);
+        return nullptr;
+    }
+
+    // add levels above the root until it reaches position i.
+    template <typename X, typename alloc>
+    void persistent_vector<X, alloc>::grow(size_t i) {
+        while ((i >> bits) >= (size_t(1) << Shift)) {
+            if (Root != nullptr) {
+                branch b{};
+                b.Children[0] = Root;
+                Root = alloc::template make<const branch>(b);
+            }
+            Shift += bits;
+        }
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::empty_at(size_t offset) {
+        persistent_vector v{};
+        v.Start = v.End = offset;
+        v.TailOffset = offset & ~mask;
+        return v;
+    }
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc>::persistent_vector() :
+        Root{nullptr}, Tail{nullptr}, Start{0}, End{0}, TailOffset{0}, Shift{bits} {}
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc>::persistent_vector(const value& x) : persistent_vector{persistent_vector{}.append(x)} {}
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc>::persistent_vector(const value& x, const persistent_vector& v) :
+        persistent_vector{v.prepend(x)} {}
+
+    template <typename X, typename alloc>
+    template <typename A, typename B, typename ... P>
+    inline persistent_vector<X, alloc>::persistent_vector(const A& a, const B& b, P... p) :
+        persistent_vector{persistent_vector{}.append(a, b, p...)} {}
+
+    template <typename X, typename alloc>
+    inline bool persistent_vector<X, alloc>::empty() const {
+        return Start == End;
+    }
+
+    template <typename X, typename alloc>
+    inline size_t persistent_vector<X, alloc>::size() const {
+        return End - Start;
+    }
+
+    template <typename X, typename alloc>
+    bool persistent_vector<X, alloc>::valid() const {
+        for (const value& x : *this) if (!data::valid(x)) return false;
+        return true;
+    }
+
+    template <typename X, typename alloc>
+    inline const typename persistent_vector<X, alloc>::value& persistent_vector<X, alloc>::first() const {
+        return get(leaf_at(Start)->slots()[Start & mask]);
+    }
+
+    template <typename X, typename alloc>
+    inline const typename persistent_vector<X, alloc>::value& persistent_vector<X, alloc>::last() const {
+        return get(Tail->slots()[(End - 1) & mask]);
+    }
+
+    template <typename X, typename alloc>
+    const typename persistent_vector<X, alloc>::value& persistent_vector<X, alloc>::operator[](size_t i) const {
+        if (i >= size()) throw std::out_of_range("vector index");
+        size_t n = Start + i;
+        return get(leaf_at(n)->slots()[n & mask]);
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::rest() const {
+        if (size() <= 1) return {};
+        persistent_vector v = *this;
+        v.Start++;
+        // release a leaf once every element in it has been passed.
+        if ((v.Start & mask) == 0 && v.Start <= TailOffset) v.Root = assoc(Root.get(), Shift, v.Start - 1, nullptr);
+        return v;
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::append(const value& x) const {
+        persistent_vector v = *this;
+        if (Tail != nullptr && End == TailOffset + width) {
+            v.grow(TailOffset);
+            v.Root = assoc(v.Root.get(), v.Shift, TailOffset, Tail);
+            v.TailOffset += width;
+            v.Tail = alloc::template make<const leaf>(nullptr, 0, put(x));
+        } else v.Tail = alloc::template make<const leaf>(Tail.get(), End & mask, put(x));
+        v.End++;
+        return v;
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::prepend(const value& x) const {
+        if (empty()) return append(x);
+
+        // make room in front as large as the vector, so
+        // that prepending repeatedly is amortized O(1).
+        if (Start == 0) {
+            persistent_vector v = empty_at((size() + mask) & ~mask);
+            for (const value& y : *this) v = v.append(y);
+            return v.prepend(x);
+        }
+
+        persistent_vector v = *this;
+        size_t i = --v.Start;
+        if (i >= TailOffset) v.Tail = alloc::template make<const leaf>(Tail.get(), i & mask, put(x));
+        else {
+            v.grow(i);
+            v.Root = assoc(v.Root.get(), v.Shift, i, alloc::template make<const leaf>(v.leaf_at(i), i & mask, put(x)));
+        }
+        return v;
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::append(const persistent_vector& v) const {
+        if (empty()) return v;
+        persistent_vector x = *this;
+        for (const value& y : v) x = x.append(y);
+        return x;
+    }
+
+    template <typename X, typename alloc>
+    template <typename A, typename B, typename ... P>
+    inline persistent_vector<X, alloc> persistent_vector<X, alloc>::append(const A& a, const B& b, P... p) const {
+        return append(a).append(b, p...);
+    }
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc> persistent_vector<X, alloc>::operator<<(const value& x) const {
+        return append(x);
+    }
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc> persistent_vector<X, alloc>::operator<<(const persistent_vector& v) const {
+        return append(v);
+    }
+
+    template <typename X, typename alloc>
+    persistent_vector<X, alloc> persistent_vector<X, alloc>::reverse() const {
+        persistent_vector v{};
+        for (size_t i = End; i > Start; i--) v = v.append(get(leaf_at(i - 1)->slots()[(i - 1) & mask]));
+        return v;
+    }
+
+    template <typename X, typename alloc>
+    bool persistent_vector<X, alloc>::operator==(const persistent_vector& v) const {
+        if (this == &v) return true;
+        if (size() != v.size()) return false;
+        auto a = v.begin();
+        for (const value& x : *this) {
+            if (x != *a) return false;
+            ++a;
+        }
+        return true;
+    }
+
+    template <typename X, typename alloc>
+    inline bool persistent_vector<X, alloc>::operator!=(const persistent_vector& v) const {
+        return !operator==(v);
+    }
+
+    template <typename X, typename alloc>
+    inline persistent_vector<X, alloc> persistent_vector<X, alloc>::make() {
+        return persistent_vector{};
+    }
+
+    template <typename X, typename alloc>
+    template <typename A, typename ... M>
+    inline persistent_vector<X, alloc> persistent_vector<X, alloc>::make(const A x, M... m) {
+        return make(m...).prepend(x);
+    }
+
+}
+
+#endif
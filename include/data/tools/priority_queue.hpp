@@ -10,9 +10,9 @@
     
 namespace data::tool {
     
-    template <typename x, typename stack>
+    template <typename x, typename stack, typename alloc = shared_allocation>
     class priority_queue {
-        using heap = milewski::okasaki::Heap<x>;
+        using heap = milewski::okasaki::Heap<x, alloc>;
         heap Heap;
         uint32 Size;
         priority_queue(heap h, uint32 size) : Heap{h}, Size{size} {}
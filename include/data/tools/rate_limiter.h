@@ -5,18 +5,111 @@
 #ifndef DATA_RATE_LIMITER_H
 #define DATA_RATE_LIMITER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
 #include "circular_queue.h"
 
 namespace data {
     namespace tools {
         class rate_limiter {
         public:
-            explicit rate_limiter(int hits, int duration) : m_queue(hits, -1), m_duration(duration) {};
+            explicit rate_limiter(int hits, int duration) : m_queue(hits), m_duration(duration) {
+                for (int i = 0; i < hits; i++) m_queue.push(-1);
+            };
             long getTime();
         private:
-            circular_queue m_queue;
+            // the times of the last hits.
+            circular_queue<long, 0, queue_mode::overwrite> m_queue;
             int m_duration;
         };
+
+        // A token bucket that allows hits per duration on average and up to
+        // burst at once. It is kept as the time at which the bucket will be
+        // full again, which is updated with compare and swap, so any number
+        // of threads can use it without a lock.
+        class token_bucket {
+        public:
+            using clock = std::chrono::steady_clock;
+
+            token_bucket(uint32_t hits, clock::duration duration, uint32_t burst);
+            token_bucket(uint32_t hits, clock::duration duration) : token_bucket(hits, duration, hits) {}
+
+            // take n tokens if there are that many.
+            bool try_acquire(uint32_t n, clock::time_point now);
+            bool try_acquire(uint32_t n = 1) {
+                return try_acquire(n, clock::now());
+            }
+
+            // take n tokens if they will be there by the deadline and return
+            // how long to wait for them. Nothing is taken if they will not be.
+            std::optional<clock::duration> acquire_until(clock::time_point deadline, uint32_t n, clock::time_point now);
+            std::optional<clock::duration> acquire_until(clock::time_point deadline, uint32_t n = 1) {
+                return acquire_until(deadline, n, clock::now());
+            }
+
+            // wait until there are n tokens and take them.
+            void acquire(uint32_t n = 1);
+
+            uint32_t burst() const {
+                return m_burst;
+            }
+
+        private:
+            // the time to make one token.
+            const int64_t m_interval;
+            const uint32_t m_burst;
+            // nanoseconds since the epoch of the clock.
+            std::atomic<int64_t> m_full;
+
+            // take n tokens if they will be there within wait.
+            std::optional<int64_t> take(uint32_t n, int64_t now, int64_t wait);
+        };
+
+        // One token bucket for each key, such as a host name. Keys are
+        // divided among shards that are locked separately, and a bucket
+        // that already exists is found under a shared lock.
+        class keyed_rate_limiter {
+        public:
+            keyed_rate_limiter(uint32_t hits, token_bucket::clock::duration duration, uint32_t burst) :
+                m_hits(hits), m_duration(duration), m_burst(burst) {}
+            keyed_rate_limiter(uint32_t hits, token_bucket::clock::duration duration) :
+                keyed_rate_limiter(hits, duration, hits) {}
+
+            // the bucket for k, which is made the first time it is asked for.
+            token_bucket& operator[](const std::string& k);
+
+            bool try_acquire(const std::string& k, uint32_t n = 1) {
+                return (*this)[k].try_acquire(n);
+            }
+
+            std::optional<token_bucket::clock::duration> acquire_until(
+                const std::string& k, token_bucket::clock::time_point deadline, uint32_t n = 1) {
+                return (*this)[k].acquire_until(deadline, n);
+            }
+
+            void acquire(const std::string& k, uint32_t n = 1) {
+                (*this)[k].acquire(n);
+            }
+
+        private:
+            struct shard {
+                std::shared_mutex m_mutex;
+                std::unordered_map<std::string, std::unique_ptr<token_bucket>> m_buckets;
+            };
+
+            static constexpr size_t shards = 64;
+
+            const uint32_t m_hits;
+            const token_bucket::clock::duration m_duration;
+            const uint32_t m_burst;
+            std::array<shard, shards> m_shards;
+        };
     }
 }
 
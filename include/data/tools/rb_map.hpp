@@ -5,6 +5,7 @@
 #ifndef DATA_MAP_RB
 #define DATA_MAP_RB
 
+#include <algorithm>
 #include <data/tools/ordered_list.hpp>
 #include <data/map.hpp>
 #include <data/fold.hpp>
@@ -12,10 +13,10 @@
     
 namespace data::tool {
     
-    template <typename K, typename V>
+    template <typename K, typename V, typename alloc = shared_allocation>
     struct rb_map {
         using entry = data::entry<K, V>;
-        using map = milewski::okasaki::RBMap<K, V>;
+        using map = milewski::okasaki::RBMap<K, V, alloc>;
     private:
         map Map;
         size_t Size;
@@ -48,6 +49,22 @@ namespace data::tool {
         
         rb_map(std::initializer_list<std::pair<K, V>> init);
         
+        // build a map in linear time from a range of 
+        // entries or pairs with strictly increasing keys. 
+        template <typename it>
+        static rb_map from_sorted(it begin, it end);
+        
+        // build a map from a range of strictly increasing 
+        // keys, all with the same value. 
+        template <typename it>
+        static rb_map from_sorted(it begin, it end, const V& v);
+        
+        // Set operations. Where both maps have a 
+        // key, the value is taken from *this. 
+        rb_map unite(const rb_map&) const;
+        rb_map intersect(const rb_map&) const;
+        rb_map subtract(const rb_map&) const;
+        
         const ordered_list<K> keys() const;
         
         const ordered_list<entry> values() const;
@@ -58,25 +75,152 @@ namespace data::tool {
             return !(*this == map);
         }
         
-        using const_iterator = typename ordered_list<entry>::const_iterator;
+        // iterates over the entries in order without copying the map. 
+        struct const_iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = entry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const entry*;
+            using reference = const entry;
+            
+            const_iterator() : Cursor{} {}
+            
+            const entry operator*() const {
+                return entry{Cursor.key(), Cursor.value()};
+            }
+            
+            const_iterator& operator++() {
+                if (!Cursor.isEnd()) Cursor.next();
+                return *this;
+            }
+            
+            const_iterator operator++(int) {
+                const_iterator i = *this;
+                ++(*this);
+                return i;
+            }
+            
+            bool operator==(const const_iterator& i) const {
+                return Cursor == i.Cursor;
+            }
+            
+            bool operator!=(const const_iterator& i) const {
+                return Cursor != i.Cursor;
+            }
+            
+        private:
+            typename map::Cursor Cursor;
+            const_iterator(typename map::Cursor c) : Cursor{c} {}
+            
+            friend struct rb_map;
+        };
         
         const_iterator begin() const;
         const_iterator end() const;
         
+        // the first entry whose key is not less than k. 
+        const_iterator lower_bound(const K& k) const;
+        
+        // the first entry whose key is greater than k. 
+        const_iterator upper_bound(const K& k) const;
+        
+        // the tree underneath, for dividing work among its branches. 
+        const map& tree() const {
+            return Map;
+        }
+        
+        // a map with the same keys in which each value v is replaced 
+        // by f(v). join(depth, a, b) is given the work for the two 
+        // branches of each node and may do them at the same time. 
+        template <typename F, typename J>
+        rb_map<K, std::invoke_result_t<F&, const V&>, alloc> map_values(F f, J join) const;
+        
+        template <typename, typename, typename> friend struct rb_map;
+        
     };
     
-    template <typename K, typename V>
-    inline std::ostream& operator<<(std::ostream& o, const rb_map<K, V>& x) {
+    template <typename K, typename V, typename alloc>
+    template <typename F, typename J>
+    rb_map<K, std::invoke_result_t<F&, const V&>, alloc> rb_map<K, V, alloc>::map_values(F f, J join) const {
+        using W = std::invoke_result_t<F&, const V&>;
+        return rb_map<K, W, alloc>{Map.template mapped<W>(f, join), Size};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    inline std::ostream& operator<<(std::ostream& o, const rb_map<K, V, alloc>& x) {
         return functional::stack::write(o << "map", x.values());
     }
     
-    template <typename K, typename V>
-    inline rb_map<K, V>::rb_map(std::initializer_list<std::pair<K, V> > init) : Map{}, Size{0} {
-        for (auto p : init) *this = insert(p.first, p.second);
+    template <typename K, typename V, typename alloc>
+    rb_map<K, V, alloc>::rb_map(std::initializer_list<std::pair<K, V> > init) : Map{}, Size{0} {
+        // as with insert, a later entry replaces an earlier one with the same key. 
+        std::vector<std::pair<K, V>> sorted{init};
+        std::stable_sort(sorted.begin(), sorted.end(), 
+            [](const std::pair<K, V>& a, const std::pair<K, V>& b) -> bool {
+                return a.first < b.first;
+            });
+        auto last = std::unique(sorted.rbegin(), sorted.rend(), 
+            [](const std::pair<K, V>& a, const std::pair<K, V>& b) -> bool {
+                return !(a.first < b.first) && !(b.first < a.first);
+            });
+        *this = from_sorted(last.base(), sorted.end());
     }
     
-    template <typename K, typename V>
-    bool rb_map<K, V>::operator==(const rb_map& map) const {
+    template <typename K, typename V, typename alloc>
+    template <typename it>
+    rb_map<K, V, alloc> rb_map<K, V, alloc>::from_sorted(it begin, it end) {
+        struct {
+            std::pair<K, V> operator()(const std::pair<K, V>& p) const {
+                return p;
+            }
+            
+            std::pair<K, V> operator()(const entry& e) const {
+                return {e.Key, e.Value};
+            }
+        } pairs;
+        size_t size = std::distance(begin, end);
+        return rb_map{map::fromSorted(begin, size, pairs), size};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    template <typename it>
+    rb_map<K, V, alloc> rb_map<K, V, alloc>::from_sorted(it begin, it end, const V& v) {
+        size_t size = std::distance(begin, end);
+        return rb_map{map::fromSorted(begin, size, [&v](const K& k) -> std::pair<K, V> {
+            return {k, v};
+        }), size};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    rb_map<K, V, alloc> rb_map<K, V, alloc>::unite(const rb_map& m) const {
+        size_t common = 0;
+        map u = Map.united(m.Map, common);
+        return rb_map{u, Size + m.Size - common};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    rb_map<K, V, alloc> rb_map<K, V, alloc>::intersect(const rb_map& m) const {
+        size_t common = 0;
+        map u = Map.intersected(m.Map, common);
+        return rb_map{u, common};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    rb_map<K, V, alloc> rb_map<K, V, alloc>::subtract(const rb_map& m) const {
+        // removing a few keys one at a time is cheaper than splitting the whole tree.
+        if (m.Size * 8 < Size) {
+            rb_map x = *this;
+            for (auto e = m.begin(); e != m.end(); ++e) x = x.remove((*e).Key);
+            return x;
+        }
+        
+        size_t common = 0;
+        map u = Map.subtracted(m.Map, common);
+        return rb_map{u, Size - common};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    bool rb_map<K, V, alloc>::operator==(const rb_map& map) const {
         if (this == &map) return true;
         if (size() != map.size()) return false;
         auto a = map.begin();
@@ -87,95 +231,97 @@ namespace data::tool {
         return true;
     }
     
-    template <typename K, typename V>
-    const ordered_list<K> rb_map<K, V>::keys() const {
+    template <typename K, typename V, typename alloc>
+    const ordered_list<K> rb_map<K, V, alloc>::keys() const {
         linked_stack<K> kk{};
-        milewski::okasaki::forEach(Map, [&kk](const K& k, V) -> void {
-            kk = kk << k;
-        });
+        for (auto c = Map.first(); !c.isEnd(); c.next()) kk = kk << c.key();
+        // insert the greatest first so that each insertion is at the front. 
         ordered_list<K> x{};
-        for (const auto& k : data::reverse(kk)) x = x << k;
+        for (const auto& k : kk) x = x << k;
         return x;
     }
     
-    template <typename K, typename V>
-    const ordered_list<entry<K, V>> rb_map<K, V>::values() const {
+    template <typename K, typename V, typename alloc>
+    const ordered_list<entry<K, V>> rb_map<K, V, alloc>::values() const {
         linked_stack<entry> kk{};
-        milewski::okasaki::forEach(Map, [&kk](const K& k, V v) -> void {
-            kk = kk << entry{k, v};
-        });
+        for (auto c = Map.first(); !c.isEnd(); c.next()) kk = kk << entry{c.key(), c.value()};
         ordered_list<entry> x{};
-        for (const auto& e : data::reverse(kk)) x = x << e;
+        for (const auto& e : kk) x = x << e;
         return x;
     }
     
-    template <typename K, typename V>
-    inline const V& rb_map<K, V>::operator[](const K& k) const {
+    template <typename K, typename V, typename alloc>
+    inline const V& rb_map<K, V, alloc>::operator[](const K& k) const {
         static V Default{};
         return Map.findWithDefault(Default, k);
     }
     
-    template <typename K, typename V>
-    inline bool rb_map<K, V>::contains(const K& k) const {
+    template <typename K, typename V, typename alloc>
+    inline bool rb_map<K, V, alloc>::contains(const K& k) const {
         return Map.member(k);
     }
     
-    template <typename K, typename V>
-    inline bool rb_map<K, V>::contains(const entry& e) const {
+    template <typename K, typename V, typename alloc>
+    inline bool rb_map<K, V, alloc>::contains(const entry& e) const {
         return operator[](e.Key) == e.Value;
     }
     
-    template <typename K, typename V>
-    inline rb_map<K, V> rb_map<K, V>::insert(const K& k, const V& v) const {
-        V already = operator[](k);
-        if (already == V{}) return rb_map{Map.inserted(k, v), Size + 1};
-        if (already == v) return *this;
-        rb_map removed = this->remove(k);
-        return rb_map{removed.Map.inserted(k, v), removed.Size + 1};
+    template <typename K, typename V, typename alloc>
+    inline rb_map<K, V, alloc> rb_map<K, V, alloc>::insert(const K& k, const V& v) const {
+        if (!Map.member(k)) return rb_map{Map.inserted(k, v), Size + 1};
+        if (operator[](k) == v) return *this;
+        return rb_map{Map.replaced(k, v), Size};
     }
     
-    template <typename K, typename V>
-    inline rb_map<K, V> rb_map<K, V>::insert(const entry& e) const {
+    template <typename K, typename V, typename alloc>
+    inline rb_map<K, V, alloc> rb_map<K, V, alloc>::insert(const entry& e) const {
         return insert(e.Key, e.Value);
     }
     
-    // there's a more efficient way of doing this. 
-    // See matt.might.net/articles/red-black-delete/ 
-    template <typename K, typename V>
-    inline rb_map<K, V> rb_map<K, V>::remove(const K& k) const {
-        rb_map m{};
-        for (auto x = begin(); x != end(); ++x) if ((*x).Key != k) m = m.insert(*x);
-        return m;
+    template <typename K, typename V, typename alloc>
+    inline rb_map<K, V, alloc> rb_map<K, V, alloc>::remove(const K& k) const {
+        if (!Map.member(k)) return *this;
+        return rb_map{Map.removed(k), Size - 1};
     }
     
-    template <typename K, typename V>
-    inline rb_map<K, V> rb_map<K, V>::remove(const entry& e) const {
+    template <typename K, typename V, typename alloc>
+    inline rb_map<K, V, alloc> rb_map<K, V, alloc>::remove(const entry& e) const {
         return operator[](e.Key) == e.Value ? remove(e.Key) : *this;
     }
     
-    template <typename K, typename V>
-    inline rb_map<K, V> rb_map<K, V>::operator<<(const entry& e) const {
+    template <typename K, typename V, typename alloc>
+    inline rb_map<K, V, alloc> rb_map<K, V, alloc>::operator<<(const entry& e) const {
         return insert(e.Key, e.Value);
     }
     
-    template <typename K, typename V>
-    inline bool rb_map<K, V>::empty() const {
+    template <typename K, typename V, typename alloc>
+    inline bool rb_map<K, V, alloc>::empty() const {
         return Map.isEmpty();
     }
     
-    template <typename K, typename V>
-    inline size_t rb_map<K, V>::size() const {
+    template <typename K, typename V, typename alloc>
+    inline size_t rb_map<K, V, alloc>::size() const {
         return Size;
     }
     
-    template <typename K, typename V>
-    inline typename rb_map<K, V>::const_iterator rb_map<K, V>::begin() const {
-        return values().begin();
+    template <typename K, typename V, typename alloc>
+    inline typename rb_map<K, V, alloc>::const_iterator rb_map<K, V, alloc>::begin() const {
+        return const_iterator{Map.first()};
     } 
     
-    template <typename K, typename V>
-    inline typename rb_map<K, V>::const_iterator rb_map<K, V>::end() const {
-        return values().end();
+    template <typename K, typename V, typename alloc>
+    inline typename rb_map<K, V, alloc>::const_iterator rb_map<K, V, alloc>::end() const {
+        return const_iterator{};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    inline typename rb_map<K, V, alloc>::const_iterator rb_map<K, V, alloc>::lower_bound(const K& k) const {
+        return const_iterator{Map.lowerBound(k)};
+    }
+    
+    template <typename K, typename V, typename alloc>
+    inline typename rb_map<K, V, alloc>::const_iterator rb_map<K, V, alloc>::upper_bound(const K& k) const {
+        return const_iterator{Map.upperBound(k)};
     }
     
 }
@@ -0,0 +1,201 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_RING
+#define DATA_TOOLS_RING
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <data/types.hpp>
+
+// Bounded lock-free queues of fixed capacity for passing items between
+// threads. Nothing here blocks: try_push fails when the ring is full and
+// try_pop fails when it is empty.
+
+namespace data::tool {
+
+    // indices written by different threads go on different cache lines.
+    constexpr size_t cache_line = 64;
+
+    // the smallest power of two that is at least n, and at least 2.
+    inline size_t ring_capacity(size_t n) {
+        size_t c = 2;
+        while (c < n) c <<= 1;
+        return c;
+    }
+
+    // Vyukov's bounded multi-producer multi-consumer queue. Each cell has a
+    // sequence number that says whether it is ready to be written or read
+    // on the current lap, so that a producer and a consumer contend only
+    // on their own index.
+    template <typename X>
+    class mpmc_ring {
+        struct cell {
+            std::atomic<size_t> Sequence;
+            alignas(X) unsigned char Data[sizeof(X)];
+
+            X* get() {
+                return std::launder(reinterpret_cast<X*>(Data));
+            }
+        };
+
+        const size_t Mask;
+        std::unique_ptr<cell[]> Cells;
+
+        alignas(cache_line) std::atomic<size_t> Tail;
+        alignas(cache_line) std::atomic<size_t> Head;
+
+        // reserve up to n consecutive cells at an index that has
+        // the given offset from its cell's sequence when ready.
+        size_t reserve(std::atomic<size_t>& index, size_t offset, size_t n, size_t& pos) {
+            pos = index.load(std::memory_order_relaxed);
+            while (true) {
+                size_t m = 0;
+                while (m < n) {
+                    size_t seq = Cells[(pos + m) & Mask].Sequence.load(std::memory_order_acquire);
+                    if (seq != pos + m + offset) break;
+                    m++;
+                }
+
+                if (m == 0) {
+                    size_t seq = Cells[pos & Mask].Sequence.load(std::memory_order_acquire);
+                    // the cell is from an earlier lap, so the ring is full or empty.
+                    if (static_cast<std::ptrdiff_t>(seq - (pos + offset)) < 0) return 0;
+                    pos = index.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (index.compare_exchange_weak(pos, pos + m, std::memory_order_relaxed)) return m;
+            }
+        }
+
+    public:
+        explicit mpmc_ring(size_t capacity) :
+            Mask{ring_capacity(capacity) - 1}, Cells{new cell[Mask + 1]}, Tail{0}, Head{0} {
+            for (size_t i = 0; i <= Mask; i++) Cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~mpmc_ring() {
+            size_t tail = Tail.load(std::memory_order_acquire);
+            for (size_t i = Head.load(std::memory_order_acquire); i != tail; i++) Cells[i & Mask].get()->~X();
+        }
+
+        mpmc_ring(const mpmc_ring&) = delete;
+        mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+        size_t capacity() const {
+            return Mask + 1;
+        }
+
+        bool try_push(const X& x) {
+            return try_push(&x, 1) == 1;
+        }
+
+        bool try_pop(X& x) {
+            return try_pop(&x, 1) == 1;
+        }
+
+        // push up to n items from the range at begin and return how many.
+        template <typename it>
+        size_t try_push(it begin, size_t n) {
+            size_t pos;
+            size_t m = reserve(Tail, 0, n, pos);
+            for (size_t i = 0; i < m; i++, ++begin) {
+                cell& c = Cells[(pos + i) & Mask];
+                new (c.Data) X(*begin);
+                c.Sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return m;
+        }
+
+        // pop up to n items into out and return how many.
+        template <typename it>
+        size_t try_pop(it out, size_t n) {
+            size_t pos;
+            size_t m = reserve(Head, 1, n, pos);
+            for (size_t i = 0; i < m; i++, ++out) {
+                cell& c = Cells[(pos + i) & Mask];
+                *out = std::move(*c.get());
+                c.get()->~X();
+                c.Sequence.store(pos + i + Mask + 1, std::memory_order_release);
+            }
+            return m;
+        }
+    };
+
+    // Lamport's queue for one producer and one consumer. Each side keeps a
+    // copy of the other's index and reads the shared one again only when
+    // the copy says the ring is full or empty.
+    template <typename X>
+    class spsc_ring {
+        const size_t Mask;
+        std::unique_ptr<typename std::aligned_storage<sizeof(X), alignof(X)>::type[]> Data;
+
+        alignas(cache_line) std::atomic<size_t> Tail;
+        size_t HeadCache;
+
+        alignas(cache_line) std::atomic<size_t> Head;
+        size_t TailCache;
+
+        X* slot(size_t i) {
+            return std::launder(reinterpret_cast<X*>(&Data[i & Mask]));
+        }
+
+    public:
+        explicit spsc_ring(size_t capacity) :
+            Mask{ring_capacity(capacity) - 1}, Data{new typename std::aligned_storage<sizeof(X), alignof(X)>::type[Mask + 1]},
+            Tail{0}, HeadCache{0}, Head{0}, TailCache{0} {}
+
+        ~spsc_ring() {
+            size_t tail = Tail.load(std::memory_order_acquire);
+            for (size_t i = Head.load(std::memory_order_acquire); i != tail; i++) slot(i)->~X();
+        }
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        size_t capacity() const {
+            return Mask + 1;
+        }
+
+        bool try_push(const X& x) {
+            return try_push(&x, 1) == 1;
+        }
+
+        bool try_pop(X& x) {
+            return try_pop(&x, 1) == 1;
+        }
+
+        template <typename it>
+        size_t try_push(it begin, size_t n) {
+            size_t tail = Tail.load(std::memory_order_relaxed);
+            if (tail + n - HeadCache > Mask + 1) HeadCache = Head.load(std::memory_order_acquire);
+            size_t m = std::min(n, Mask + 1 - (tail - HeadCache));
+            for (size_t i = 0; i < m; i++, ++begin) new (&Data[(tail + i) & Mask]) X(*begin);
+            if (m > 0) Tail.store(tail + m, std::memory_order_release);
+            return m;
+        }
+
+        template <typename it>
+        size_t try_pop(it out, size_t n) {
+            size_t head = Head.load(std::memory_order_relaxed);
+            if (TailCache - head < n) TailCache = Tail.load(std::memory_order_acquire);
+            size_t m = std::min(n, TailCache - head);
+            for (size_t i = 0; i < m; i++, ++out) {
+                X* x = slot(head + i);
+                *out = std::move(*x);
+                x->~X();
+            }
+            if (m > 0) Head.store(head + m, std::memory_order_release);
+            return m;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DATA_TOOLS_SELECT
+#define DATA_TOOLS_SELECT
+
+#include <functional>
+#include <optional>
+#include <data/tools/channel.hpp>
+
+namespace data::tool {
+
+    // golang-like select over several channels. Each case is a get from or
+    // a put to a channel with a function to call when it happens. Running
+    // the select does the first case that can go ahead, starting from a
+    // different case each time, and calls its function. If none can, it
+    // calls the default function if there is one and otherwise sleeps
+    // until one of the channels changes or the deadline passes.
+    //
+    //     int which = select{}.
+    //         get(a, [](int x) { ... }).
+    //         put(b, y, []() { ... }).
+    //         within(std::chrono::milliseconds(100))();
+    //
+    // A case on a closed channel never goes ahead.
+    class select {
+        struct branch {
+            // do the case if it can go ahead.
+            std::function<bool()> Try;
+            std::function<bool()> Closed;
+            waiters* Waiters;
+            ptr<const void> Channel;
+        };
+
+        std::vector<branch> Cases;
+        std::function<void()> Default;
+        std::optional<std::chrono::steady_clock::time_point> Deadline;
+
+        bool attempt(size_t start, int& which) const {
+            for (size_t i = 0; i < Cases.size(); i++) {
+                size_t j = (start + i) % Cases.size();
+                if (Cases[j].Try()) {
+                    which = static_cast<int>(j);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool finished() const {
+            for (const branch& b : Cases) if (!b.Closed()) return false;
+            return true;
+        }
+
+    public:
+        // what the select returns when it runs no case.
+        static constexpr int defaulted = -1;
+        static constexpr int timed_out = -2;
+        static constexpr int closed = -3;
+
+        select() : Cases{}, Default{}, Deadline{} {}
+
+        // get an item from the channel and call f with it.
+        template <class item, access a, typename F>
+        select& get(typename channel<item, a>::from c, F f) {
+            Cases.push_back(branch{
+                [c, f]() mutable -> bool {
+                    item x;
+                    if (!c.get(x, false)) return false;
+                    f(x);
+                    return true;
+                },
+                [c]() -> bool {
+                    return c.Inner->closed();
+                },
+                &c.Inner->Selects, c.Inner});
+            return *this;
+        }
+
+        template <class item, access a, typename F>
+        select& get(channel<item, a>& c, F f) {
+            return get<item, a>(c.From, f);
+        }
+
+        // put x into the channel and then call f.
+        template <class item, access a, typename F>
+        select& put(typename channel<item, a>::to c, const item& x, F f) {
+            Cases.push_back(branch{
+                [c, x, f]() mutable -> bool {
+                    if (!c.try_put(x)) return false;
+                    f();
+                    return true;
+                },
+                [c]() -> bool {
+                    return c.Inner->closed();
+                },
+                &c.Inner->Selects, c.Inner});
+            return *this;
+        }
+
+        template <class item, access a, typename F>
+        select& put(channel<item, a>& c, const item& x, F f) {
+            return put<item, a>(c.To, x, f);
+        }
+
+        // called instead of waiting when no case can go ahead.
+        template <typename F>
+        select& otherwise(F f) {
+            Default = f;
+            return *this;
+        }
+
+        select& until(std::chrono::steady_clock::time_point deadline) {
+            Deadline = deadline;
+            return *this;
+        }
+
+        template <typename R, typename P>
+        select& within(std::chrono::duration<R, P> d) {
+            return until(std::chrono::steady_clock::now() + d);
+        }
+
+        // the index of the case that went ahead, or defaulted,
+        // timed_out, or closed if every channel is closed.
+        int operator()() const;
+    };
+
+    inline int select::operator()() const {
+        thread_local size_t Turn{0};
+        size_t start = Cases.empty() ? 0 : Turn++ % Cases.size();
+
+        int which;
+        if (attempt(start, which)) return which;
+
+        if (Default) {
+            Default();
+            return defaulted;
+        }
+
+        if (Cases.empty()) {
+            if (Deadline) std::this_thread::sleep_until(*Deadline);
+            return timed_out;
+        }
+
+        waiter w{};
+        for (const branch& b : Cases) b.Waiters->add(&w);
+        // pairs with the fence that comes before the channels notify their waiters.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int result;
+        while (true) {
+            if (attempt(start, which)) {
+                result = which;
+                break;
+            }
+
+            if (finished()) {
+                result = closed;
+                break;
+            }
+
+            if (!Deadline) w.wait();
+            else if (!w.wait_until(*Deadline)) {
+                result = attempt(start, which) ? which : timed_out;
+                break;
+            }
+        }
+
+        for (const branch& b : Cases) b.Waiters->remove(&w);
+        return result;
+    }
+
+}
+
+#endif
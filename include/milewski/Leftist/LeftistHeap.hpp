@@ -3,29 +3,32 @@
 
 #include <memory>
 #include <cassert>
+#include <data/tools/allocator.hpp>
 namespace milewski::okasaki {
-    template<class T>
+    template<class T, class Alloc = data::tool::shared_allocation>
     class Heap
     {
     private:
+        struct Tree;
+        using TreePtr = typename Alloc::template pointer<const Tree>;
         struct Tree
         {
             Tree(T v) : _rank(1), _v(v) {}
             Tree(int rank
                 , T v
-                , std::shared_ptr<const Tree> const & left
-                , std::shared_ptr<const Tree> const & right)
+                , TreePtr const & left
+                , TreePtr const & right)
             : _rank(rank), _v(v), _left(left), _right(right)
             {}
 
             int _rank;
             T   _v;
-            std::shared_ptr<const Tree> _left;
-            std::shared_ptr<const Tree> _right;
+            TreePtr _left;
+            TreePtr _right;
         };
-        std::shared_ptr<const Tree> _tree;
+        TreePtr _tree;
     private:
-        explicit Heap(std::shared_ptr<const Tree> const & tree) 
+        explicit Heap(TreePtr const & tree) 
             : _tree(tree) {}
         Heap(T x, Heap const & a, Heap const & b)
         {
@@ -35,34 +38,31 @@ namespace milewski::okasaki {
             assert(b.isEmpty() || x <= b.front());
             // rank is the length of the right spine
             if (a.rank() >= b.rank())
-                _tree = std::make_shared<const Tree>(b.rank() + 1, x, a._tree, b._tree);
+                _tree = Alloc::template make<const Tree>(b.rank() + 1, x, a._tree, b._tree);
             else
-                _tree = std::make_shared<const Tree>(a.rank() + 1, x, b._tree, a._tree);
+                _tree = Alloc::template make<const Tree>(a.rank() + 1, x, b._tree, a._tree);
             assertInv();
         }
-        Heap<T>  left() const
+        Heap left() const
         {
             assert(!isEmpty());
             return Heap(_tree->_left);
         }
-        Heap<T> right() const
+        Heap right() const
         {
             assert(!isEmpty());
             return Heap(_tree->_right);
         }
+        // Subtrees are immutable and were checked when they were
+        // made, so only the root needs to be checked here.
         void assertInv() const
         {
-            if (!isEmpty())
-            {
-                // left bias
-                assert(left().rank() >= right().rank());
-                left().assertInv();
-                right().assertInv();
-            }
+            // left bias
+            assert(isEmpty() || left().rank() >= right().rank());
         }
     public:
         Heap() {}
-        explicit Heap(T x) : _tree(std::make_shared<const Tree>(x))
+        explicit Heap(T x) : _tree(Alloc::template make<const Tree>(x))
         {}
         Heap(std::initializer_list<T> init)
         {
@@ -4,25 +4,28 @@
 #include <cassert>
 #include <memory>
 #include <initializer_list>
+#include <data/tools/allocator.hpp>
 
 namespace milewski::okasaki {
-    template<class T>
+    template<class T, class Alloc = data::tool::shared_allocation>
     // requires Ord<T>
     struct OrdList
     {
+        struct Item;
+        using ItemPtr = typename Alloc::template pointer<const Item>;
         struct Item
         {
-            Item(T v, std::shared_ptr<const Item> const & tail) : _val(v), _next(tail) {}
+            Item(T v, ItemPtr const & tail) : _val(v), _next(tail) {}
             T _val;
-            std::shared_ptr<const Item> _next;
+            ItemPtr _next;
         };
         friend Item;
-        explicit OrdList(std::shared_ptr<const Item> const & items) : _head(items) {}
+        explicit OrdList(ItemPtr const & items) : _head(items) {}
         
         // Empty list
         OrdList() : _head{nullptr} {}
         // Cons
-        OrdList(T v, OrdList const & tail) : _head(std::make_shared<Item>(v, tail._head))
+        OrdList(T v, OrdList const & tail) : _head(Alloc::template make<const Item>(v, tail._head))
         {
             assert(tail.isEmpty() || v <= tail.front());
         }
@@ -43,13 +46,13 @@ namespace milewski::okasaki {
             if (isEmpty() || v <= front())
                 return OrdList(v, OrdList(_head));
             else {
-                return OrdList<T>(front(), popped_front().inserted(v));
+                return OrdList(front(), popped_front().inserted(v));
             }
         }
         // For debugging
         int headCount() const { return _head.use_count(); }
         
-        std::shared_ptr<const Item> _head;
+        ItemPtr _head;
         
         bool operator==(const OrdList o) const { return _head == o._head; }
         
@@ -57,17 +60,17 @@ namespace milewski::okasaki {
     };
 
 
-    template<class T>
-    OrdList<T> merged(OrdList<T> const & a, OrdList<T> const & b)
+    template<class T, class Alloc>
+    OrdList<T, Alloc> merged(OrdList<T, Alloc> const & a, OrdList<T, Alloc> const & b)
     {
         if (a.isEmpty())
             return b;
         if (b.isEmpty())
             return a;
         if (a.front() <= b.front())
-            return OrdList<T>(a.front(), merged(a.popped_front(), b));
+            return OrdList<T, Alloc>(a.front(), merged(a.popped_front(), b));
         else
-            return OrdList<T>(b.front(), merged(a, b.popped_front()));
+            return OrdList<T, Alloc>(b.front(), merged(a, b.popped_front()));
     }
 }
 
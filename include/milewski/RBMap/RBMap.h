@@ -1,44 +1,52 @@
 #ifndef MILEWSKI_OKASAKI_RBMAP
 #define MILEWSKI_OKASAKI_RBMAP
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <data/tools/allocator.hpp>
 
 namespace milewski::okasaki {
 
-    enum Color { R, B };
+    // BB (double black) only appears temporarily during deletion.
+    enum Color { R, B, BB };
 
     // 1. No red node has a red child.
     // 2. Every path from rootKey to empty node contains the same
     // number of black nodes.
 
-    template<class K, class V>
+    template<class K, class V, class Alloc = data::tool::shared_allocation>
     class RBMap
     {
+        struct Node;
+        using NodePtr = typename Alloc::template pointer<const Node>;
         struct Node
         {
             Node(Color c,
-                std::shared_ptr<const Node> const & lft,
+                NodePtr const & lft,
                 const K key, V val,
-                std::shared_ptr<const Node> const & rgt)
-                : _c(c), _lft(lft), _key(key), _val(val), _rgt(rgt)
+                NodePtr const & rgt)
+                : _c(c), _bh((lft ? lft->_bh : 0) + (c == B ? 1 : c == BB ? 2 : 0))
+                , _lft(lft), _key(key), _val(val), _rgt(rgt)
             {}
             Color _c;
-            std::shared_ptr<const Node> _lft;
+            // black height, used to join trees.
+            int _bh;
+            NodePtr _lft;
             const K _key;
             const V _val;
-            std::shared_ptr<const Node> _rgt;
+            NodePtr _rgt;
         };
-        explicit RBMap(std::shared_ptr<const Node> const & node) : _root(node) {}
+        explicit RBMap(NodePtr const & node) : _root(node), _doubleBlack(false) {}
         Color rootColor() const
         {
             assert(!isEmpty());
             return _root->_c;
         }
     public:
-        RBMap() : _root{nullptr} {}
+        RBMap() : _root{nullptr}, _doubleBlack(false) {}
         RBMap(Color c, RBMap const & lft, const K& key, const V& val, RBMap const & rgt)
-            : _root(std::make_shared<const Node>(c, lft._root, key, val, rgt._root))
+            : _root(Alloc::template make<const Node>(c, lft._root, key, val, rgt._root)), _doubleBlack(false)
         {
             assert(lft.isEmpty() || lft.rootKey() < key);
             assert(rgt.isEmpty() || key < rgt.rootKey());
@@ -101,6 +109,236 @@ namespace milewski::okasaki {
             RBMap t = insWith(k, v, combine);
             return RBMap(B, t.left(), t.rootKey(), t.rootValue(), t.right());
         }
+        // Persistent deletion after Germane and Might,
+        // "Deletion: The curse of the red-black tree".
+        RBMap removed(const K& x) const
+        {
+            RBMap t = redden().del(x);
+            if (t.isEmpty())
+                return RBMap();
+            return t.rootColor() == B ? t : t.paint(B);
+        }
+        // Replace the value at an existing key. Only the path to the
+        // key is copied and the shape of the tree is unchanged.
+        RBMap replaced(const K& x, const V& v) const
+        {
+            if (isEmpty())
+                return *this;
+            const K& y = rootKey();
+            if (x < y)
+                return RBMap(rootColor(), left().replaced(x, v), y, rootValue(), right());
+            else if (y < x)
+                return RBMap(rootColor(), left(), y, rootValue(), right().replaced(x, v));
+            else
+                return RBMap(rootColor(), left(), y, v, right());
+        }
+        // In-order traversal with an explicit stack of the nodes whose
+        // left subtrees have been visited. A red-black tree with fewer
+        // than 2^64 nodes is never more than 128 levels deep, so the
+        // stack has a fixed size and nothing is allocated.
+        class Cursor
+        {
+        public:
+            Cursor() : _size(0) {}
+            Cursor(Cursor const & c) : _size(c._size)
+            {
+                std::copy(c._stack, c._stack + c._size, _stack);
+            }
+            Cursor& operator=(Cursor const & c)
+            {
+                _size = c._size;
+                std::copy(c._stack, c._stack + c._size, _stack);
+                return *this;
+            }
+            bool isEnd() const { return _size == 0; }
+            const K& key() const
+            {
+                assert(!isEnd());
+                return _stack[_size - 1]->_key;
+            }
+            const V& value() const
+            {
+                assert(!isEnd());
+                return _stack[_size - 1]->_val;
+            }
+            void next()
+            {
+                assert(!isEnd());
+                pushLeft(_stack[--_size]->_rgt.get());
+            }
+            bool operator==(Cursor const & c) const
+            {
+                return _size == c._size && (_size == 0 || _stack[_size - 1] == c._stack[_size - 1]);
+            }
+            bool operator!=(Cursor const & c) const { return !(*this == c); }
+        private:
+            static const int MaxDepth = 128;
+            const Node* _stack[MaxDepth];
+            int _size;
+            void push(const Node* n)
+            {
+                assert(_size < MaxDepth);
+                _stack[_size++] = n;
+            }
+            void pushLeft(const Node* n)
+            {
+                for (; n != nullptr; n = n->_lft.get())
+                    push(n);
+            }
+            friend class RBMap;
+        };
+        Cursor first() const
+        {
+            Cursor c;
+            c.pushLeft(_root.get());
+            return c;
+        }
+        // the first key that is not less than x.
+        Cursor lowerBound(const K& x) const
+        {
+            Cursor c;
+            for (const Node* n = _root.get(); n != nullptr;)
+                if (n->_key < x)
+                    n = n->_rgt.get();
+                else
+                {
+                    c.push(n);
+                    n = n->_lft.get();
+                }
+            return c;
+        }
+        // the first key that is greater than x.
+        Cursor upperBound(const K& x) const
+        {
+            Cursor c;
+            for (const Node* n = _root.get(); n != nullptr;)
+                if (x < n->_key)
+                {
+                    c.push(n);
+                    n = n->_lft.get();
+                }
+                else
+                    n = n->_rgt.get();
+            return c;
+        }
+        // Build a tree from n entries with strictly increasing keys in
+        // linear time. entry(*it) must return a pair of key and value.
+        // The tree is perfectly balanced and only the nodes on the
+        // deepest level, if it is incomplete, are red.
+        template<class I, class F>
+        static RBMap fromSorted(I beg, size_t n, F entry)
+        {
+            int full = 0;
+            while ((size_t(2) << full) - 1 <= n)
+                full++;
+            return build(beg, n, 0, full, entry);
+        }
+        // All keys of lft must be less than key and all keys
+        // of rgt must be greater.
+        static RBMap joined(RBMap const & lft, const K& key, const V& val, RBMap const & rgt)
+        {
+            RBMap l = lft.blackened();
+            RBMap r = rgt.blackened();
+            int hl = l.blackHeight();
+            int hr = r.blackHeight();
+            if (hl > hr)
+                return joinRight(l, key, val, r, hr).blackened();
+            if (hl < hr)
+                return joinLeft(l, key, val, r, hl).blackened();
+            return RBMap(B, l, key, val, r);
+        }
+        // All keys of lft must be less than those of rgt.
+        static RBMap joined(RBMap const & lft, RBMap const & rgt)
+        {
+            if (lft.isEmpty())
+                return rgt;
+            if (rgt.isEmpty())
+                return lft;
+            const Node* last = nullptr;
+            RBMap rest = lft.splitLast(last);
+            return joined(rest, last->_key, last->_val, rgt);
+        }
+        struct Split
+        {
+            RBMap lft;
+            bool found;
+            RBMap rgt;
+        };
+        // the entries with keys less than and greater than x.
+        Split split(const K& x) const
+        {
+            if (isEmpty())
+                return Split{RBMap(), false, RBMap()};
+            const K& y = rootKey();
+            if (x < y)
+            {
+                Split s = left().split(x);
+                return Split{s.lft, s.found, joined(s.rgt, y, rootValue(), right())};
+            }
+            else if (y < x)
+            {
+                Split s = right().split(x);
+                return Split{joined(left(), y, rootValue(), s.lft), s.found, s.rgt};
+            }
+            return Split{left(), true, right()};
+        }
+        // Set operations by splitting and joining. Values are taken from
+        // *this where both trees have a key. common is increased by the
+        // number of keys that are in both trees.
+        RBMap united(RBMap const & t, size_t& common) const
+        {
+            if (isEmpty())
+                return t;
+            if (t.isEmpty())
+                return *this;
+            // a single entry is cheaper to insert directly.
+            if (isSingle(t))
+            {
+                if (!member(t.rootKey()))
+                    return inserted(t.rootKey(), t.rootValue());
+                common++;
+                return *this;
+            }
+            Split s = t.split(rootKey());
+            if (s.found)
+                common++;
+            return joined(left().united(s.lft, common), rootKey(), rootValue(), right().united(s.rgt, common));
+        }
+        RBMap intersected(RBMap const & t, size_t& common) const
+        {
+            if (isEmpty() || t.isEmpty())
+                return RBMap();
+            if (isSingle(t))
+            {
+                if (!member(t.rootKey()))
+                    return RBMap();
+                common++;
+                return RBMap(B, RBMap(), t.rootKey(), findWithDefault(t.rootValue(), t.rootKey()), RBMap());
+            }
+            Split s = t.split(rootKey());
+            RBMap lft = left().intersected(s.lft, common);
+            RBMap rgt = right().intersected(s.rgt, common);
+            if (!s.found)
+                return joined(lft, rgt);
+            common++;
+            return joined(lft, rootKey(), rootValue(), rgt);
+        }
+        RBMap subtracted(RBMap const & t, size_t& common) const
+        {
+            if (isEmpty() || t.isEmpty())
+                return *this;
+            if (isSingle(t))
+            {
+                if (!member(t.rootKey()))
+                    return *this;
+                common++;
+                return removed(t.rootKey());
+            }
+            Split s = split(t.rootKey());
+            if (s.found)
+                common++;
+            return joined(s.lft.subtracted(t.left(), common), s.rgt.subtracted(t.right(), common));
+        }
         // 1. No red node has a red child.
         void assert1() const
         {
@@ -128,10 +366,23 @@ namespace milewski::okasaki {
             assert(lft == rgt);
             return (rootColor() == B) ? 1 + lft : lft;
         }
+        // The same tree with f applied to every value. join(depth, a, b)
+        // builds the two branches of a node at the given depth and may
+        // build them at the same time.
+        template<class W, class F, class J>
+        RBMap<K, W, Alloc> mapped(F& f, J& join, int depth = 0) const
+        {
+            if (isEmpty())
+                return RBMap<K, W, Alloc>();
+            RBMap<K, W, Alloc> lft, rgt;
+            join(depth, 
+                [&]() { lft = left().template mapped<W>(f, join, depth + 1); }, 
+                [&]() { rgt = right().template mapped<W>(f, join, depth + 1); });
+            return RBMap<K, W, Alloc>(rootColor(), lft, rootKey(), f(rootValue()), rgt);
+        }
     private:
         RBMap ins(const K& x, const V& v) const
         {
-            assert1();
             if (isEmpty())
                 return RBMap(R, RBMap(), x, v, RBMap());
             K y = rootKey();
@@ -159,7 +410,6 @@ namespace milewski::okasaki {
         template<class F>
         RBMap insWith(const K& x, const V& v, F combine) const
         {
-            assert1();
             if (isEmpty())
                 return RBMap(R, RBMap(), x, v, RBMap());
             K y = rootKey();
@@ -233,12 +483,196 @@ namespace milewski::okasaki {
             assert(!isEmpty());
             return RBMap(c, left(), rootKey(), rootValue(), right());
         }
+        template<class I, class F>
+        static RBMap build(I& it, size_t n, int depth, int full, F& entry)
+        {
+            if (n == 0)
+                return RBMap();
+            size_t half = (n - 1) / 2;
+            RBMap lft = build(it, half, depth + 1, full, entry);
+            auto e = entry(*it);
+            ++it;
+            RBMap rgt = build(it, n - 1 - half, depth + 1, full, entry);
+            return RBMap(depth == full ? R : B, lft, e.first, e.second, rgt);
+        }
+        // remove the greatest entry by joining, which leaves it in last.
+        RBMap splitLast(const Node*& last) const
+        {
+            if (_root->_rgt == nullptr)
+            {
+                last = _root.get();
+                return left();
+            }
+            RBMap rest = right().splitLast(last);
+            return joined(left(), rootKey(), rootValue(), rest);
+        }
+        int blackHeight() const
+        {
+            return isEmpty() ? 0 : _root->_bh;
+        }
+        RBMap blackened() const
+        {
+            return isRed() ? paint(B) : *this;
+        }
+        // Join a tree with a smaller black height on the right side of t.
+        static RBMap joinRight(RBMap const & t, const K& key, const V& val, RBMap const & rgt, int h)
+        {
+            if (t.isEmpty() || (t.rootColor() == B && t.blackHeight() == h))
+                return RBMap(R, t, key, val, rgt);
+            RBMap r = joinRight(t.right(), key, val, rgt, h);
+            if (t.rootColor() == B)
+                return balance(t.left(), t.rootKey(), t.rootValue(), r);
+            return RBMap(R, t.left(), t.rootKey(), t.rootValue(), r);
+        }
+        static RBMap joinLeft(RBMap const & lft, const K& key, const V& val, RBMap const & t, int h)
+        {
+            if (t.isEmpty() || (t.rootColor() == B && t.blackHeight() == h))
+                return RBMap(R, lft, key, val, t);
+            RBMap l = joinLeft(lft, key, val, t.left(), h);
+            if (t.rootColor() == B)
+                return balance(l, t.rootKey(), t.rootValue(), t.right());
+            return RBMap(R, l, t.rootKey(), t.rootValue(), t.right());
+        }
+        // The empty tree counted as double black.
+        static RBMap doubleBlackEmpty()
+        {
+            RBMap t;
+            t._doubleBlack = true;
+            return t;
+        }
+        bool isDoubleBlack() const
+        {
+            return isEmpty() ? _doubleBlack : rootColor() == BB;
+        }
+        bool isBlack() const
+        {
+            return !isEmpty() && rootColor() == B;
+        }
+        bool isRed() const
+        {
+            return !isEmpty() && rootColor() == R;
+        }
+        static bool isSingle(RBMap const & t)
+        {
+            return t.left().isEmpty() && t.right().isEmpty();
+        }
+        RBMap redden() const
+        {
+            if (isBlack() && left().isBlack() && right().isBlack())
+                return paint(R);
+            return *this;
+        }
+        RBMap del(const K& x) const
+        {
+            if (isEmpty())
+                return *this;
+            const K& y = rootKey();
+            if (isSingle(*this))
+            {
+                if (x < y || y < x)
+                    return *this;
+                return rootColor() == R ? RBMap() : doubleBlackEmpty();
+            }
+            if (isBlack() && right().isEmpty())
+            {
+                // the left child must be a single red node.
+                if (x < y)
+                    return RBMap(B, left().del(x), y, rootValue(), right());
+                else if (y < x)
+                    return *this;
+                else
+                    return left().paint(B);
+            }
+            if (x < y)
+                return rotate(rootColor(), left().del(x), y, rootValue(), right());
+            else if (y < x)
+                return rotate(rootColor(), left(), y, rootValue(), right().del(x));
+            RBMap rgt = right();
+            RBMap min = rgt.minimum();
+            return rotate(rootColor(), left(), min.rootKey(), min.rootValue(), rgt.minDel());
+        }
+        RBMap minimum() const
+        {
+            RBMap t = *this;
+            while (!t.left().isEmpty())
+                t = t.left();
+            return t;
+        }
+        // remove the least element.
+        RBMap minDel() const
+        {
+            if (left().isEmpty())
+            {
+                if (right().isEmpty())
+                    return rootColor() == R ? RBMap() : doubleBlackEmpty();
+                // a black node with a single red child on the right.
+                return right().paint(B);
+            }
+            return rotate(rootColor(), left().minDel(), rootKey(), rootValue(), right());
+        }
+        // restore the invariants after one side of a tree has lost a black node.
+        static RBMap rotate(Color c, RBMap const & lft, const K& x, const V& v, RBMap const & rgt)
+        {
+            if (c == R)
+            {
+                if (lft.isDoubleBlack() && rgt.isBlack())
+                    return rebalance(B, RBMap(R, lft.blacken(), x, v, rgt.left()), rgt.rootKey(), rgt.rootValue(), rgt.right());
+                if (lft.isBlack() && rgt.isDoubleBlack())
+                    return rebalance(B, lft.left(), lft.rootKey(), lft.rootValue(), RBMap(R, lft.right(), x, v, rgt.blacken()));
+            }
+            else if (c == B)
+            {
+                if (lft.isDoubleBlack() && rgt.isBlack())
+                    return rebalance(BB, RBMap(R, lft.blacken(), x, v, rgt.left()), rgt.rootKey(), rgt.rootValue(), rgt.right());
+                if (lft.isBlack() && rgt.isDoubleBlack())
+                    return rebalance(BB, lft.left(), lft.rootKey(), lft.rootValue(), RBMap(R, lft.right(), x, v, rgt.blacken()));
+                if (lft.isDoubleBlack() && rgt.isRed() && rgt.left().isBlack())
+                {
+                    RBMap rl = rgt.left();
+                    return RBMap(B,
+                        rebalance(B, RBMap(R, lft.blacken(), x, v, rl.left()), rl.rootKey(), rl.rootValue(), rl.right()),
+                        rgt.rootKey(), rgt.rootValue(), rgt.right());
+                }
+                if (lft.isRed() && lft.right().isBlack() && rgt.isDoubleBlack())
+                {
+                    RBMap lr = lft.right();
+                    return RBMap(B, lft.left(), lft.rootKey(), lft.rootValue(),
+                        rebalance(B, lr.left(), lr.rootKey(), lr.rootValue(), RBMap(R, lr.right(), x, v, rgt.blacken())));
+                }
+            }
+            return RBMap(c, lft, x, v, rgt);
+        }
+        // remove one level of black from a double black tree.
+        RBMap blacken() const
+        {
+            return isEmpty() ? RBMap() : paint(B);
+        }
+        // like balance but also handles a double black parent.
+        static RBMap rebalance(Color c, RBMap const & lft, const K& x, const V& v, RBMap const & rgt)
+        {
+            if (c == B)
+                return balance(lft, x, v, rgt);
+            if (lft.doubledRight())
+                return RBMap(B
+                , RBMap(B, lft.left(), lft.rootKey(), lft.rootValue(), lft.right().left())
+                , lft.right().rootKey()
+                , lft.right().rootValue()
+                , RBMap(B, lft.right().right(), x, v, rgt));
+            if (rgt.doubledLeft())
+                return RBMap(B
+                , RBMap(B, lft, x, v, rgt.left().left())
+                , rgt.left().rootKey()
+                , rgt.left().rootValue()
+                , RBMap(B, rgt.left().right(), rgt.rootKey(), rgt.rootValue(), rgt.right()));
+            return RBMap(c, lft, x, v, rgt);
+        }
     private:
-        std::shared_ptr<const Node> _root;
+        NodePtr _root;
+        bool _doubleBlack;
     };
 
-    template<class K, class V, class F>
-    void forEach(RBMap<K, V> const & t, F f) {
+    template<class K, class V, class A, class F>
+    void forEach(RBMap<K, V, A> const & t, F f) {
         if (!t.isEmpty()) {
             forEach(t.left(), f);
             f(t.rootKey(), t.rootValue());
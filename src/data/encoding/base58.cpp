@@ -6,25 +6,165 @@
 #include <data/math/number/gmp/gmp.hpp>
 #include <data/math/number/bytes/N.hpp>
 #include <data/encoding/digits.hpp>
+#include <data/crypto/sha256.hpp>
 
 namespace data::encoding::base58 {
     
+    namespace {
+        
+        const char Characters[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+        
+        // the value of each character as a digit, or -1. 
+        struct values {
+            int8_t Value[256];
+            
+            constexpr values() : Value{} {
+                for (int i = 0; i < 256; i++) Value[i] = -1;
+                for (int i = 0; i < 58; i++) Value[static_cast<unsigned char>(Characters[i])] = i;
+            }
+        };
+        
+        constexpr values Values{};
+        
+        // powers of 58 up to 58^5, the largest that fits in 32 bits. 
+        const uint64 powers[] = {1, 58, 3364, 195112, 11316496, 656356768};
+        
+        // limbs, least significant first, which are only 
+        // put on the heap for long strings. 
+        struct limbs {
+            uint32 Stack[64];
+            std::vector<uint32> Heap;
+            uint32* Data;
+            
+            limbs(size_t n) : Data{Stack} {
+                if (n > 64) {
+                    Heap.resize(n);
+                    Data = Heap.data();
+                }
+            }
+        };
+        
+    }
+    
+    std::string encode(bytes_view b) {
+        size_t zeros = 0;
+        while (zeros < b.size() && b[zeros] == 0) zeros++;
+        b = b.substr(zeros);
+        
+        // the number in base 58^5. Each byte needs log(256) / log(58) digits. 
+        limbs x{b.size() * 138 / 500 + 2};
+        size_t used = 0;
+        
+        // take the bytes four at a time, the first time whatever is left over. 
+        size_t i = 0;
+        while (i < b.size()) {
+            size_t k = i == 0 && b.size() % 4 != 0 ? b.size() % 4 : 4;
+            uint64 carry = 0;
+            for (size_t j = 0; j < k; j++) carry = (carry << 8) | b[i + j];
+            i += k;
+            
+            for (size_t j = 0; j < used; j++) {
+                carry += uint64(x.Data[j]) << (8 * k);
+                x.Data[j] = carry % powers[5];
+                carry /= powers[5];
+            }
+            
+            for (; carry > 0; carry /= powers[5]) x.Data[used++] = carry % powers[5];
+        }
+        
+        std::string out(zeros + 5 * used, '1');
+        char* p = out.data() + out.size();
+        for (size_t j = 0; j < used; j++)
+            for (uint32 v = x.Data[j], d = 0; d < 5; d++, v /= 58) *--p = Characters[v % 58];
+        
+        // the last limb may have given us leading zeros. 
+        size_t lead = zeros;
+        while (lead < out.size() && out[lead] == '1') lead++;
+        out.erase(zeros, lead - zeros);
+        return out;
+    }
+    
+    bool decode(bytes& out, string_view s) {
+        size_t zeros = 0;
+        while (zeros < s.size() && s[zeros] == '1') zeros++;
+        s = s.substr(zeros);
+        
+        // the number in base 2^32. Each digit needs log(58) / log(256) bytes. 
+        limbs x{s.size() * 733 / 4000 + 2};
+        size_t used = 0;
+        
+        // take the digits five at a time, the first time whatever is left over. 
+        size_t i = 0;
+        while (i < s.size()) {
+            size_t k = i == 0 && s.size() % 5 != 0 ? s.size() % 5 : 5;
+            uint64 carry = 0;
+            for (size_t j = 0; j < k; j++) {
+                int v = Values.Value[static_cast<unsigned char>(s[i + j])];
+                if (v < 0) return false;
+                carry = carry * 58 + v;
+            }
+            i += k;
+            
+            for (size_t j = 0; j < used; j++) {
+                carry += x.Data[j] * powers[k];
+                x.Data[j] = static_cast<uint32>(carry);
+                carry >>= 32;
+            }
+            
+            for (; carry > 0; carry >>= 32) x.Data[used++] = static_cast<uint32>(carry);
+        }
+        
+        // the last limb is not zero, but it may not need all its bytes. 
+        size_t top = used == 0 ? 0 : 
+            x.Data[used - 1] > 0xffffff ? 4 : x.Data[used - 1] > 0xffff ? 3 : x.Data[used - 1] > 0xff ? 2 : 1;
+        out.resize(zeros + (used == 0 ? 0 : 4 * (used - 1) + top));
+        std::fill(out.begin(), out.begin() + zeros, 0);
+        byte* p = out.data() + out.size();
+        for (size_t j = 0; j < used; j++) {
+            uint32 v = x.Data[j];
+            for (size_t d = j + 1 == used ? top : 4; d > 0; d--, v >>= 8) *--p = static_cast<byte>(v);
+        }
+        
+        return true;
+    }
+    
+    namespace check {
+        
+        std::string encode(bytes_view payload) {
+            bytes b(payload.size() + 4);
+            std::copy(payload.begin(), payload.end(), b.begin());
+            crypto::sha256::digest d = crypto::sha256::double_hash(payload);
+            std::copy(d.data(), d.data() + 4, b.begin() + payload.size());
+            return base58::encode(b);
+        }
+        
+        bool decode(bytes& payload, string_view s) {
+            if (!base58::decode(payload, s) || payload.size() < 4) return false;
+            size_t n = payload.size() - 4;
+            crypto::sha256::digest d = crypto::sha256::double_hash(bytes_view{payload.data(), n});
+            if (!std::equal(d.data(), d.data() + 4, payload.begin() + n)) return false;
+            payload.resize(n);
+            return true;
+        }
+        
+    }
+    
     string write(const bytes_view b) {
-        return write<math::number::gmp::N>(math::number::gmp::N(math::number::N_bytes<endian::big>(b)));
+        size_t zeros = 0;
+        while (zeros < b.size() && b[zeros] == 0) zeros++;
+        string x{};
+        if (zeros < b.size()) static_cast<std::string&>(x) = encode(b.substr(zeros));
+        return x;
     }
     
     view::view(string_view s) : string_view{s}, Bytes{}, ToBytes{nullptr} {
-        if (base58::valid(s)) {
-            Bytes = bytes(bytes_view(math::number::N_bytes<endian::big>(read<math::number::gmp::N>(s))));
-            ToBytes = &Bytes;
-        }
+        if (base58::valid(s) && decode(Bytes, s)) ToBytes = &Bytes;
     }
     
     template <typename N>
     std::string write_b58(const N& n) {
-        static std::string Characters = characters();
         if (n == 0) return "1";
-        return write_base<N>(n, Characters);
+        return encode(bytes_view(math::number::N_bytes<endian::big>(n)));
     }
 
     string::string() : std::string{"1"} {}
@@ -36,7 +176,9 @@ namespace data::encoding::base58 {
     string::string(uint64 x) : std::string{write_b58(nat{x})} {}
     
     inline nat read_num(const string& n) {
-        return read_base<nat>(n, 58, &digit);
+        bytes b;
+        decode(b, n);
+        return nat{math::number::N_bytes<endian::big>(bytes_view(b))};
     }
     
     bool string::operator<=(const string& n) const {
@@ -6,126 +6,323 @@
 
 #include <data/encoding/base64.hpp>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DATA_BASE64_X86
+#include <immintrin.h>
+#endif
+
 namespace data::encoding::base64 {
     
-    size_t size(string_view source) {
-        size_t source_size = source.size();
-        if (source_size < 4) return 0;
-        if (source[source_size - 1] == '=') {
-            if (source[source_size - 2] == '=') return ((source_size - 4) / 4) * 3 + 1;
-            else return ((source_size - 4) / 4) * 3 + 2;
-        }
-        return (source_size / 4) * 3;
+    namespace {
+        
+        const char* characters(alphabet a) {
+            return a == standard ? 
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" : 
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        }
+        
+        // the value of each character as a digit, or -1. 
+        struct values {
+            int32 Value[256];
+            
+            constexpr values(char c62, char c63) : Value{} {
+                for (int i = 0; i < 256; i++) Value[i] = -1;
+                for (int i = 0; i < 26; i++) Value['A' + i] = i;
+                for (int i = 0; i < 26; i++) Value['a' + i] = 26 + i;
+                for (int i = 0; i < 10; i++) Value['0' + i] = 52 + i;
+                Value[static_cast<unsigned char>(c62)] = 62;
+                Value[static_cast<unsigned char>(c63)] = 63;
+            }
+        };
+        
+        constexpr values Standard{'+', '/'};
+        constexpr values URL{'-', '_'};
+        
+        const int32* table(alphabet a) {
+            return a == standard ? Standard.Value : URL.Value;
+        }
+        
+        // In the kernels, n is the size of the input. They do as many whole 
+        // blocks as they can and return how much of the input they did, 
+        // leaving the rest to the scalar loops. 
+        
+        void encode_scalar(char* out, const byte* in, size_t n, alphabet a) {
+            const char* c = characters(a);
+            for (size_t i = 0; i + 3 <= n; i += 3, out += 4) {
+                uint32 v = (uint32(in[i]) << 16) | (uint32(in[i + 1]) << 8) | in[i + 2];
+                out[0] = c[v >> 18];
+                out[1] = c[(v >> 12) & 63];
+                out[2] = c[(v >> 6) & 63];
+                out[3] = c[v & 63];
+            }
+        }
+        
+        // the last one or two bytes, padded. 
+        void encode_tail(char* out, const byte* in, size_t n, alphabet a) {
+            const char* c = characters(a);
+            uint32 v = (uint32(in[0]) << 16) | (n == 2 ? uint32(in[1]) << 8 : 0);
+            out[0] = c[v >> 18];
+            out[1] = c[(v >> 12) & 63];
+            out[2] = n == 2 ? c[(v >> 6) & 63] : Pad;
+            out[3] = Pad;
+        }
+        
+        // whole groups of four characters. 
+        bool decode_scalar(byte* out, const char* in, size_t n, const int32* t) {
+            for (size_t i = 0; i + 4 <= n; i += 4, out += 3) {
+                int32 v0 = t[static_cast<unsigned char>(in[i])];
+                int32 v1 = t[static_cast<unsigned char>(in[i + 1])];
+                int32 v2 = t[static_cast<unsigned char>(in[i + 2])];
+                int32 v3 = t[static_cast<unsigned char>(in[i + 3])];
+                if ((v0 | v1 | v2 | v3) < 0) return false;
+                uint32 v = (v0 << 18) | (v1 << 12) | (v2 << 6) | v3;
+                out[0] = static_cast<byte>(v >> 16);
+                out[1] = static_cast<byte>(v >> 8);
+                out[2] = static_cast<byte>(v);
+            }
+            return true;
+        }
+        
+        // two or three characters at the end, without padding. 
+        bool decode_tail(byte* out, const char* in, size_t n, const int32* t) {
+            int32 v0 = t[static_cast<unsigned char>(in[0])];
+            int32 v1 = t[static_cast<unsigned char>(in[1])];
+            int32 v2 = n == 3 ? t[static_cast<unsigned char>(in[2])] : 0;
+            if ((v0 | v1 | v2) < 0) return false;
+            uint32 v = (v0 << 18) | (v1 << 12) | (v2 << 6);
+            out[0] = static_cast<byte>(v >> 16);
+            if (n == 3) out[1] = static_cast<byte>(v >> 8);
+            return true;
+        }
+        
+#ifdef DATA_BASE64_X86
+        
+#define DATA_AVX2 __attribute__((target("avx2")))
+        
+        // 24 bytes to 32 characters. 
+        DATA_AVX2 size_t encode_avx2(char* out, const byte* in, size_t n, alphabet a) {
+            // each group of three bytes b0 b1 b2 goes into 32 bits as b1 b0 b2 b1. 
+            const __m256i spread = _mm256_setr_epi8(
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            // what to add to each index, by the range it is in. 
+            const __m256i shifts = _mm256_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, 
+                characters(a)[62] - 62, characters(a)[63] - 63, 'A', 0, 0, 
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, 
+                characters(a)[62] - 62, characters(a)[63] - 63, 'A', 0, 0);
+            size_t i = 0;
+            // the second load reads four bytes past the 24 that we use. 
+            for (; i + 28 <= n; i += 24, out += 32) {
+                __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))), 
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12)), 1);
+                x = _mm256_shuffle_epi8(x, spread);
+                
+                // move each six bits into a byte of its own. 
+                __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+                __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+                __m256i indices = _mm256_or_si256(ac, bd);
+                
+                // 0 for 26 to 51, 1 to 12 for 52 to 63, and 13 below 26. 
+                __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+                range = _mm256_or_si256(range, _mm256_and_si256(
+                    _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+                __m256i chars = _mm256_add_epi8(indices, _mm256_shuffle_epi8(shifts, range));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+            }
+            return i;
+        }
+        
+        // the values of the characters in [lo, hi], and 0 elsewhere. 
+        DATA_AVX2 __m256i in_range(__m256i c, char lo, char hi, int offset, __m256i& valid) {
+            __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+            __m256i is = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(hi - lo)), d);
+            valid = _mm256_or_si256(valid, is);
+            return _mm256_and_si256(is, _mm256_add_epi8(d, _mm256_set1_epi8(offset)));
+        }
+        
+        // 32 characters to 24 bytes. Writes 32 bytes each time, 
+        // so it stops while there is room for the extra eight. 
+        DATA_AVX2 size_t decode_avx2(byte* out, const char* in, size_t n, alphabet a, bool& ok) {
+            const char c62 = characters(a)[62];
+            const char c63 = characters(a)[63];
+            // each group of three bytes is in the low three bytes of 32 bits, reversed. 
+            const __m256i gather = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m256i halves = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+            __m256i invalid = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 64 <= n; i += 32, out += 24) {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                __m256i valid = _mm256_setzero_si256();
+                __m256i v = _mm256_or_si256(_mm256_or_si256(
+                    in_range(c, 'A', 'Z', 0, valid), 
+                    in_range(c, 'a', 'z', 26, valid)), _mm256_or_si256(
+                    in_range(c, '0', '9', 52, valid), _mm256_or_si256(
+                    in_range(c, c62, c62, 62, valid), 
+                    in_range(c, c63, c63, 63, valid))));
+                invalid = _mm256_or_si256(invalid, _mm256_xor_si256(valid, _mm256_set1_epi8(-1)));
+                
+                // join the six bit values of each group of four. 
+                v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+                v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+                v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, gather), halves);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+            }
+            ok = _mm256_testz_si256(invalid, invalid);
+            return i;
+        }
+        
+#undef DATA_AVX2
+        
+        bool avx2() {
+            static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+            return supported;
+        }
+        
+#endif
+        
+        // decode whole groups of four characters, the last of which may be padded. 
+        bool decode_groups(byte* out, const char* in, size_t n, alphabet a, size_t& size, bool& padded) {
+            const int32* t = table(a);
+            padded = n >= 4 && in[n - 1] == Pad;
+            size_t whole = padded ? n - 4 : n;
+            size_t i = 0;
+#ifdef DATA_BASE64_X86
+            bool ok = true;
+            if (avx2()) i = decode_avx2(out, in, whole, a, ok);
+            if (!ok) return false;
+#endif
+            if (!decode_scalar(out + i / 4 * 3, in + i, whole - i, t)) return false;
+            size = whole / 4 * 3;
+            if (!padded) return true;
+            
+            size_t rest = in[n - 2] == Pad ? 2 : 3;
+            if (!decode_tail(out + size, in + whole, rest, t)) return false;
+            size += rest - 1;
+            return true;
+        }
+        
     }
     
-    uint32 padding(string_view source) {
-        size_t source_size = source.size();
-        if (source_size < 4) return 0;
-        if (source[source_size - 1] == '=') {
-            if (source[source_size - 2] == '=') return 2;
-            else return 1;
-        }
-        return 0;
+    void encode(char* out, bytes_view b, alphabet a) {
+        size_t n = b.size();
+        size_t i = 0;
+#ifdef DATA_BASE64_X86
+        if (avx2()) i = encode_avx2(out, b.data(), n, a);
+#endif
+        encode_scalar(out + i / 3 * 4, b.data() + i, n - i, a);
+        if (n % 3 != 0) encode_tail(out + n / 3 * 4, b.data() + n / 3 * 3, n % 3, a);
     }
     
-    ptr<bytes> read(string_view source) {
-        if (!base64::valid(source)) return nullptr;
+    bool decode(byte* out, string_view s, size_t& size, alphabet a) {
+        size_t rest = s.size() % 4;
+        if (rest == 1) return false;
+        bool padded;
+        if (!decode_groups(out, s.data(), s.size() - rest, a, size, padded)) return false;
+        if (rest == 0) return true;
+        // nothing may come after padding. 
+        if (padded || !decode_tail(out + size, s.data() + s.size() - rest, rest, table(a))) return false;
+        size += rest - 1;
+        return true;
+    }
+    
+    void encoder::write(std::string& out, bytes_view b) {
+        while (Size > 0 && Size < 3 && !b.empty()) {
+            Rest[Size++] = b[0];
+            b = b.substr(1);
+        }
         
-        uint32 padding = base64::padding(source);
+        if (Size == 3) {
+            size_t at = out.size();
+            out.resize(at + 4);
+            encode(out.data() + at, bytes_view{Rest, 3}, Alphabet);
+            Size = 0;
+        }
         
-        const static uint32_t mask = 0x000000FF;
+        size_t whole = b.size() / 3 * 3;
+        size_t at = out.size();
+        out.resize(at + whole / 3 * 4);
+        encode(out.data() + at, b.substr(0, whole), Alphabet);
         
-        ptr<bytes> b = std::make_shared<bytes>();
-
-        const size_t length = source.length();
-        if (length & 3) return nullptr;
-        b->reserve(((length / 4) * 3) - padding);
-
-        uint32_t value = 0;
-        for (auto cursor = source.begin(); cursor < source.end();) {
-            for (size_t position = 0; position < 4; position++) {
-                value <<= 6;
-                if (*cursor >= 0x41 && *cursor <= 0x5A)
-                    value |= *cursor - 0x41;
-                else if (*cursor >= 0x61 && *cursor <= 0x7A)
-                    value |= *cursor - 0x47;
-                else if (*cursor >= 0x30 && *cursor <= 0x39)
-                    value |= *cursor + 0x04;
-                else if (*cursor == 0x2B)
-                    value |= 0x3E;
-                else if (*cursor == 0x2F)
-                    value |= 0x3F;
-                else if (*cursor == Pad) {
-                    // Handle 1 or 2 pad characters.
-                    switch (source.end() - cursor) {
-                        case 1:
-                            b->push_back((value >> 16) & mask);
-                            b->push_back((value >> 8) & mask);
-                            return b;
-                        case 2:
-                            b->push_back((value >> 10) & mask);
-                            return b;
-                        default:
-                            return nullptr;
-                    }
-                } else return nullptr;
-
-                cursor++;
-            }
-
-            b->push_back((value >> 16) & mask);
-            b->push_back((value >> 8) & mask);
-            b->push_back((value >> 0) & mask);
-        }
-
-        return b;
+        for (byte x : b.substr(whole)) Rest[Size++] = x;
+    }
+    
+    void encoder::finish(std::string& out) {
+        size_t at = out.size();
+        out.resize(at + encoded_size(Size));
+        encode(out.data() + at, bytes_view{Rest, Size}, Alphabet);
+        Size = 0;
     }
     
-    string write(bytes_view sourceBytes){
-        std::string output;
-        const auto size = sourceBytes.size();
-        output.reserve(((size / 3) + (size % 3 > 0)) * 4);
+    bool decoder::write(bytes& out, string_view s) {
+        // nothing may come after padding. 
+        if (Padded && !s.empty()) Failed = true;
+        if (Failed) return false;
         
-        std::string Characters = characters();
-
-        uint32_t value;
-        auto cursor = sourceBytes.begin();
-        for (size_t position = 0; position < size / 3; position++)
-        {
-            // Convert to big endian.
-            value = (*cursor++) << 16;
-
-            value += (*cursor++) << 8;
-            value += (*cursor++);
-            output.append(1, Characters[(value & 0x00FC0000) >> 18]);
-            output.append(1, Characters[(value & 0x0003F000) >> 12]);
-            output.append(1, Characters[(value & 0x00000FC0) >> 6]);
-            output.append(1, Characters[(value & 0x0000003F) >> 0]);
+        while (Size > 0 && Size < 4 && !s.empty()) {
+            Rest[Size++] = s[0];
+            s.remove_prefix(1);
         }
-
-        switch (size % 3)
-        {
-            case 1:
-                // Convert to big endian.
-                value = (*cursor++) << 16;
-
-                output.append(1, Characters[(value & 0x00FC0000) >> 18]);
-                output.append(1, Characters[(value & 0x0003F000) >> 12]);
-                output.append(2, Pad);
-                break;
-            case 2:
-                // Convert to big endian.
-                value = (*cursor++) << 16;
-
-                value += (*cursor++) << 8;
-                output.append(1, Characters[(value & 0x00FC0000) >> 18]);
-                output.append(1, Characters[(value & 0x0003F000) >> 12]);
-                output.append(1, Characters[(value & 0x00000FC0) >> 6]);
-                output.append(1, Pad);
-                break;
+        
+        size_t at = out.size();
+        out.resize(at + 3 + decoded_size(s.size()));
+        byte* o = out.data() + at;
+        size_t size = 0;
+        
+        if (Size == 4) {
+            Failed = !decode_groups(o, Rest, 4, Alphabet, size, Padded);
+            o += size;
+            Size = 0;
         }
-
-        return {output};
+        
+        size_t whole = s.size() / 4 * 4;
+        if (!Failed && whole > 0) {
+            Failed = Padded || !decode_groups(o, s.data(), whole, Alphabet, size, Padded);
+            o += size;
+        }
+        
+        // check what is left now so that we know as soon as we can. 
+        for (char c : s.substr(whole)) {
+            if (c != Pad && table(Alphabet)[static_cast<unsigned char>(c)] < 0) Failed = true;
+            Rest[Size++] = c;
+        }
+        if (Padded && Size > 0) Failed = true;
+        
+        out.resize(Failed ? at : o - out.data());
+        return !Failed;
+    }
+    
+    bool decoder::finish(bytes& out) {
+        if (Failed || Size == 1) return false;
+        if (Size == 0) return true;
+        size_t at = out.size();
+        out.resize(at + Size - 1);
+        if (!decode_tail(out.data() + at, Rest, Size, table(Alphabet))) {
+            out.resize(at);
+            Failed = true;
+            return false;
+        }
+        Size = 0;
+        return true;
+    }
+    
+    ptr<bytes> read(string_view source) {
+        if (source.size() % 4 != 0) return nullptr;
+        ptr<bytes> b = std::make_shared<bytes>(decoded_size(source.size()));
+        size_t size = 0;
+        if (!decode(b->data(), source, size)) return nullptr;
+        b->resize(size);
+        return b;
+    }
+    
+    string write(bytes_view sourceBytes) {
+        string output;
+        output.resize(encoded_size(sourceBytes.size()));
+        encode(output.data(), sourceBytes);
+        return output;
     }
     
     string write(bytes_view sourceBytes, endian::order r) {
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/encoding/classify.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DATA_CLASSIFY_X86
+#include <immintrin.h>
+#endif
+
+namespace data::encoding {
+    
+    namespace {
+        
+        byte classify_scalar(const char* s, size_t n, const character_class* c, size_t k) {
+            byte seen = 0;
+            for (size_t i = 0; i < n; i++) {
+                byte b = 0;
+                for (size_t j = 0; j < k; j++) 
+                    if (static_cast<byte>(s[i] - c[j].First) <= static_cast<byte>(c[j].Last - c[j].First)) b |= c[j].Bit;
+                seen |= b == 0 ? unclassified : b;
+            }
+            return seen;
+        }
+        
+#ifdef DATA_CLASSIFY_X86
+        
+        // 32 characters at a time. Returns how many it did. 
+        __attribute__((target("avx2"))) 
+        size_t classify_avx2(const char* s, size_t n, const character_class* c, size_t k, byte& seen) {
+            __m256i first[8], width[8], any[8];
+            for (size_t j = 0; j < k; j++) {
+                first[j] = _mm256_set1_epi8(c[j].First);
+                width[j] = _mm256_set1_epi8(c[j].Last - c[j].First);
+                any[j] = _mm256_setzero_si256();
+            }
+            
+            __m256i missing = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+                __m256i in = _mm256_setzero_si256();
+                for (size_t j = 0; j < k; j++) {
+                    __m256i d = _mm256_sub_epi8(x, first[j]);
+                    __m256i is = _mm256_cmpeq_epi8(_mm256_min_epu8(d, width[j]), d);
+                    any[j] = _mm256_or_si256(any[j], is);
+                    in = _mm256_or_si256(in, is);
+                }
+                missing = _mm256_or_si256(missing, _mm256_cmpeq_epi8(in, _mm256_setzero_si256()));
+            }
+            
+            for (size_t j = 0; j < k; j++) if (!_mm256_testz_si256(any[j], any[j])) seen |= c[j].Bit;
+            if (!_mm256_testz_si256(missing, missing)) seen |= unclassified;
+            return i;
+        }
+        
+        bool avx2() {
+            static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+            return supported;
+        }
+        
+#endif
+        
+    }
+    
+    byte classify(string_view s, std::initializer_list<character_class> classes) {
+        byte seen = 0;
+        size_t i = 0;
+#ifdef DATA_CLASSIFY_X86
+        if (s.size() >= 32 && classes.size() <= 8 && avx2()) 
+            i = classify_avx2(s.data(), s.size(), classes.begin(), classes.size(), seen);
+#endif
+        return seen | classify_scalar(s.data() + i, s.size() - i, classes.begin(), classes.size());
+    }
+    
+}
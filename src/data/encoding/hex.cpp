@@ -11,7 +11,221 @@
 #include <data/encoding/hex.hpp>
 #include <data/encoding/endian.hpp>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DATA_HEX_X86
+#include <immintrin.h>
+#endif
+
 namespace data::encoding::hex {
+    
+    namespace {
+        
+        const char* digits(letter_case q) {
+            return q == upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        }
+        
+        // the value of each character as a hex digit, or -1.
+        struct values {
+            int8_t Value[256];
+            
+            constexpr values() : Value{} {
+                for (int i = 0; i < 256; i++) Value[i] = -1;
+                for (int i = 0; i < 10; i++) Value['0' + i] = i;
+                for (int i = 0; i < 6; i++) Value['a' + i] = Value['A' + i] = 10 + i;
+            }
+        };
+        
+        constexpr values Values{};
+        
+        // In the kernels, byte i of the input goes to position i of the output,
+        // or n - 1 - i if reversed. They do as many whole blocks as they can and
+        // return how many bytes they did, leaving the rest to the scalar loop.
+        
+        void encode_scalar(char* out, const byte* in, size_t from, size_t n, bool reversed, letter_case q) {
+            const char* d = digits(q);
+            for (size_t i = from; i < n; i++) {
+                char* o = out + 2 * (reversed ? n - 1 - i : i);
+                o[0] = d[in[i] >> 4];
+                o[1] = d[in[i] & 15];
+            }
+        }
+        
+        bool decode_scalar(byte* out, const char* in, size_t from, size_t n, bool reversed) {
+            for (size_t i = from; i < n; i++) {
+                int hi = Values.Value[static_cast<unsigned char>(in[2 * i])];
+                int lo = Values.Value[static_cast<unsigned char>(in[2 * i + 1])];
+                if ((hi | lo) < 0) return false;
+                out[reversed ? n - 1 - i : i] = static_cast<byte>((hi << 4) | lo);
+            }
+            return true;
+        }
+
+#ifdef DATA_HEX_X86
+        
+        // SSE2 is always there on x86-64.
+        
+        __m128i reverse_sse2(__m128i x) {
+            x = _mm_shuffle_epi32(x, 0x1B);
+            x = _mm_shufflelo_epi16(_mm_shufflehi_epi16(x, 0xB1), 0xB1);
+            return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        }
+        
+        // nibbles to characters.
+        __m128i characters_sse2(__m128i n, __m128i letters) {
+            __m128i above = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+            return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), _mm_and_si128(above, letters));
+        }
+        
+        size_t encode_sse2(char* out, const byte* in, size_t n, bool reversed, letter_case q) {
+            const __m128i mask = _mm_set1_epi8(15);
+            const __m128i letters = _mm_set1_epi8(q == upper ? 'A' - '0' - 10 : 'a' - '0' - 10);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                if (reversed) x = reverse_sse2(x);
+                __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+                __m128i lo = _mm_and_si128(x, mask);
+                char* o = out + 2 * (reversed ? n - i - 16 : i);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o), characters_sse2(_mm_unpacklo_epi8(hi, lo), letters));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 16), characters_sse2(_mm_unpackhi_epi8(hi, lo), letters));
+            }
+            return i;
+        }
+        
+        // characters to nibbles. Sets the bytes of invalid to 0 where a
+        // character is not a hex digit.
+        __m128i nibbles_sse2(__m128i c, __m128i& valid) {
+            __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+            __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            __m128i is_d = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+            __m128i is_l = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+            valid = _mm_and_si128(valid, _mm_or_si128(is_d, is_l));
+            return _mm_or_si128(_mm_and_si128(is_d, d), _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(10))));
+        }
+        
+        // pairs of nibbles, high first, to 16 bit words.
+        __m128i join_sse2(__m128i n) {
+            return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0xFF)), 4), _mm_srli_epi16(n, 8));
+        }
+        
+        size_t decode_sse2(byte* out, const char* in, size_t n, bool reversed, bool& ok) {
+            __m128i valid = _mm_set1_epi8(-1);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m128i a = nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), valid);
+                __m128i b = nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), valid);
+                __m128i x = _mm_packus_epi16(join_sse2(a), join_sse2(b));
+                if (reversed) x = reverse_sse2(x);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (reversed ? n - i - 16 : i)), x);
+            }
+            ok = _mm_movemask_epi8(valid) == 0xFFFF;
+            return i;
+        }
+
+#define DATA_AVX2 __attribute__((target("avx2")))
+        
+        DATA_AVX2 __m256i reverse_avx2(__m256i x) {
+            const __m256i r = _mm256_setr_epi8(
+                15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+            return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, r), 0x4E);
+        }
+        
+        DATA_AVX2 __m256i characters_avx2(__m256i n, __m256i letters) {
+            __m256i above = _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9));
+            return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), _mm256_and_si256(above, letters));
+        }
+        
+        DATA_AVX2 size_t encode_avx2(char* out, const byte* in, size_t n, bool reversed, letter_case q) {
+            const __m256i mask = _mm256_set1_epi8(15);
+            const __m256i letters = _mm256_set1_epi8(q == upper ? 'A' - '0' - 10 : 'a' - '0' - 10);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                if (reversed) x = reverse_avx2(x);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), mask);
+                __m256i lo = _mm256_and_si256(x, mask);
+                // unpack works within each half, so the halves must be put in order.
+                __m256i a = characters_avx2(_mm256_unpacklo_epi8(hi, lo), letters);
+                __m256i b = characters_avx2(_mm256_unpackhi_epi8(hi, lo), letters);
+                char* o = out + 2 * (reversed ? n - i - 32 : i);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), _mm256_permute2x128_si256(a, b, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 32), _mm256_permute2x128_si256(a, b, 0x31));
+            }
+            return i;
+        }
+        
+        DATA_AVX2 __m256i nibbles_avx2(__m256i c, __m256i& valid) {
+            __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+            __m256i l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            __m256i is_d = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+            __m256i is_l = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+            valid = _mm256_and_si256(valid, _mm256_or_si256(is_d, is_l));
+            return _mm256_or_si256(_mm256_and_si256(is_d, d), _mm256_and_si256(is_l, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+        }
+        
+        DATA_AVX2 size_t decode_avx2(byte* out, const char* in, size_t n, bool reversed, bool& ok) {
+            // multiply the high nibble by 16 and add the low one.
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+            __m256i valid = _mm256_set1_epi8(-1);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i a = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid);
+                __m256i b = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid);
+                // pack works within each half too.
+                __m256i x = _mm256_permute4x64_epi64(_mm256_packus_epi16(
+                    _mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights)), 0xD8);
+                if (reversed) x = reverse_avx2(x);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (reversed ? n - i - 32 : i)), x);
+            }
+            ok = _mm256_movemask_epi8(valid) == -1;
+            return i;
+        }
+
+#undef DATA_AVX2
+        
+        bool avx2() {
+            static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+            return supported;
+        }
+
+#endif
+        
+    }
+    
+    void encode(char* out, bytes_view b, endian::order r, letter_case q) {
+        size_t n = b.size();
+        size_t i = 0;
+#ifdef DATA_HEX_X86
+        i = avx2() ? encode_avx2(out, b.data(), n, r == endian::little, q) : 0;
+        // what is left may still fill a smaller block.
+        if (n - i >= 16) {
+            // the rest is at the front of the output when reversed, so the
+            // kernel is given only the part of the input it has not seen.
+            size_t m = n - i;
+            i += encode_sse2(r == endian::little ? out : out + 2 * i, b.data() + i, m, r == endian::little, q);
+        }
+#endif
+        encode_scalar(out, b.data(), i, n, r == endian::little, q);
+    }
+    
+    bool decode(byte* out, string_view s, endian::order r) {
+        if (s.size() & 1) return false;
+        size_t n = s.size() / 2;
+        size_t i = 0;
+#ifdef DATA_HEX_X86
+        bool ok = true;
+        if (avx2()) i = decode_avx2(out, s.data(), n, r == endian::little, ok);
+        if (!ok) return false;
+        if (n - i >= 16) {
+            size_t m = n - i;
+            i += decode_sse2(r == endian::little ? out : out + i, s.data() + 2 * i, m, r == endian::little, ok);
+            if (!ok) return false;
+        }
+#endif
+        return decode_scalar(out, s.data(), i, n, r == endian::little);
+    }
+    
     struct view : public string_view {
         bytes Bytes;
         bytes *ToBytes;
@@ -34,67 +248,54 @@ namespace data::encoding::hex {
     }
     
     view::view(string_view sourceString) : string_view{sourceString}, Bytes((sourceString.size() + 1) / 2), ToBytes{nullptr} {
-        try {
-            boost::algorithm::unhex(string_view::begin(), string_view::end(), Bytes.begin());
-        }
-        catch(boost::algorithm::hex_decode_error exception)
-        {
-            return;
-        }
-        ToBytes=&Bytes;
+        if (decode(Bytes.data(), sourceString)) ToBytes = &Bytes;
     }
     
     ptr<bytes> read(string_view x) {
         if ((x.size() & 1)) return nullptr;
         ptr<bytes> b = std::make_shared<bytes>(x.size() / 2);
-        try {
-            boost::algorithm::unhex(x.begin(), x.end(), b->begin());
-        } catch(boost::algorithm::hex_decode_error exception) {
-            return nullptr;
-        }
+        if (!decode(b->data(), x)) return nullptr;
         return b;
     }
     
-    void write_hex(string& output, bytes_view sourceBytes, letter_case q) {
+    void write_hex(string& output, bytes_view sourceBytes, endian::order r, letter_case q) {
         output.resize(sourceBytes.size() * 2);
-        if (q == upper) boost::algorithm::hex(sourceBytes.begin(), sourceBytes.end(), output.begin());
-        else boost::algorithm::hex_lower(sourceBytes.begin(), sourceBytes.end(), output.begin());
+        encode(output.data(), sourceBytes, r, q);
     }
     
     string write(bytes_view sourceBytes, letter_case q) {
         string output;
-        write_hex(output, sourceBytes, q);
+        write_hex(output, sourceBytes, endian::big, q);
         return output;
     }
     
     string write(bytes_view sourceBytes, endian::order r, letter_case q) {
-        if (r == endian::big) return write(sourceBytes, q);
-        bytes reversed(sourceBytes.size());
-        std::copy(sourceBytes.rbegin(), sourceBytes.rend(), reversed.begin());
-        return write(reversed, q);
+        string output;
+        write_hex(output, sourceBytes, r, q);
+        return output;
     }
     
     fixed<8> write(uint64 x, letter_case q) {
         fixed<8> output;
-        write_hex(output, bytes_view{uint64_big{x}.data(), sizeof(uint64)}, q);
+        write_hex(output, bytes_view{uint64_big{x}.data(), sizeof(uint64)}, endian::big, q);
         return output;
     }
     
     fixed<4> write(uint32 x, letter_case q) {
         fixed<4> output;
-        write_hex(output, bytes_view{uint32_big{x}.data(), sizeof(uint32)}, q);
+        write_hex(output, bytes_view{uint32_big{x}.data(), sizeof(uint32)}, endian::big, q);
         return output;
     }
     
     fixed<2> write(uint16 x, letter_case q) {
         fixed<2> output;
-        write_hex(output, bytes_view{uint16_big{x}.data(), sizeof(uint16)}, q);
+        write_hex(output, bytes_view{uint16_big{x}.data(), sizeof(uint16)}, endian::big, q);
         return output;
     }
     
     fixed<1> write(byte x, letter_case q) {
         fixed<1> output;
-        write_hex(output, bytes_view{(byte*)(&x), sizeof(byte)}, q);
+        write_hex(output, bytes_view{(byte*)(&x), sizeof(byte)}, endian::big, q);
         return output;
     }
 }
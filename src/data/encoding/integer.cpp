@@ -136,17 +136,21 @@ namespace data::encoding {
     namespace hexidecimal {
         
         std::ostream& write(std::ostream& o, bytes_view b, endian::order r, hex::letter_case q) {
-            o << "0x";
-            if (r == endian::order::big) for (int i = 0; i < b.size(); i++) o << hex::write(b[i], q);
-            else for(int i = b.size() - 1; i >= 0; i--) o << hex::write(b[i], q);
-            return o;
+            std::string x = hexidecimal::write(b, r, q);
+            return o.write(x.data(), x.size());
+        }
+        
+        std::string write(bytes_view b, endian::order r, hex::letter_case q) {
+            std::string x(2 * b.size() + 2, '0');
+            x[1] = 'x';
+            hex::encode(x.data() + 2, b, r, q);
+            return x;
         }
         
         ptr<bytes> read(string_view s, endian::order r) {
             if (!valid(s)) throw std::invalid_argument{"not hexidecimal"};
-            ptr<bytes> b = hex::read(s.substr(2));
-            if (b == nullptr || r == endian::big) return b;
-            std::reverse(b->begin(), b->end());
+            ptr<bytes> b = std::make_shared<bytes>((s.size() - 2) / 2);
+            if (!hex::decode(b->data(), s.substr(2), r)) return nullptr;
             return b;
         }
         
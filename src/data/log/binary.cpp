@@ -0,0 +1,549 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "data/log/binary.hpp"
+#include <data/tools/ring.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// A binary log begins with a magic number and a number that says which
+// order its bytes are in. It is followed by records, each of which begins
+// with a header. A record whose site is zero defines a statement: its
+// arguments are the id of the statement, its severity and line, and then
+// its channel, format, signature and file as strings that end in zero.
+
+namespace data::log {
+
+    static std::atomic<uint64_t> dropped_records{0};
+
+    uint64_t dropped_log_records() {
+        return dropped_records.load();
+    }
+
+    namespace binary {
+
+        std::atomic<bool> enabled{false};
+
+        namespace {
+
+            const char magic[8] = {'d', 'a', 't', 'a', 'l', 'o', 'g', '1'};
+            const uint32_t byte_order = 0x01020304;
+
+            // at the end of a buffer, where a record did not fit.
+            const uint32_t skip = 0xffffffff;
+
+            struct site {
+                std::string Channel;
+                severity_level Severity;
+                std::string Format;
+                std::string Signature;
+                std::string File;
+                uint32_t Line;
+            };
+
+            std::mutex sites_mutex;
+            std::vector<site> sites;
+
+            // records that one thread has logged. Only that thread moves
+            // the head and only the writer moves the tail.
+            struct thread_buffer {
+                const uint64_t Capacity;
+                std::unique_ptr<char[]> Data;
+
+                alignas(tool::cache_line) std::atomic<uint64_t> Head;
+                // where the record that is being written starts.
+                uint64_t Start;
+                uint64_t CachedTail;
+
+                alignas(tool::cache_line) std::atomic<uint64_t> Tail;
+                std::atomic<bool> Closed;
+
+                explicit thread_buffer(uint64_t capacity) : Capacity(capacity), Data(new char[capacity]),
+                    Head(0), Start(0), CachedTail(0), Tail(0), Closed(false) {}
+
+                uint64_t mask() const {
+                    return Capacity - 1;
+                }
+            };
+
+            class writer {
+                const binary_options Options;
+                int File;
+
+                std::mutex Buffers;
+                std::vector<std::shared_ptr<thread_buffer>> Threads;
+
+                // statements that have been written to the file.
+                size_t Defined;
+
+                std::mutex M;
+                std::condition_variable Wake;
+                std::condition_variable Done;
+                std::atomic<bool> Sleeping;
+                std::atomic<uint32_t> Flushing;
+                std::atomic<uint64_t> Passes;
+                bool Stopped;
+
+                std::thread Thread;
+
+                void write_all(iovec* v, size_t n) {
+                    while (n > 0) {
+                        ssize_t w = ::writev(File, v, static_cast<int>(std::min<size_t>(n, IOV_MAX)));
+                        if (w < 0) {
+                            if (errno == EINTR) continue;
+                            return;
+                        }
+                        while (n > 0 && static_cast<size_t>(w) >= v->iov_len) {
+                            w -= v->iov_len;
+                            v++;
+                            n--;
+                        }
+                        if (n > 0) {
+                            v->iov_base = static_cast<char*>(v->iov_base) + w;
+                            v->iov_len -= w;
+                        }
+                    }
+                }
+
+                // definitions of statements that were registered since the last pass.
+                void define(std::string& out) {
+                    std::lock_guard<std::mutex> lock(sites_mutex);
+                    for (; Defined < sites.size(); Defined++) {
+                        const site& s = sites[Defined];
+                        uint32_t id = static_cast<uint32_t>(Defined + 1);
+                        uint8_t severity = static_cast<uint8_t>(s.Severity);
+                        std::string args;
+                        args.append(reinterpret_cast<const char*>(&id), 4);
+                        args.append(reinterpret_cast<const char*>(&severity), 1);
+                        args.append(reinterpret_cast<const char*>(&s.Line), 4);
+                        for (const std::string* x : {&s.Channel, &s.Format, &s.Signature, &s.File}) {
+                            args += *x;
+                            args.push_back('\0');
+                        }
+                        header h{0, static_cast<uint32_t>(args.size()), 0};
+                        out.append(reinterpret_cast<const char*>(&h), sizeof(header));
+                        out += args;
+                    }
+                }
+
+                // write everything in the buffers up to where their heads
+                // are now. Returns whether anything was written.
+                bool pass(std::string& definitions, std::vector<iovec>& v,
+                    std::vector<std::pair<thread_buffer*, uint64_t>>& ends) {
+                    std::vector<std::shared_ptr<thread_buffer>> threads;
+                    {
+                        std::lock_guard<std::mutex> lock(Buffers);
+                        // drop the buffers of threads that have finished.
+                        Threads.erase(std::remove_if(Threads.begin(), Threads.end(),
+                            [](const std::shared_ptr<thread_buffer>& b) -> bool {
+                                return b->Closed.load(std::memory_order_acquire) &&
+                                    b->Tail.load(std::memory_order_relaxed) == b->Head.load(std::memory_order_acquire);
+                            }), Threads.end());
+                        threads = Threads;
+                    }
+
+                    v.clear();
+                    ends.clear();
+                    v.push_back(iovec{nullptr, 0});
+
+                    for (const auto& b : threads) {
+                        uint64_t tail = b->Tail.load(std::memory_order_relaxed);
+                        uint64_t head = b->Head.load(std::memory_order_acquire);
+                        if (tail == head) continue;
+
+                        // cut the records into pieces that do not go around the end of the buffer.
+                        uint64_t start = tail;
+                        while (tail < head) {
+                            uint64_t offset = tail & b->mask();
+                            uint64_t remaining = b->Capacity - offset;
+                            uint32_t site = skip;
+                            if (remaining >= sizeof(header)) std::memcpy(&site, &b->Data[offset], 4);
+                            if (site == skip) {
+                                if (tail > start) v.push_back(iovec{&b->Data[start & b->mask()], tail - start});
+                                tail += remaining;
+                                start = tail;
+                                continue;
+                            }
+
+                            uint32_t size;
+                            std::memcpy(&size, &b->Data[offset + 4], 4);
+                            tail += sizeof(header) + size;
+                        }
+                        if (tail > start) v.push_back(iovec{&b->Data[start & b->mask()], tail - start});
+                        ends.emplace_back(b.get(), head);
+                    }
+
+                    // the statements must be defined after we have seen
+                    // the heads, so that every record we write has one.
+                    definitions.clear();
+                    define(definitions);
+                    v[0] = iovec{definitions.data(), definitions.size()};
+
+                    write_all(v.data(), v.size());
+                    for (const auto& e : ends) e.first->Tail.store(e.second, std::memory_order_release);
+                    return ends.size() > 0;
+                }
+
+                void run() {
+                    std::string definitions;
+                    std::vector<iovec> v;
+                    std::vector<std::pair<thread_buffer*, uint64_t>> ends;
+                    auto idle = std::chrono::milliseconds(1);
+                    while (true) {
+                        bool wrote = pass(definitions, v, ends);
+                        Passes.fetch_add(1);
+                        if (Flushing.load() > 0) {
+                            {
+                                std::lock_guard<std::mutex> lock(M);
+                            }
+                            Done.notify_all();
+                        }
+                        if (wrote) {
+                            idle = std::chrono::milliseconds(1);
+                            continue;
+                        }
+
+                        std::unique_lock<std::mutex> lock(M);
+                        if (Stopped) return;
+                        Sleeping.store(true);
+                        // pairs with the fence in wake.
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        if (Flushing.load() == 0) {
+                            Wake.wait_for(lock, idle);
+                            idle = std::min(idle * 2, std::chrono::milliseconds(64));
+                        }
+                        Sleeping.store(false);
+                    }
+                }
+
+            public:
+                writer(const std::string& filename, binary_options o) : Options(o),
+                    File(::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)),
+                    Defined(0), Sleeping(false), Flushing(0), Passes(0), Stopped(false) {
+                    if (File < 0) throw std::runtime_error("could not open log file " + filename);
+                    char start[sizeof(magic) + 4];
+                    std::memcpy(start, magic, sizeof(magic));
+                    std::memcpy(start + sizeof(magic), &byte_order, 4);
+                    iovec v{start, sizeof(start)};
+                    write_all(&v, 1);
+                    Thread = std::thread([this]() {
+                        run();
+                    });
+                }
+
+                // write what is waiting and close the file. A thread that still
+                // has the writer may go on calling wake, which does nothing.
+                void stop() {
+                    {
+                        std::lock_guard<std::mutex> lock(M);
+                        if (Stopped) return;
+                        Stopped = true;
+                    }
+                    Wake.notify_one();
+                    Thread.join();
+                    ::close(File);
+                }
+
+                ~writer() {
+                    stop();
+                }
+
+                const binary_options& options() const {
+                    return Options;
+                }
+
+                std::shared_ptr<thread_buffer> attach() {
+                    auto b = std::make_shared<thread_buffer>(tool::ring_capacity(Options.ThreadBuffer));
+                    std::lock_guard<std::mutex> lock(Buffers);
+                    Threads.push_back(b);
+                    return b;
+                }
+
+                void wake() {
+                    // pairs with the fence in run.
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!Sleeping.load(std::memory_order_relaxed)) return;
+                    {
+                        std::lock_guard<std::mutex> lock(M);
+                    }
+                    Wake.notify_one();
+                }
+
+                // wait for a pass to begin and end after now.
+                void flush() {
+                    uint64_t passes = Passes.load();
+                    Flushing++;
+                    wake();
+                    {
+                        std::unique_lock<std::mutex> lock(M);
+                        Done.wait(lock, [this, passes]() -> bool {
+                            return Passes.load() >= passes + 2;
+                        });
+                    }
+                    Flushing--;
+                }
+            };
+
+            std::mutex current_mutex;
+            // threads keep the writer they attached to until they attach
+            // again, so that one may be replaced while they are logging.
+            std::shared_ptr<writer> current;
+            // changes whenever a log is opened or closed so
+            // that threads know to get a new buffer.
+            std::atomic<uint64_t> generation{0};
+
+            struct local {
+                std::shared_ptr<thread_buffer> Buffer;
+                std::shared_ptr<writer> Writer;
+                uint64_t Generation = 0;
+
+                void close() {
+                    if (Buffer != nullptr) Buffer->Closed.store(true, std::memory_order_release);
+                    Buffer = nullptr;
+                    Writer = nullptr;
+                }
+
+                ~local() {
+                    close();
+                }
+            };
+
+            thread_local local this_thread;
+
+            bool attach() {
+                std::lock_guard<std::mutex> lock(current_mutex);
+                this_thread.close();
+                this_thread.Generation = generation.load();
+                if (current == nullptr) return false;
+                this_thread.Buffer = current->attach();
+                this_thread.Writer = current;
+                return true;
+            }
+        }
+
+        uint32_t define(const char* channel, severity_level severity, const char* format,
+            const char* signature, const char* file, uint32_t line) {
+            std::lock_guard<std::mutex> lock(sites_mutex);
+            sites.push_back(site{channel, severity, format, signature, file, line});
+            return static_cast<uint32_t>(sites.size());
+        }
+
+        char* reserve(uint32_t size) {
+            if (this_thread.Generation != generation.load(std::memory_order_acquire) && !attach()) return nullptr;
+            if (this_thread.Buffer == nullptr) return nullptr;
+
+            thread_buffer& b = *this_thread.Buffer;
+            uint64_t n = sizeof(header) + size;
+            if (n > b.Capacity / 2) {
+                dropped_records++;
+                return nullptr;
+            }
+
+            uint64_t head = b.Head.load(std::memory_order_relaxed);
+            uint64_t remaining = b.Capacity - (head & b.mask());
+            uint64_t start = n > remaining ? head + remaining : head;
+
+            for (int tries = 0; start + n - b.CachedTail > b.Capacity; tries++) {
+                b.CachedTail = b.Tail.load(std::memory_order_acquire);
+                if (start + n - b.CachedTail <= b.Capacity) break;
+                // nothing will empty the buffer of a log that has been replaced.
+                if (this_thread.Writer->options().Overflow == overflow::drop ||
+                    this_thread.Generation != generation.load(std::memory_order_acquire)) {
+                    dropped_records++;
+                    return nullptr;
+                }
+                this_thread.Writer->wake();
+                if (tries < 64) std::this_thread::yield();
+                else std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+
+            // the rest of the buffer is skipped if the record does not fit.
+            if (start != head && remaining >= sizeof(header)) std::memcpy(&b.Data[head & b.mask()], &skip, 4);
+            b.Start = start;
+            return &b.Data[start & b.mask()];
+        }
+
+        void commit(char* end) {
+            thread_buffer& b = *this_thread.Buffer;
+            uint64_t head = b.Start + (end - &b.Data[b.Start & b.mask()]);
+            b.Head.store(head, std::memory_order_release);
+            // the writer looks often enough by itself unless
+            // records are coming in faster than it looks.
+            if (head - b.CachedTail >= b.Capacity / 2) {
+                b.CachedTail = b.Tail.load(std::memory_order_acquire);
+                if (head - b.CachedTail >= b.Capacity / 2) this_thread.Writer->wake();
+            }
+        }
+
+        void flush() {
+            std::lock_guard<std::mutex> lock(current_mutex);
+            if (current != nullptr) current->flush();
+        }
+
+        namespace {
+
+            template <typename X> bool read(std::istream& in, X& x) {
+                return bool(in.read(reinterpret_cast<char*>(&x), sizeof(X)));
+            }
+
+            // read a string that ends in zero from a definition.
+            bool read(const std::string& args, size_t& i, std::string& x) {
+                size_t end = args.find('\0', i);
+                if (end == std::string::npos) return false;
+                x = args.substr(i, end - i);
+                i = end + 1;
+                return true;
+            }
+
+            void write_time(std::ostream& out, uint64_t nanoseconds) {
+                time_t s = static_cast<time_t>(nanoseconds / 1000000000);
+                std::tm t;
+                localtime_r(&s, &t);
+                char text[24];
+                out.write(text, std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &t));
+                out << '.' << std::setw(6) << std::setfill('0') << (nanoseconds % 1000000000) / 1000 << std::setfill(' ');
+            }
+
+            template <typename X> bool write_number(std::ostream& out, const char*& p, const char* end) {
+                X x;
+                if (end - p < static_cast<ptrdiff_t>(sizeof(X))) return false;
+                std::memcpy(&x, p, sizeof(X));
+                p += sizeof(X);
+                if constexpr (sizeof(X) == 1 && std::is_integral_v<X>) out << static_cast<int>(x);
+                else out << x;
+                return true;
+            }
+
+            // write one argument of the given type.
+            bool write_argument(std::ostream& out, char code, const char*& p, const char* end) {
+                switch (code) {
+                    case 'b': {
+                        if (p == end) return false;
+                        out << (*p++ ? "true" : "false");
+                        return true;
+                    }
+                    case 'c': {
+                        if (p == end) return false;
+                        out << *p++;
+                        return true;
+                    }
+                    case 'h': return write_number<int8_t>(out, p, end);
+                    case 's': return write_number<int16_t>(out, p, end);
+                    case 'i': return write_number<int32_t>(out, p, end);
+                    case 'l': return write_number<int64_t>(out, p, end);
+                    case 'H': return write_number<uint8_t>(out, p, end);
+                    case 'S': return write_number<uint16_t>(out, p, end);
+                    case 'I': return write_number<uint32_t>(out, p, end);
+                    case 'L': return write_number<uint64_t>(out, p, end);
+                    case 'f': return write_number<float>(out, p, end);
+                    case 'd': return write_number<double>(out, p, end);
+                    case 'p': {
+                        uint64_t x;
+                        if (end - p < 8) return false;
+                        std::memcpy(&x, p, 8);
+                        p += 8;
+                        out << "0x" << std::hex << x << std::dec;
+                        return true;
+                    }
+                    case 'z': {
+                        uint32_t n;
+                        if (end - p < 4) return false;
+                        std::memcpy(&n, p, 4);
+                        p += 4;
+                        if (static_cast<uint32_t>(end - p) < n) return false;
+                        out.write(p, n);
+                        p += n;
+                        return true;
+                    }
+                    default: return false;
+                }
+            }
+        }
+
+        bool decode(std::istream& in, std::ostream& out) {
+            char m[sizeof(magic)];
+            uint32_t order;
+            if (!in.read(m, sizeof(magic)) || std::memcmp(m, magic, sizeof(magic)) != 0 ||
+                !read(in, order) || order != byte_order) return false;
+
+            std::map<uint32_t, site> defined;
+            std::string args;
+            header h;
+            while (read(in, h)) {
+                args.resize(h.Size);
+                if (!in.read(&args[0], h.Size)) return false;
+
+                if (h.Site == 0) {
+                    uint32_t id;
+                    uint8_t severity;
+                    site s;
+                    if (args.size() < 9) return false;
+                    std::memcpy(&id, args.data(), 4);
+                    std::memcpy(&severity, args.data() + 4, 1);
+                    std::memcpy(&s.Line, args.data() + 5, 4);
+                    s.Severity = static_cast<severity_level>(severity);
+                    size_t i = 9;
+                    if (!read(args, i, s.Channel) || !read(args, i, s.Format) ||
+                        !read(args, i, s.Signature) || !read(args, i, s.File)) return false;
+                    defined[id] = s;
+                    continue;
+                }
+
+                auto d = defined.find(h.Site);
+                if (d == defined.end()) return false;
+                const site& s = d->second;
+
+                out << "[";
+                write_time(out, h.Time);
+                out << "] [" << s.Channel << "] [" << s.Severity << "]: ";
+
+                const char* p = args.data();
+                const char* end = p + args.size();
+                auto code = s.Signature.begin();
+                for (size_t i = 0; i < s.Format.size(); i++) {
+                    if (s.Format[i] == '{' && i + 1 < s.Format.size() && s.Format[i + 1] == '}' && code != s.Signature.end()) {
+                        if (!write_argument(out, *code++, p, end)) return false;
+                        i++;
+                    } else out << s.Format[i];
+                }
+                out << "\n";
+            }
+
+            return in.eof();
+        }
+    }
+
+    void init_binary_logging(std::string filename, binary_options options) {
+        if (options.ThreadBuffer < 2 * sizeof(binary::header))
+            throw std::invalid_argument("binary log needs room for records");
+        std::lock_guard<std::mutex> lock(binary::current_mutex);
+        binary::enabled = false;
+        if (binary::current != nullptr) binary::current->stop();
+        binary::current = std::make_shared<binary::writer>(filename, options);
+        binary::generation++;
+        binary::enabled = true;
+    }
+
+    void close_binary_logging() {
+        std::lock_guard<std::mutex> lock(binary::current_mutex);
+        binary::enabled = false;
+        if (binary::current != nullptr) binary::current->stop();
+        binary::current = nullptr;
+        binary::generation++;
+    }
+
+}
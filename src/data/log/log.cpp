@@ -3,6 +3,25 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "data/log/log.hpp"
+#include "data/log/binary.hpp"
+#include <data/tools/ring.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/make_shared.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
 namespace data::log {
 
     void init_logging(std::string filename) {
@@ -18,26 +37,268 @@ namespace data::log {
 
     }
 
+    static const char* severity_names[] =
+            {
+                    "normal",
+                    "notification",
+                    "warning",
+                    "error",
+                    "critical"
+            };
 
     std::ostream& operator<< (std::ostream& strm, severity_level level)
     {
-        static const char* strings[] =
-                {
-                        "normal",
-                        "notification",
-                        "warning",
-                        "error",
-                        "critical"
-                };
-
-        if (static_cast< std::size_t >(level) < sizeof(strings) / sizeof(*strings))
-            strm << strings[level];
+        if (static_cast< std::size_t >(level) < sizeof(severity_names) / sizeof(*severity_names))
+            strm << severity_names[level];
         else
             strm << static_cast< int >(level);
 
         return strm;
     }
 
+    static std::atomic<uint64_t> dropped_lines{0};
+
+    uint64_t dropped_log_lines() {
+        return dropped_lines.load();
+    }
+
+    namespace {
+
+        // writes into a line, cutting it short if it is full.
+        struct line_writer {
+            char* Line;
+            size_t Capacity;
+            size_t Size;
+
+            void put(const char* x, size_t n) {
+                n = std::min(n, Capacity - Size);
+                std::memcpy(Line + Size, x, n);
+                Size += n;
+            }
+
+            void put(const char* x) {
+                put(x, std::strlen(x));
+            }
+
+            void put(const std::string& x) {
+                put(x.data(), x.size());
+            }
+        };
+
+        // the local time to the microsecond. The date and time
+        // are only formatted again when the second changes.
+        void put_time(line_writer& w) {
+            thread_local time_t second = -1;
+            thread_local char text[24];
+            thread_local size_t size = 0;
+
+            auto now = std::chrono::system_clock::now().time_since_epoch();
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+            time_t s = static_cast<time_t>(micros / 1000000);
+            if (s != second) {
+                std::tm t;
+                localtime_r(&s, &t);
+                size = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &t);
+                second = s;
+            }
+
+            w.put(text, size);
+            char fraction[7] = {'.'};
+            long f = static_cast<long>(micros % 1000000);
+            for (int i = 6; i > 0; i--, f /= 10) fraction[i] = static_cast<char>('0' + f % 10);
+            w.put(fraction, 7);
+        }
+
+        // A sink that formats lines on the thread that logs them and writes
+        // them on its own thread. Lines are kept in one buffer that is
+        // allocated at the start, and the indices of lines that are free and
+        // of lines that are waiting to be written are passed in lock-free rings.
+        class async_backend : public sinks::basic_sink_backend<
+            sinks::combine_requirements<sinks::concurrent_feeding, sinks::flushing>::type> {
+            const async_options Options;
+            int File;
+
+            std::unique_ptr<char[]> Buffer;
+            std::unique_ptr<uint32_t[]> Sizes;
+            tool::mpmc_ring<uint32_t> Free;
+            tool::mpmc_ring<uint32_t> Full;
+
+            std::atomic<uint64_t> Logged;
+            std::atomic<uint64_t> Written;
+
+            std::mutex M;
+            std::condition_variable Wake;
+            std::condition_variable Done;
+            std::atomic<bool> Sleeping;
+            std::atomic<uint32_t> Flushing;
+            bool Stopped;
+
+            std::thread Writer;
+
+            void wake() {
+                // pairs with the fence in write.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!Sleeping.load(std::memory_order_relaxed)) return;
+                {
+                    std::lock_guard<std::mutex> lock(M);
+                }
+                Wake.notify_one();
+            }
+
+            bool take(uint32_t& i) {
+                if (Free.try_pop(i)) return true;
+                if (Options.Overflow == overflow::drop) return false;
+                for (int tries = 0; !Free.try_pop(i); tries++) {
+                    wake();
+                    if (tries < 64) std::this_thread::yield();
+                    else std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+                return true;
+            }
+
+            void write_all(iovec* v, size_t n) {
+                while (n > 0) {
+                    ssize_t w = ::writev(File, v, static_cast<int>(n));
+                    if (w < 0) {
+                        if (errno == EINTR) continue;
+                        return;
+                    }
+                    while (n > 0 && static_cast<size_t>(w) >= v->iov_len) {
+                        w -= v->iov_len;
+                        v++;
+                        n--;
+                    }
+                    if (n > 0) {
+                        v->iov_base = static_cast<char*>(v->iov_base) + w;
+                        v->iov_len -= w;
+                    }
+                }
+            }
+
+            void write() {
+                const size_t batch_size = 64;
+                uint32_t batch[batch_size];
+                iovec v[batch_size];
+                // look less often while nothing is being logged.
+                auto idle = std::chrono::milliseconds(1);
+                while (true) {
+                    size_t n = Full.try_pop(batch, batch_size);
+                    if (n == 0) {
+                        std::unique_lock<std::mutex> lock(M);
+                        Sleeping.store(true);
+                        // pairs with the fence in wake.
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        n = Full.try_pop(batch, batch_size);
+                        if (n == 0) {
+                            if (Stopped) return;
+                            Wake.wait_for(lock, idle);
+                            idle = std::min(idle * 2, std::chrono::milliseconds(64));
+                            Sleeping.store(false);
+                            continue;
+                        }
+                        Sleeping.store(false);
+                    }
+                    idle = std::chrono::milliseconds(1);
+
+                    for (size_t i = 0; i < n; i++) v[i] = iovec{&Buffer[batch[i] * Options.LineSize], Sizes[batch[i]]};
+                    write_all(v, n);
+                    Free.try_push(batch, n);
+                    Written.fetch_add(n);
+
+                    if (Flushing.load() > 0) {
+                        {
+                            std::lock_guard<std::mutex> lock(M);
+                        }
+                        Done.notify_all();
+                    }
+                }
+            }
+
+            // checked before anything is opened or allocated.
+            static async_options check(async_options o) {
+                if (o.Lines == 0 || o.LineSize < 2) throw std::invalid_argument("async log needs room for lines");
+                return o;
+            }
+
+        public:
+            async_backend(const std::string& filename, async_options o) :
+                Options(check(o)), File(::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+                Buffer(new char[o.Lines * o.LineSize]), Sizes(new uint32_t[o.Lines]),
+                Free(o.Lines), Full(o.Lines), Logged(0), Written(0),
+                Sleeping(false), Flushing(0), Stopped(false) {
+                if (File < 0) throw std::runtime_error("could not open log file " + filename);
+                for (uint32_t i = 0; i < o.Lines; i++) Free.try_push(i);
+                Writer = std::thread([this]() {
+                    write();
+                });
+            }
+
+            ~async_backend() {
+                {
+                    std::lock_guard<std::mutex> lock(M);
+                    Stopped = true;
+                }
+                Wake.notify_one();
+                Writer.join();
+                ::close(File);
+            }
+
+            void consume(const logging::record_view& rec) {
+                uint32_t i;
+                if (!take(i)) {
+                    dropped_lines++;
+                    return;
+                }
+
+                // leave room for the newline.
+                line_writer w{&Buffer[i * Options.LineSize], Options.LineSize - 1, 0};
+                w.put("[");
+                put_time(w);
+                w.put("] [");
+                if (auto channel = logging::extract<std::string>("Channel", rec)) w.put(*channel);
+                w.put("] [");
+                if (auto level = rec[severity]) {
+                    if (static_cast<std::size_t>(*level) < sizeof(severity_names) / sizeof(*severity_names))
+                        w.put(severity_names[*level]);
+                    else w.put(std::to_string(static_cast<int>(*level)));
+                }
+                w.put("]: ");
+                if (auto message = rec[expr::smessage]) w.put(*message);
+                w.Line[w.Size] = '\n';
+                Sizes[i] = static_cast<uint32_t>(w.Size + 1);
+
+                uint64_t logged = Logged.fetch_add(1) + 1;
+                Full.try_push(i);
+                // the writer looks for lines often enough by itself
+                // unless they are coming in faster than it looks.
+                if (logged - Written.load(std::memory_order_relaxed) >= Options.Lines / 2) wake();
+            }
+
+            void flush() {
+                uint64_t logged = Logged.load();
+                Flushing++;
+                wake();
+                {
+                    std::unique_lock<std::mutex> lock(M);
+                    Done.wait(lock, [this, logged]() -> bool {
+                        return Written.load() >= logged;
+                    });
+                }
+                Flushing--;
+            }
+        };
+    }
+
+    void init_async_logging(std::string filename, async_options options) {
+        auto backend = boost::make_shared<async_backend>(filename, options);
+        logging::core::get()->add_sink(boost::make_shared<sinks::unlocked_sink<async_backend>>(backend));
+    }
+
+    void flush_logging() {
+        logging::core::get()->flush();
+        binary::flush();
+    }
+
 
 
 void testLog(){
@@ -47,4 +308,4 @@ void testLog(){
 
 
 
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include <data/data.hpp>
 #include <data/math/number/bytes/Z.hpp>
 #include <data/encoding/digits.hpp>
+#include <cstring>
 
 namespace data::math::number::gmp {
     
@@ -18,6 +19,17 @@ namespace data::math::number::gmp {
         return z;
     }
     
+    std::string write_digits(const N& n, uint32 base) {
+        std::string o(mpz_sizeinbase(n.Value.MPZ, base) + 2, '\0');
+        mpz_get_str(o.data(), base, n.Value.MPZ);
+        o.resize(std::strlen(o.data()));
+        return o;
+    }
+    
+    void read_digits(N& n, const std::string& digits, uint32 base) {
+        if (mpz_set_str(n.Value.MPZ, digits.c_str(), base) != 0) n = N{0};
+    }
+    
     Z Z_read_N_data(string_view x) {
         if (encoding::decimal::valid(x)) {
             string s{x};
@@ -171,40 +183,10 @@ namespace data::math::number::gmp {
         return Z_write_dec(o, n.Value);
     }
     
-    // inefficient but easier to write and more certain to be correct. 
-    N read_bytes_big(bytes_view x) {
-        std::stringstream format_stream;
-        format_stream << "0x" << encoding::hex::write(x);
-        return N{format_stream.str()};
-    }
-    
-    N read_bytes_little(bytes_view x) {
-        auto z = std::basic_string<byte>{x};
-        std::reverse(z.begin(), z.end());
-        return read_bytes_big(z);
-    }
-    
     N read_bytes(bytes_view x, endian::order o) {
-        if (o == endian::order::big) return read_bytes_big(x);
-        return read_bytes_little(x);
-        /* 
-        N r{0};
-        if (x.size() > 0) { 
-            if (o == endian::order::little) {
-                r += x[0];
-                for (int i = 1; i < x.size(); i++) {
-                    r <<= 8;
-                    r += x[i];
-                }
-            } else {
-                r += x[x.size() - 1];
-                for (int i = x.size() - 2; i >= 0; i--) {
-                    r <<= 0;
-                    r += x[i];
-                }
-            }
-        }
-        return r;*/
+        N n{0};
+        if (x.size() > 0) mpz_import(n.Value.MPZ, x.size(), o == endian::big ? 1 : -1, 1, 0, 0, x.data());
+        return n;
     }
     
     N::N(bytes_view x, endian::order o) : Value{read_bytes(x, o).Value} {}
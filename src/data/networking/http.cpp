@@ -4,76 +4,509 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <data/networking/http.hpp>
+#include <boost/asio/strand.hpp>
+#include <array>
 #include <iostream>
+#include <limits>
+#include <optional>
 
 namespace data::networking {
 
-    http::http() :
-        ssl_ctx(boost::asio::ssl::context::tlsv12_client),
-        resolver(ioc) {
+    namespace {
+        void configure(boost::asio::ssl::context& ssl_ctx) {
             ssl_ctx.set_default_verify_paths();
             ssl_ctx.set_verify_mode(boost::asio::ssl::verify_peer);
+            // keep sessions so that we can resume them. 
+            SSL_CTX_set_session_cache_mode(ssl_ctx.native_handle(), SSL_SESS_CACHE_CLIENT);
         }
+    }
+    
+    http::http() : http(options{}) {}
+    
+    http::http(options o) : Options(o), Owned(std::make_unique<boost::asio::io_context>()), ioc(*Owned),
+        ssl_ctx(boost::asio::ssl::context::tlsv12_client) {
+            configure(ssl_ctx);
+        }
+    
+    http::http(boost::asio::io_context& x) : http(x, options{}) {}
+    
+    http::http(boost::asio::io_context& x, options o) : Options(o), ioc(x),
+        ssl_ctx(boost::asio::ssl::context::tlsv12_client) {
+            configure(ssl_ctx);
+        }
+    
+    http::~http() {
+        for (auto& h : Hosts) if (h.second.Session != nullptr) SSL_SESSION_free(h.second.Session);
+    }
         
-    string http::append_params(string path, const std::map<string, string>& params) {
-        string newPath=path;
-        if(params.size()>0) {
-            newPath.append("?");
-            for (const auto &it : params) {
-                newPath.append(it.first+"="+it.second+"&");
+    namespace {
+        
+        bool unreserved(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || 
+                c == '-' || c == '.' || c == '_' || c == '~';
+        }
+        
+        void append_encoded(string& out, string_view x) {
+            static const char digits[] = "0123456789ABCDEF";
+            for (char c : x) {
+                if (unreserved(c)) {
+                    out.push_back(c);
+                    continue;
+                }
+                unsigned char u = static_cast<unsigned char>(c);
+                char escaped[3] = {'%', digits[u >> 4], digits[u & 15]};
+                out.append(escaped, 3);
             }
-            newPath.pop_back();
         }
-        return newPath;
+        
+        // key=value&key=value, encoded. 
+        void append_pairs(string& out, const std::map<string, string>& pairs) {
+            size_t size = 0;
+            for (const auto& it : pairs) size += it.first.size() + it.second.size() + 2;
+            out.reserve(out.size() + size + size / 2);
+            for (const auto& it : pairs) {
+                if (&it != &*pairs.begin()) out.push_back('&');
+                append_encoded(out, it.first);
+                out.push_back('=');
+                append_encoded(out, it.second);
+            }
+        }
+        
+        // a request that may have reached the server is only sent again if 
+        // doing it twice is the same as doing it once. RFC 9110 9.2.2. 
+        bool idempotent(http::method m) {
+            return m == http::method::get || m == http::method::head || m == http::method::options || 
+                m == http::method::trace || m == http::method::put || m == http::method::delete_;
+        }
+    }
+    
+    string http::url_encode(string_view x) {
+        string out;
+        out.reserve(x.size());
+        append_encoded(out, x);
+        return out;
+    }
+    
+    string http::append_params(string path, const std::map<string, string>& params) {
+        if (params.empty()) return path;
+        path.push_back('?');
+        append_pairs(path, params);
+        return path;
     }
     
     string encode_form_data(const std::map<string, string>& form_data) {
-        string newBody;
-        if(form_data.size()>0) {
-            for (const auto &it : form_data) {
-                newBody.append(it.first+"="+it.second+"&");
-            }
-            newBody.pop_back();
+        string body;
+        append_pairs(body, form_data);
+        return body;
+    }
+    
+    struct http::connection {
+        std::unique_ptr<boost::beast::ssl_stream<boost::beast::tcp_stream>> Secure;
+        std::unique_ptr<boost::beast::tcp_stream> Plain;
+        boost::beast::flat_buffer Buffer;
+        
+        // requests that are waiting to be written. 
+        string Out;
+        size_t Waiting = 0;
+        // bytes that have gone out on the connection. 
+        uint64 Written = 0;
+        // pieces of bodies for stream. 
+        std::unique_ptr<char[]> Chunk;
+        
+        std::chrono::steady_clock::time_point Used;
+        // whether the TLS session has been saved for the host. 
+        bool Saved = false;
+        
+        template <typename F> void with(F f) {
+            if (Secure != nullptr) f(*Secure);
+            else f(*Plain);
         }
-        return newBody;
+        
+        boost::beast::tcp_stream& lowest() {
+            if (Secure != nullptr) return boost::beast::get_lowest_layer(*Secure);
+            return *Plain;
+        }
+    };
+    
+    bool http::resolved(const key& k, addresses& a) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        host& h = Hosts[k];
+        if (h.Addresses.empty() || clock::now() - h.Resolved >= Options.DNSLifetime) return false;
+        a = h.Addresses;
+        return true;
     }
     
-    string http::request(string port, method verb, string hostname, string path, const std::map<header, string> &headers, string body) {
-        boost::beast::ssl_stream<boost::beast::tcp_stream> stream(ioc, ssl_ctx);
+    void http::resolved(const key& k, const addresses& a) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        host& h = Hosts[k];
+        h.Addresses = a;
+        h.Resolved = clock::now();
+    }
+    
+    std::unique_ptr<http::connection> http::make(const key& k, boost::system::error_code& ec) {
+        // a strand, since the threads that run ioc may complete our operations. 
+        auto c = std::make_unique<connection>();
+        if (!Options.TLS) {
+            c->Plain = std::make_unique<boost::beast::tcp_stream>(boost::asio::make_strand(ioc));
+            return c;
+        }
+        
+        c->Secure = std::make_unique<boost::beast::ssl_stream<boost::beast::tcp_stream>>(boost::asio::make_strand(ioc), ssl_ctx);
+        auto& stream = *c->Secure;
         
         // Set SNI Hostname (many hosts need this to handshake successfully)
-        if(! SSL_set_tlsext_host_name(stream.native_handle(), hostname.c_str()))
+        if(! SSL_set_tlsext_host_name(stream.native_handle(), k.first.c_str()))
         {
-            boost::beast::error_code ec{static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()};
-            throw boost::beast::system_error{ec};
+            ec = boost::beast::error_code{static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()};
+            return nullptr;
         }
-
-        auto const results = resolver.resolve(hostname.c_str(), port.c_str());
-
-        boost::beast::get_lowest_layer(stream).connect(results);
-        stream.handshake(boost::asio::ssl::stream_base::client);
-
-        boost::beast::http::request<boost::beast::http::string_body> req(verb, path.c_str(), 11);
-
-        req.set(header::host,hostname.c_str());
+        
+        // resume the last session with this host rather than make a new one. 
+        std::lock_guard<std::mutex> lock(Mutex);
+        SSL_SESSION* session = Hosts[k].Session;
+        if (session != nullptr) SSL_set_session(stream.native_handle(), session);
+        return c;
+    }
+    
+    void http::save(const key& k, connection& c) {
+        if (c.Secure == nullptr || c.Saved) return;
+        c.Saved = true;
+        SSL_SESSION* session = SSL_get1_session(c.Secure->native_handle());
+        std::lock_guard<std::mutex> lock(Mutex);
+        host& h = Hosts[k];
+        if (h.Session != nullptr) SSL_SESSION_free(h.Session);
+        h.Session = session;
+    }
+    
+    http::request_message http::prepare(const key& k, const call& x) const {
+        request_message req(x.Method, x.Path.c_str(), 11);
+        
+        req.set(header::host, k.first.c_str());
         req.set(header::user_agent, BOOST_BEAST_VERSION_STRING);
-
-        for(const auto & header : headers) {
+        
+        for(const auto & header : x.Headers) {
             req.set(header.first,header.second);
         }
-        req.body() = body;
+        req.body() = boost::beast::span<const char>(x.Body.data(), x.Body.size());
         req.prepare_payload();
-        boost::beast::http::write(stream, req);
-
-        boost::beast::flat_buffer buffer;
-        boost::beast::http::response<boost::beast::http::dynamic_body> res;
+        req.keep_alive(Options.Connections > 0);
+        return req;
+    }
+    
+    namespace {
+        // bodies larger than this are not copied. 
+        const size_t copy_limit = 16384;
+        // how much we put in a connection's buffer before we write it. 
+        const size_t flush_size = 65536;
+    }
+    
+    size_t http::send(connection& c, const key& k, const call& x, bool flush, boost::system::error_code& ec) {
+        auto req = prepare(k, x);
+        boost::beast::http::request_serializer<boost::beast::http::span_body<const char>> sr{req};
+        sr.split(true);
+        while (!sr.is_header_done()) sr.next(ec, [&c, &sr](boost::system::error_code&, const auto& buffers) {
+            for (auto b : boost::beast::buffers_range_ref(buffers)) c.Out.append(static_cast<const char*>(b.data()), b.size());
+            sr.consume(boost::beast::buffer_bytes(buffers));
+        });
+        if (ec) return 0;
+        
+        // the body follows the header as it is, since its length is given. 
+        string_view large;
+        if (x.Body.size() > copy_limit) large = x.Body;
+        else c.Out.append(x.Body);
+        c.Waiting++;
+        
+        if (!flush && large.empty() && c.Out.size() < flush_size) return 0;
+        std::array<boost::asio::const_buffer, 2> buffers{
+            boost::asio::buffer(c.Out), boost::asio::buffer(large.data(), large.size())};
+        c.with([&c, &buffers, &ec](auto& stream) {
+            c.Written += boost::asio::write(stream, buffers, ec);
+        });
+        
+        size_t written = c.Waiting;
+        c.Out.clear();
+        c.Waiting = 0;
+        return ec ? 0 : written;
+    }
+    
+    std::unique_ptr<http::connection> http::open(const key& k) {
+        addresses a;
+        if (!resolved(k, a)) {
+            boost::asio::ip::tcp::resolver resolver(ioc);
+            a = resolver.resolve(k.first.c_str(), k.second.c_str());
+            resolved(k, a);
+        }
+        
+        boost::system::error_code ec;
+        auto c = make(k, ec);
+        if (ec) throw boost::beast::system_error{ec};
+        
+        c->lowest().connect(a);
+        c->lowest().socket().set_option(boost::asio::ip::tcp::no_delay(true));
+        if (c->Secure != nullptr) c->Secure->handshake(boost::asio::ssl::stream_base::client);
+        return c;
+    }
+    
+    std::unique_ptr<http::connection> http::take(const key& k) {
+        std::unique_ptr<connection> c;
+        auto now = clock::now();
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto& idle = Hosts[k].Idle;
+        while (!idle.empty()) {
+            c = std::move(idle.back());
+            idle.pop_back();
+            if (now - c->Used < Options.IdleTimeout) return c;
+        }
+        return nullptr;
+    }
+    
+    void http::give(const key& k, std::unique_ptr<connection> c) {
+        if (Options.Connections == 0) return;
+        c->Used = clock::now();
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto& idle = Hosts[k].Idle;
+        if (idle.size() < Options.Connections) idle.push_back(std::move(c));
+    }
+    
+    size_t http::exchange(const key& k, const std::vector<call>& calls, size_t from, std::vector<string>& out) {
+        std::unique_ptr<connection> c = take(k);
+        // a connection that we have used before may have been closed by the 
+        // server while it was idle. Then we try again with a new one, unless 
+        // a request that cannot safely be repeated may have been received. 
+        bool reused = c != nullptr;
+        if (!reused) c = open(k);
+        
+        size_t sent = 0;
+        size_t read = 0;
+        // requests that were given to send, some of which may have been written. 
+        size_t tried = 0;
+        uint64 written = c->Written;
+        bool alive = true;
+        bool writable = true;
+        size_t pipeline = std::max<size_t>(Options.Pipeline, 1);
         boost::beast::error_code ec;
-
-        try {
-            boost::beast::http::read(stream, buffer, res,ec);
-        } catch(boost::exception& ex) {}
-
-        return boost::beast::buffers_to_string(res.body().data());
+        
+        // whether to try again with a new connection after getting nothing back. 
+        auto retry = [&]() -> bool {
+            if (c->Written == written) return true;
+            for (size_t i = from; i < from + tried; i++) if (!idempotent(calls[i].Method)) return false;
+            return true;
+        };
+        
+        while (alive && from + read < calls.size()) {
+            // requests that are written together go in one buffer. 
+            while (writable && from + sent + c->Waiting < calls.size() && sent + c->Waiting - read < pipeline) {
+                size_t next = sent + c->Waiting + 1;
+                tried = next;
+                sent += send(*c, k, calls[from + next - 1], from + next == calls.size() || next - read == pipeline, ec);
+                
+                // the server may have closed the connection after a response 
+                // that we have not read yet, so we still read what we sent. 
+                if (ec) writable = false;
+            }
+            
+            if (sent == read) {
+                if (read == 0 && (!reused || !retry())) throw boost::beast::system_error{ec};
+                alive = false;
+                break;
+            }
+            
+            boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+            parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+            // a response to HEAD has no body to read. 
+            if (calls[from + read].Method == method::head) parser.skip(true);
+            c->with([&c, &parser, &ec](auto& stream) {
+                boost::beast::http::read(stream, c->Buffer, parser, ec);
+            });
+            
+            if (ec) {
+                alive = false;
+                if (read == 0 && reused && !retry()) throw boost::beast::system_error{ec};
+                if (read == 0 && !reused) out[from] = parser.get().body();
+                break;
+            }
+            
+            auto res = parser.release();
+            alive = res.keep_alive();
+            out[from + read] = std::move(res.body());
+            read++;
+        }
+        
+        if (read == 0 && reused) return exchange(k, calls, from, out);
+        
+        if (read > 0) save(k, *c);
+        
+        if (alive && sent == read) give(k, std::move(c));
+        return read;
+    }
+    
+    std::vector<string> http::pipeline(string port, string hostname, const std::vector<call>& calls) {
+        std::vector<string> out(calls.size());
+        key k{hostname, port};
+        size_t done = 0;
+        while (done < calls.size()) {
+            size_t n = exchange(k, calls, done, out);
+            // a new connection was closed without a response. 
+            if (n == 0) break;
+            done += n;
+        }
+        return out;
+    }
+    
+    // one request for async_request. It holds itself alive through
+    // the handlers of the operations that it is waiting for. 
+    struct http::async_call : std::enable_shared_from_this<async_call> {
+        http& Client;
+        const key Key;
+        const method Method;
+        const clock::time_point Deadline;
+        std::function<completion> Done;
+        
+        const call Call;
+        request_message Request;
+        std::unique_ptr<connection> Connection;
+        bool Reused;
+        // whether any of the request went out on the connection. 
+        bool Written;
+        boost::asio::ip::tcp::resolver Resolver;
+        std::optional<boost::beast::http::response_parser<boost::beast::http::string_body>> Parser;
+        
+        async_call(http& client, const key& k, const call& c, clock::time_point deadline, std::function<completion> done) :
+            Client(client), Key(k), Method(c.Method), Deadline(deadline), Done(std::move(done)),
+            Call(c), Request(client.prepare(k, Call)), Reused(false), Written(false), Resolver(boost::asio::make_strand(client.ioc)) {}
+        
+        void start() {
+            Connection = Client.take(Key);
+            Reused = Connection != nullptr;
+            if (Reused) send();
+            else resolve();
+        }
+        
+        void resolve() {
+            addresses a;
+            if (Client.resolved(Key, a)) return connect(a);
+            Resolver.async_resolve(Key.first, Key.second, [self = shared_from_this()](boost::system::error_code ec, addresses a) {
+                if (ec) return self->Done(ec, "");
+                self->Client.resolved(self->Key, a);
+                self->connect(a);
+            });
+        }
+        
+        void connect(const addresses& a) {
+            boost::system::error_code ec;
+            Connection = Client.make(Key, ec);
+            if (ec) return Done(ec, "");
+            Connection->lowest().expires_at(Deadline);
+            Connection->lowest().async_connect(a, [self = shared_from_this()](
+                boost::system::error_code ec, boost::asio::ip::tcp::endpoint) {
+                if (ec) return self->Done(ec, "");
+                self->Connection->lowest().socket().set_option(boost::asio::ip::tcp::no_delay(true), ec);
+                if (self->Connection->Secure == nullptr) return self->send();
+                self->Connection->lowest().expires_at(self->Deadline);
+                self->Connection->Secure->async_handshake(boost::asio::ssl::stream_base::client,
+                    [self](boost::system::error_code ec) {
+                        if (ec) return self->Done(ec, "");
+                        self->send();
+                    });
+            });
+        }
+        
+        void send() {
+            Connection->lowest().expires_at(Deadline);
+            Connection->with([self = shared_from_this()](auto& stream) {
+                boost::beast::http::async_write(stream, self->Request, [self](boost::system::error_code ec, size_t n) {
+                    self->Written = n > 0;
+                    if (ec) return self->retry(ec);
+                    self->receive();
+                });
+            });
+        }
+        
+        void receive() {
+            Parser.emplace();
+            Parser->body_limit(std::numeric_limits<std::uint64_t>::max());
+            // a response to HEAD has no body to read. 
+            if (Method == method::head) Parser->skip(true);
+            Connection->lowest().expires_at(Deadline);
+            Connection->with([self = shared_from_this()](auto& stream) {
+                boost::beast::http::async_read(stream, self->Connection->Buffer, *self->Parser,
+                    [self](boost::system::error_code ec, size_t) {
+                        if (ec) return self->retry(ec);
+                        auto res = self->Parser->release();
+                        self->Connection->lowest().expires_never();
+                        self->Client.save(self->Key, *self->Connection);
+                        if (res.keep_alive()) self->Client.give(self->Key, std::move(self->Connection));
+                        self->Done(ec, std::move(res.body()));
+                    });
+            });
+        }
+        
+        // a connection from the pool may have been closed by the 
+        // server while it was idle. Then we try again with a new one, 
+        // unless the server may have received a request that cannot 
+        // safely be repeated. 
+        void retry(boost::system::error_code ec) {
+            if (!Reused || ec == boost::beast::error::timeout || (Written && !idempotent(Method))) return Done(ec, "");
+            Reused = false;
+            Written = false;
+            Connection = nullptr;
+            resolve();
+        }
+    };
+    
+    void http::start(const key& k, call c, clock::time_point deadline, std::function<completion> done) {
+        std::make_shared<async_call>(*this, k, c, deadline, std::move(done))->start();
+    }
+    
+    http::status http::stream(string port, string hostname, const call& x, const sink& f) {
+        const size_t chunk_size = 65536;
+        key k{hostname, port};
+        std::unique_ptr<connection> c = take(k);
+        bool reused = c != nullptr;
+        if (!reused) c = open(k);
+        
+        boost::beast::error_code ec;
+        uint64 written = c->Written;
+        send(*c, k, x, true, ec);
+        
+        boost::beast::http::response_parser<boost::beast::http::buffer_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        if (x.Method == method::head) parser.skip(true);
+        if (!ec) c->with([&c, &parser, &ec](auto& stream) {
+            boost::beast::http::read_header(stream, c->Buffer, parser, ec);
+        });
+        
+        // a connection from the pool may have been closed by the 
+        // server while it was idle. Then we try again with a new one, 
+        // unless the server may have received a request that cannot 
+        // safely be repeated. 
+        if (ec) {
+            if (reused && (c->Written == written || idempotent(x.Method))) return stream(port, hostname, x, f);
+            throw boost::beast::system_error{ec};
+        }
+        
+        if (c->Chunk == nullptr) c->Chunk.reset(new char[chunk_size]);
+        while (!parser.is_done()) {
+            parser.get().body().data = c->Chunk.get();
+            parser.get().body().size = chunk_size;
+            c->with([&c, &parser, &ec](auto& stream) {
+                boost::beast::http::read(stream, c->Buffer, parser, ec);
+            });
+            // the chunk is full. 
+            if (ec == boost::beast::http::error::need_buffer) ec = {};
+            if (ec) throw boost::beast::system_error{ec};
+            size_t n = chunk_size - parser.get().body().size;
+            if (n > 0) f(string_view(c->Chunk.get(), n));
+        }
+        
+        save(k, *c);
+        status result = parser.get().result();
+        if (parser.get().keep_alive()) give(k, std::move(c));
+        return result;
+    }
+    
+    string http::request(string port, method verb, string hostname, string path, const std::map<header, string> &headers, string body) {
+        return pipeline(port, hostname, {call{verb, path, headers, body}})[0];
     }
 
     string http::POST(string hostname, string path, const std::map<string, string> &params,
@@ -3,28 +3,94 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 #include "data/tools/rate_limiter.h"
 #include <chrono>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 namespace data {
     namespace tools {
 
         long rate_limiter::getTime() {
             long now = std::chrono::duration_cast<std::chrono::seconds>(
                     std::chrono::system_clock::now().time_since_epoch()).count();
-            long lastSent=m_queue.getValue();
+            long lastSent=m_queue.front();
             if(lastSent == -1) {
-                m_queue.setValue(now);
-                m_queue.next();
+                m_queue.push(now);
                 return 0;
             }
             if(now-lastSent < m_duration) {
                 long wait_name = m_duration - (now-lastSent);
-                m_queue.setValue(now+wait_name);
-                m_queue.next();
+                m_queue.push(now+wait_name);
                 return wait_name;
             }
-            m_queue.setValue(now);
-            m_queue.next();
+            m_queue.push(now);
             return 0;
         }
+
+        namespace {
+            int64_t nanoseconds(token_bucket::clock::duration d) {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+            }
+
+            int64_t nanoseconds(token_bucket::clock::time_point t) {
+                return nanoseconds(t.time_since_epoch());
+            }
+
+            int64_t interval(uint32_t hits, token_bucket::clock::duration duration) {
+                if (hits == 0) throw std::invalid_argument("rate limiter must allow some hits");
+                return std::max<int64_t>(1, nanoseconds(duration) / hits);
+            }
+        }
+
+        token_bucket::token_bucket(uint32_t hits, clock::duration duration, uint32_t burst) :
+            m_interval(interval(hits, duration)), m_burst(burst), m_full(0) {
+            if (burst == 0) throw std::invalid_argument("rate limiter must allow some hits");
+        }
+
+        std::optional<int64_t> token_bucket::take(uint32_t n, int64_t now, int64_t wait) {
+            if (n > m_burst) return {};
+            int64_t full = m_full.load(std::memory_order_relaxed);
+            while (true) {
+                // the bucket will be full again once the tokens
+                // we take have been made, and the tokens are there
+                // once it is no more than burst tokens from full.
+                int64_t next = std::max(full, now) + n * m_interval;
+                int64_t ready = next - m_burst * m_interval - now;
+                if (ready > wait) return {};
+                if (m_full.compare_exchange_weak(full, next, std::memory_order_relaxed))
+                    return std::max<int64_t>(0, ready);
+            }
+        }
+
+        bool token_bucket::try_acquire(uint32_t n, clock::time_point now) {
+            return take(n, nanoseconds(now), 0).has_value();
+        }
+
+        std::optional<token_bucket::clock::duration> token_bucket::acquire_until(
+            clock::time_point deadline, uint32_t n, clock::time_point now) {
+            std::optional<int64_t> wait = take(n, nanoseconds(now), std::max<int64_t>(0, nanoseconds(deadline - now)));
+            if (!wait) return {};
+            return std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(*wait));
+        }
+
+        void token_bucket::acquire(uint32_t n) {
+            if (n > m_burst) throw std::invalid_argument("more tokens than the bucket holds");
+            std::optional<int64_t> wait = take(n, nanoseconds(clock::now()), std::numeric_limits<int64_t>::max());
+            if (*wait > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(*wait));
+        }
+
+        token_bucket& keyed_rate_limiter::operator[](const std::string& k) {
+            shard& s = m_shards[std::hash<std::string>{}(k) % shards];
+            {
+                std::shared_lock<std::shared_mutex> lock(s.m_mutex);
+                auto b = s.m_buckets.find(k);
+                if (b != s.m_buckets.end()) return *b->second;
+            }
+
+            std::unique_lock<std::shared_mutex> lock(s.m_mutex);
+            auto& b = s.m_buckets[k];
+            if (b == nullptr) b = std::make_unique<token_bucket>(m_hits, m_duration, m_burst);
+            return *b;
+        }
     }
 }
-
@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "gmock/gmock-matchers.h"
+#include <random>
 
 namespace data::encoding {
     
@@ -17,6 +18,14 @@ namespace data::encoding {
         EXPECT_TRUE(base58::valid("KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMcHPj74cgBWRmRvBS"));
         EXPECT_TRUE(base58::valid("3m8npvpNDU6k8zcAH8RBcUZeDLWx"));
         EXPECT_FALSE(base58::valid("KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMIHPj74cgBWRmRvBS"));
+        EXPECT_FALSE(base58::valid("KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMcHPj74cgBWRmRvB0"));
+        EXPECT_FALSE(base58::valid("KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMcHPj74cgBWRmRvBl"));
+        EXPECT_FALSE(base58::valid("KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMcHPj74cgBWRmRvBO"));
+        EXPECT_TRUE(base58::valid("1"));
+        EXPECT_FALSE(base58::valid("11"));
+        EXPECT_FALSE(base58::valid("1z"));
+        EXPECT_FALSE(base58::valid(""));
+        EXPECT_TRUE(base58::valid(string_view{"3m8n0", 4}));
     }
     
     TEST(Base58Test, Base58Invert) {
@@ -57,4 +66,64 @@ namespace data::encoding {
         ASSERT_STREQ(base58::write(bytes_view(testArray)).c_str(),"KzFvxm6N9qW11MbVoZM8c3tp6UHqf1qrh9EMcHPj74cgBWRmRvBS");
     }
     
+    TEST(Base58Test, Base58EncodeDecode) {
+        // vectors from Bitcoin Core. 
+        std::vector<std::pair<std::string, std::string>> vectors{
+            {"", ""}, 
+            {"61", "2g"}, 
+            {"626262", "a3gV"}, 
+            {"73696d706c792061206c6f6e6720737472696e67", "2cFupjhnEsSn59qHXstmK2ffpLv2"}, 
+            {"00eb15231dfceb60925886b67d065299925915aeb172c06647", "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L"}, 
+            {"516b6fcd0f", "ABnLTmg"}, 
+            {"bf4f89001e670274dd", "3SEo3LWLoPntC"}, 
+            {"572e4794", "3EFU7m"}, 
+            {"ecac89cad93923c02321", "EJDM8drfXA6uyA"}, 
+            {"10c8511e", "Rt5zm"}, 
+            {"00000000000000000000", "1111111111"}, 
+            {"000111d38e5fc9071ffcd20b4a763cc9ae4f252bb4e48fd66a835e252ada93ff480d6dd43dc62a641155a5", 
+                "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"}};
+        
+        for (const auto& v : vectors) {
+            bytes b = *hex::read(v.first);
+            EXPECT_EQ(base58::encode(b), v.second);
+            bytes decoded;
+            EXPECT_TRUE(base58::decode(decoded, v.second));
+            EXPECT_EQ(decoded, b);
+        }
+        
+        bytes decoded;
+        EXPECT_FALSE(base58::decode(decoded, "3SEo3LWLoPntC0"));
+        EXPECT_FALSE(base58::decode(decoded, "I"));
+        EXPECT_FALSE(base58::decode(decoded, "a3g V"));
+    }
+    
+    TEST(Base58Test, Base58EncodeAsNumber) {
+        // without leading zeros, bytes are written the same as numbers. 
+        std::mt19937 random(1);
+        for (int size = 1; size < 600; size += size < 100 ? 1 : 200) {
+            bytes b(size);
+            for (byte& x : b) x = static_cast<byte>(random());
+            b[0] |= 1;
+            std::string expected = base58::write<N>(N{N_bytes<endian::big>(bytes_view(b))});
+            EXPECT_EQ(base58::encode(b), expected);
+            EXPECT_EQ(base58::write(bytes_view(b)), expected);
+            bytes decoded;
+            EXPECT_TRUE(base58::decode(decoded, expected));
+            EXPECT_EQ(decoded, b);
+        }
+    }
+    
+    TEST(Base58Test, Base58Check) {
+        bytes payload = *hex::read(std::string("007680adec8eabcabac676be9e83854ade0bd22cdb"));
+        EXPECT_EQ(base58::check::encode(payload), "1BoatSLRHtKNngkdXEeobR76b53LETtpyT");
+        EXPECT_EQ(base58::check::encode(bytes(21, 0)), "1111111111111111111114oLvT2");
+        
+        bytes decoded;
+        EXPECT_TRUE(base58::check::decode(decoded, "1BoatSLRHtKNngkdXEeobR76b53LETtpyT"));
+        EXPECT_EQ(decoded, payload);
+        EXPECT_FALSE(base58::check::decode(decoded, "1BoatSLRHtKNngkdXEeobR76b53LETtpyt"));
+        EXPECT_FALSE(base58::check::decode(decoded, "1BoatSLRHtKNngkdXEeobR76b53LETtpy"));
+        EXPECT_FALSE(base58::check::decode(decoded, "2g"));
+    }
+    
 }
@@ -0,0 +1,182 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "data/encoding/base64.hpp"
+#include "gtest/gtest.h"
+#include <random>
+
+namespace data::encoding::base64 {
+    
+    std::string encode_string(bytes_view b, alphabet a = standard) {
+        std::string x(encoded_size(b.size()), ' ');
+        encode(x.data(), b, a);
+        return x;
+    }
+    
+    ptr<bytes> decode_string(string_view s, alphabet a = standard) {
+        bytes b(decoded_size(s.size()));
+        size_t size;
+        if (!decode(b.data(), s, size, a)) return nullptr;
+        b.resize(size);
+        return std::make_shared<bytes>(b);
+    }
+    
+    bytes random_bytes(size_t n, std::mt19937& random) {
+        bytes b(n);
+        for (byte& x : b) x = static_cast<byte>(random());
+        return b;
+    }
+    
+    TEST(Base64Test, Base64Vectors) {
+        // RFC 4648
+        std::vector<std::pair<std::string, std::string>> vectors{
+            {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, 
+            {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}};
+        
+        for (const auto& v : vectors) {
+            bytes b{string_view{v.first}};
+            EXPECT_EQ(write(b), v.second);
+            ptr<bytes> r = read(v.second);
+            ASSERT_NE(r, nullptr);
+            EXPECT_EQ(*r, b);
+        }
+        
+        bytes b{0xfb, 0xff, 0xbf};
+        EXPECT_EQ(encode_string(b), "+/+/");
+        EXPECT_EQ(encode_string(b, url), "-_-_");
+        EXPECT_EQ(*decode_string("-_-_", url), b);
+        EXPECT_EQ(decode_string("-_-_"), nullptr);
+        EXPECT_EQ(decode_string("+/+/", url), nullptr);
+        
+        // padding may be left off. 
+        EXPECT_EQ(*decode_string("Zm9vYg"), bytes{string_view{"foob"}});
+        EXPECT_EQ(*decode_string("Zm9vYmE"), bytes{string_view{"fooba"}});
+        EXPECT_EQ(read("Zm9vYg"), nullptr);
+    }
+    
+    // every length around the sizes of the blocks, in both alphabets. 
+    TEST(Base64Test, Base64EncodeDecode) {
+        std::mt19937 random(1);
+        std::string characters = base64::characters();
+        for (size_t n = 0; n < 200; n++) {
+            bytes b = random_bytes(n, random);
+            
+            // the old way, one character at a time. 
+            std::string expected;
+            for (size_t i = 0; i < n; i += 3) {
+                uint32 v = (b[i] << 16) | (i + 1 < n ? b[i + 1] << 8 : 0) | (i + 2 < n ? b[i + 2] : 0);
+                for (size_t j = 0; j < 4; j++) expected.push_back(j <= n - i ? characters[(v >> (18 - 6 * j)) & 63] : Pad);
+            }
+            
+            EXPECT_EQ(encode_string(b), expected);
+            ptr<bytes> decoded = decode_string(expected);
+            ASSERT_NE(decoded, nullptr);
+            EXPECT_EQ(*decoded, b);
+            
+            std::string u = expected;
+            std::replace(u.begin(), u.end(), '+', '-');
+            std::replace(u.begin(), u.end(), '/', '_');
+            EXPECT_EQ(encode_string(b, url), u);
+            decoded = decode_string(u, url);
+            ASSERT_NE(decoded, nullptr);
+            EXPECT_EQ(*decoded, b);
+        }
+    }
+    
+    TEST(Base64Test, Base64Invalid) {
+        std::mt19937 random(2);
+        std::string valid = encode_string(random_bytes(150, random));
+        for (size_t i = 0; i < valid.size(); i++) 
+            for (char c : {'=', '-', '_', '.', ' ', '\0', '\x80', '\xff', '@', '[', '`', '{'}) {
+                // the last character may be padding. 
+                if (c == Pad && i + 1 == valid.size()) continue;
+                std::string invalid = valid;
+                invalid[i] = c;
+                EXPECT_EQ(decode_string(invalid), nullptr) << i << " " << int(c);
+            }
+        
+        EXPECT_EQ(decode_string("A"), nullptr);
+        EXPECT_EQ(decode_string("A==="), nullptr);
+        EXPECT_EQ(decode_string("===="), nullptr);
+        EXPECT_EQ(decode_string("Zg==Zg=="), nullptr);
+        EXPECT_EQ(decode_string("Zg=a"), nullptr);
+        EXPECT_EQ(read("Zg="), nullptr);
+    }
+    
+    TEST(Base64Test, Base64Stream) {
+        std::mt19937 random(3);
+        bytes b = random_bytes(1000, random);
+        std::string expected = encode_string(b);
+        
+        for (size_t piece : {1, 2, 3, 5, 7, 64, 100, 999}) {
+            encoder e;
+            std::string encoded;
+            for (size_t i = 0; i < b.size(); i += piece) e.write(encoded, bytes_view(b).substr(i, piece));
+            e.finish(encoded);
+            EXPECT_EQ(encoded, expected);
+            
+            decoder d;
+            bytes decoded;
+            for (size_t i = 0; i < expected.size(); i += piece) EXPECT_TRUE(d.write(decoded, string_view(expected).substr(i, piece)));
+            EXPECT_TRUE(d.finish(decoded));
+            EXPECT_EQ(decoded, b);
+        }
+        
+        // without padding. 
+        decoder d;
+        bytes decoded;
+        EXPECT_TRUE(d.write(decoded, "Zm9"));
+        EXPECT_TRUE(d.write(decoded, "vYmE"));
+        EXPECT_TRUE(d.finish(decoded));
+        EXPECT_EQ(decoded, bytes{string_view{"fooba"}});
+        
+        // nothing after padding. 
+        decoder p;
+        EXPECT_TRUE(p.write(decoded, "Zg="));
+        EXPECT_TRUE(p.write(decoded, "="));
+        EXPECT_FALSE(p.write(decoded, "Zg=="));
+        
+        decoder q;
+        EXPECT_FALSE(q.write(decoded, "Zm9v!"));
+        EXPECT_FALSE(q.write(decoded, "Zm9v"));
+        
+        decoder r;
+        EXPECT_TRUE(r.write(decoded, "Zm9vY"));
+        EXPECT_FALSE(r.finish(decoded));
+        
+        // a tail that cannot be decoded leaves out as it was. 
+        decoder t;
+        bytes tail;
+        EXPECT_TRUE(t.write(tail, "Zm9vZg="));
+        EXPECT_EQ(tail, bytes{string_view{"foo"}});
+        EXPECT_FALSE(t.finish(tail));
+        EXPECT_EQ(tail, bytes{string_view{"foo"}});
+    }
+    
+    TEST(Base64Test, Base64Valid) {
+        EXPECT_FALSE(valid(""));
+        EXPECT_TRUE(valid("Zm9v"));
+        EXPECT_TRUE(valid("Zm8="));
+        EXPECT_TRUE(valid("Zg=="));
+        EXPECT_FALSE(valid("Z==="));
+        EXPECT_FALSE(valid("===="));
+        EXPECT_FALSE(valid("Zm9"));
+        EXPECT_FALSE(valid("Z=9v"));
+        EXPECT_FALSE(valid("Zm9vZm8=Zm9v"));
+        EXPECT_FALSE(valid("Zm9-"));
+        EXPECT_TRUE(valid(string_view{"Zm9vZ", 4}));
+        
+        std::mt19937 random{7};
+        std::string s = encode_string(random_bytes(301, random));
+        EXPECT_TRUE(valid(s));
+        for (size_t i : {0, 31, 32, 200, 400}) {
+            std::string x = s;
+            x[i] = '-';
+            EXPECT_FALSE(valid(x)) << i;
+            x[i] = '=';
+            EXPECT_FALSE(valid(x)) << i;
+        }
+    }
+    
+}
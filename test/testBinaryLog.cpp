@@ -0,0 +1,129 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#define DATA_LOG_FLOOR 2
+
+#include "data/log/binary.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace data::log {
+
+    enum class color : uint8_t {
+        red,
+        green
+    };
+
+    std::string decode_file(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        std::stringstream out;
+        EXPECT_TRUE(binary::decode(file, out));
+        return out.str();
+    }
+
+    size_t count_lines(const std::string& text, const std::string& match) {
+        std::stringstream in(text);
+        std::string line;
+        size_t n = 0;
+        while (std::getline(in, line)) if (line.find(match) != std::string::npos) n++;
+        return n;
+    }
+
+    TEST(BinaryLogTest, TestDecode) {
+        init_binary_logging("binary.log");
+        std::string name = "alice";
+        int x = -5;
+        DATA_LOG_BINARY(warning, "nothing to format");
+        DATA_LOG_BINARY_CHANNEL("test", error, "{} has {} of {} and {} at {} {}",
+            name, x, uint64_t(18446744073709551615u), 2.5, std::string_view{"home"}, color::green);
+        DATA_LOG_BINARY(critical, "{} {} {}", true, 'c', "literal");
+        close_binary_logging();
+
+        std::string text = decode_file("binary.log");
+        EXPECT_EQ(count_lines(text, "] [data] [warning]: nothing to format"), 1);
+        EXPECT_EQ(count_lines(text, "] [test] [error]: alice has -5 of 18446744073709551615 and 2.5 at home 1"), 1);
+        EXPECT_EQ(count_lines(text, "] [data] [critical]: true c literal"), 1);
+        EXPECT_EQ(text[0], '[');
+        std::remove("binary.log");
+    }
+
+    TEST(BinaryLogTest, TestThreads) {
+        binary_options options;
+        options.ThreadBuffer = 1024;
+        options.Overflow = overflow::block;
+        init_binary_logging("threads.log", options);
+        std::vector<std::thread> loggers;
+        for (int i = 0; i < 4; i++) loggers.emplace_back([i]() {
+            for (uint32_t j = 0; j < 10000; j++) DATA_LOG_BINARY(warning, "thread {} record {} {}", i, j, "padding");
+        });
+        for (auto& t : loggers) t.join();
+        flush_logging();
+        EXPECT_EQ(count_lines(decode_file("threads.log"), "record"), 40000);
+        EXPECT_EQ(count_lines(decode_file("threads.log"), "thread 3 record 9999 padding"), 1);
+
+        // a thread that logs after the log is opened again gets a new buffer.
+        init_binary_logging("threads.log");
+        DATA_LOG_BINARY(warning, "again");
+        close_binary_logging();
+        EXPECT_EQ(decode_file("threads.log").find("[warning]: again\n") != std::string::npos, true);
+        std::remove("threads.log");
+    }
+
+    TEST(BinaryLogTest, TestReopenWhileLogging) {
+        // the log may be opened again while other threads are logging to it.
+        binary_options options;
+        options.ThreadBuffer = 1024;
+        options.Overflow = overflow::block;
+        init_binary_logging("reopen.log", options);
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> loggers;
+        for (int i = 0; i < 3; i++) loggers.emplace_back([i, &stop]() {
+            for (uint32_t j = 0; !stop; j++) DATA_LOG_BINARY(warning, "thread {} record {}", i, j);
+        });
+        for (int k = 0; k < 20; k++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            init_binary_logging("reopen.log", options);
+        }
+        stop = true;
+        for (auto& t : loggers) t.join();
+        close_binary_logging();
+        decode_file("reopen.log");
+        std::remove("reopen.log");
+    }
+
+    TEST(BinaryLogTest, TestOverflow) {
+        binary_options options;
+        options.ThreadBuffer = 256;
+        uint64_t dropped = dropped_log_records();
+        init_binary_logging("drop.log", options);
+        for (int j = 0; j < 1000; j++) DATA_LOG_BINARY(warning, "drop {}", j);
+        // too big for the buffer at all.
+        DATA_LOG_BINARY(warning, "{}", std::string(200, 'x'));
+        close_binary_logging();
+        EXPECT_EQ(count_lines(decode_file("drop.log"), "drop") + dropped_log_records() - dropped, 1001);
+        EXPECT_EQ(count_lines(decode_file("drop.log"), "xxx"), 0);
+        std::remove("drop.log");
+    }
+
+    TEST(BinaryLogTest, TestFloorAndClosed) {
+        int evaluated = 0;
+        DATA_LOG_BINARY(normal, "{}", ++evaluated);
+        EXPECT_EQ(evaluated, 0);
+
+        // nothing happens when no log is open.
+        DATA_LOG_BINARY(warning, "{}", evaluated);
+
+        std::stringstream bad("not a log");
+        std::stringstream out;
+        EXPECT_FALSE(binary::decode(bad, out));
+    }
+}
@@ -235,4 +235,93 @@ namespace data {
         
     }
     
+    TEST(BoundedTest, BoundedArithmetic) {
+        
+        using u32b = bounded<false, data::endian::big, 32>;
+        using u32l = bounded<false, data::endian::little, 32>;
+        using s32b = bounded<true, data::endian::big, 32>;
+        using s32l = bounded<true, data::endian::little, 32>;
+        
+        N modulus = N{1} << 256;
+        Z half = Z{N{1} << 255};
+        auto wrap = [&modulus, &half](const Z& z) -> Z {
+            Z x = z % Z{modulus};
+            if (x < 0) x += Z{modulus};
+            return x >= half ? x - Z{modulus} : x;
+        };
+        
+        string_view a{"0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f"};
+        string_view b{"0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141"};
+        string_view c{"0x000000000000000000000000000000000000000000000000001444400de0c0e9"};
+        string_view d{"0x0000000000000000000000000000000000000000000000000000000000000001"};
+        
+        for (string_view x : {a, b, c, d}) for (string_view y : {a, b, c, d}) {
+            N nx{x};
+            N ny{y};
+            
+            EXPECT_EQ(N{u32b{x}}, nx);
+            EXPECT_EQ(N{u32l{x}}, nx);
+            
+            EXPECT_EQ(u32b{x} < u32b{y}, nx < ny);
+            EXPECT_EQ(u32l{x} < u32l{y}, nx < ny);
+            EXPECT_EQ(u32b{x} == u32b{y}, nx == ny);
+            EXPECT_EQ(u32l{x} == u32l{y}, nx == ny);
+            
+            EXPECT_EQ(N{u32b{x} + u32b{y}}, (nx + ny) % modulus);
+            EXPECT_EQ(N{u32l{x} + u32l{y}}, (nx + ny) % modulus);
+            EXPECT_EQ(N{u32b{x} - u32b{y}}, (nx + modulus - ny) % modulus);
+            EXPECT_EQ(N{u32l{x} - u32l{y}}, (nx + modulus - ny) % modulus);
+            EXPECT_EQ(N{u32b{x} * u32b{y}}, (nx * ny) % modulus);
+            EXPECT_EQ(N{u32l{x} * u32l{y}}, (nx * ny) % modulus);
+            EXPECT_EQ(N{u32b{x} / u32b{y}}, nx / ny);
+            EXPECT_EQ(N{u32l{x} / u32l{y}}, nx / ny);
+            EXPECT_EQ(N{u32b{x} % u32b{y}}, nx % ny);
+            EXPECT_EQ(N{u32l{x} % u32l{y}}, nx % ny);
+            
+            EXPECT_EQ(N{u32b{x} << 67}, (nx << 67) % modulus);
+            EXPECT_EQ(N{u32l{x} << 67}, (nx << 67) % modulus);
+            EXPECT_EQ(N{u32b{x} >> 67}, nx >> 67);
+            EXPECT_EQ(N{u32l{x} >> 67}, nx >> 67);
+            
+            Z zx{s32b{x}};
+            Z zy{s32b{y}};
+            
+            EXPECT_EQ(Z{s32l{x}}, zx);
+            EXPECT_EQ(s32b{x} < s32b{y}, zx < zy);
+            EXPECT_EQ(s32l{x} < s32l{y}, zx < zy);
+            
+            EXPECT_EQ(Z{s32b{x} + s32b{y}}, wrap(zx + zy));
+            EXPECT_EQ(Z{s32l{x} + s32l{y}}, wrap(zx + zy));
+            EXPECT_EQ(Z{s32b{x} - s32b{y}}, wrap(zx - zy));
+            EXPECT_EQ(Z{s32l{x} - s32l{y}}, wrap(zx - zy));
+            EXPECT_EQ(Z{s32b{x} * s32b{y}}, wrap(zx * zy));
+            EXPECT_EQ(Z{s32l{x} * s32l{y}}, wrap(zx * zy));
+            
+            auto db = s32b{x}.divide(s32b{y});
+            auto dl = s32l{x}.divide(s32l{y});
+            EXPECT_EQ(Z{db.Quotient} * zy + Z{db.Remainder}, zx);
+            EXPECT_EQ(Z{dl.Quotient} * zy + Z{dl.Remainder}, zx);
+            EXPECT_FALSE(db.Remainder != 0 && (db.Remainder < 0) != (s32b{y} < 0));
+            EXPECT_FALSE(dl.Remainder != 0 && (dl.Remainder < 0) != (s32l{y} < 0));
+        }
+        
+        EXPECT_EQ(u32b::max() + 1, u32b{0});
+        EXPECT_EQ(u32l::max() + 1, u32l{0});
+        EXPECT_EQ(u32b{0} - 1, u32b::max());
+        EXPECT_EQ(u32l{0} - 1, u32l::max());
+        EXPECT_EQ(s32b::max() + 1, s32b::min());
+        EXPECT_EQ(s32l::max() + 1, s32l::min());
+        
+        EXPECT_EQ(s32b{-7} / s32b{2}, s32b{-4});
+        EXPECT_EQ(s32l{-7} % s32l{2}, s32l{1});
+        EXPECT_EQ(s32b{-7} >> 1, s32b{-4});
+        
+        EXPECT_EQ(u32b{3} ^ u32b{5}, u32b{243});
+        EXPECT_EQ(s32l{-3} ^ u32l{3}, s32l{-27});
+        
+        EXPECT_THROW(u32b{1} / u32b{0}, math::division_by_zero);
+        EXPECT_THROW(s32l{1} / s32l{0}, math::division_by_zero);
+        
+    }
+    
 }
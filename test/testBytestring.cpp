@@ -4,6 +4,7 @@
 
 #include <data/data.hpp>
 #include "gtest/gtest.h"
+#include <stdexcept>
 
 namespace data {
     
@@ -19,5 +20,26 @@ namespace data {
         
     }
     
+    TEST(BytestringTest, TestBytestringFixedSize) {
+        bytes b(32);
+        for (int i = 0; i < 32; i++) b[i] = i + 1;
+        
+        bytestring<endian::big, 32> x{bytes_view(b)};
+        EXPECT_EQ(x[0], 1);
+        EXPECT_EQ(x[31], 32);
+        
+        bytestring<endian::big, 4> y{bytes_view(b), 28};
+        EXPECT_EQ(y[0], 29);
+        EXPECT_EQ(y[3], 32);
+        
+        // the wrong number of bytes is an error rather than zero. 
+        EXPECT_THROW((bytestring<endian::big, 32>{bytes_view(b).substr(0, 31)}), std::invalid_argument);
+        EXPECT_THROW((bytestring<endian::big, 32>{bytes_view(b).substr(0, 0)}), std::invalid_argument);
+        EXPECT_THROW((bytestring<endian::big, 4>{bytes_view(b), 29}), std::invalid_argument);
+        EXPECT_THROW((bytestring<endian::big, 4>{bytes_view(b), 40}), std::invalid_argument);
+        EXPECT_THROW((bytestring<endian::big, 4>{bytes_view(b), 4, 9}), std::invalid_argument);
+        EXPECT_THROW((bytestring<endian::big, 4>{ptr<bytes>{}, 0}), std::invalid_argument);
+    }
+    
 }
 
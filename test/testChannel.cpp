@@ -0,0 +1,232 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools/channel.hpp>
+#include <data/tools/select.hpp>
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+namespace data {
+    
+    TEST(ChannelTest, TestRing) {
+        tool::mpmc_ring<int> m{5};
+        tool::spsc_ring<int> s{5};
+        EXPECT_EQ(m.capacity(), 8);
+        EXPECT_EQ(s.capacity(), 8);
+        
+        std::vector<int> in{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        EXPECT_EQ(m.try_push(in.begin(), 10), 8);
+        EXPECT_EQ(s.try_push(in.begin(), 10), 8);
+        EXPECT_FALSE(m.try_push(8));
+        EXPECT_FALSE(s.try_push(8));
+        
+        std::vector<int> out(10);
+        EXPECT_EQ(m.try_pop(out.begin(), 3), 3);
+        EXPECT_EQ(out[2], 2);
+        EXPECT_EQ(s.try_pop(out.begin(), 3), 3);
+        EXPECT_EQ(out[2], 2);
+        
+        // wrap around. 
+        EXPECT_EQ(m.try_push(in.begin(), 10), 3);
+        EXPECT_EQ(s.try_push(in.begin(), 10), 3);
+        EXPECT_EQ(m.try_pop(out.begin(), 10), 8);
+        EXPECT_EQ(out[4], 7);
+        EXPECT_EQ(out[7], 2);
+        EXPECT_EQ(s.try_pop(out.begin(), 10), 8);
+        EXPECT_EQ(out[4], 7);
+        EXPECT_EQ(out[7], 2);
+        
+        int x;
+        EXPECT_FALSE(m.try_pop(x));
+        EXPECT_FALSE(s.try_pop(x));
+    }
+    
+    // every item put is gotten exactly once. 
+    template <tool::access a>
+    void test_channel(uint32 size, int producers, int consumers, size_t batch) {
+        const int count = 20000;
+        tool::channel<int, a> c{size};
+        std::vector<std::thread> threads{};
+        std::vector<uint64> sums(consumers, 0);
+        std::vector<int> gotten(consumers, 0);
+        
+        for (int p = 0; p < producers; p++) threads.emplace_back([&c, p, batch, producers]() {
+            std::vector<int> items{};
+            for (int i = p; i < count; i += producers) {
+                items.push_back(i);
+                if (items.size() == batch) {
+                    c.put_batch(items.begin(), items.end());
+                    items.clear();
+                }
+            }
+            c.put_batch(items.begin(), items.end());
+        });
+        
+        for (int q = 0; q < consumers; q++) threads.emplace_back([&c, &sums, &gotten, q, batch, consumers]() {
+            std::vector<int> items(batch);
+            int last = -1;
+            while (true) {
+                size_t n = c.get_batch(items.begin(), batch);
+                if (n == 0) return;
+                for (size_t i = 0; i < n; i++) {
+                    // with one producer, each consumer sees items in order. 
+                    if (a == tool::access::single) {
+                        EXPECT_GT(items[i], last);
+                    }
+                    last = items[i];
+                    sums[q] += items[i];
+                }
+                gotten[q] += n;
+            }
+        });
+        
+        for (int p = 0; p < producers; p++) threads[p].join();
+        c.close();
+        for (int q = 0; q < consumers; q++) threads[producers + q].join();
+        
+        uint64 sum = 0;
+        int total = 0;
+        for (int q = 0; q < consumers; q++) {
+            sum += sums[q];
+            total += gotten[q];
+        }
+        EXPECT_EQ(total, count);
+        EXPECT_EQ(sum, uint64(count) * (count - 1) / 2);
+    }
+    
+    TEST(ChannelTest, TestChannelThreads) {
+        test_channel<tool::access::single>(64, 1, 1, 1);
+        test_channel<tool::access::single>(64, 1, 1, 16);
+        test_channel<tool::access::multiple>(64, 1, 1, 1);
+        test_channel<tool::access::multiple>(64, 4, 4, 1);
+        test_channel<tool::access::multiple>(64, 4, 4, 16);
+        test_channel<tool::access::multiple>(2, 8, 8, 3);
+        test_channel<tool::access::multiple>(0, 4, 4, 16);
+    }
+    
+    TEST(ChannelTest, TestChannelClose) {
+        tool::channel<int> c{2};
+        c.put(1);
+        c.put(2);
+        
+        int x;
+        EXPECT_TRUE(c.get(x, false));
+        EXPECT_EQ(x, 1);
+        
+        c.close();
+        EXPECT_TRUE(c.closed());
+        EXPECT_THROW(c.put(3), std::logic_error);
+        
+        // what was put before the channel closed can still be gotten. 
+        EXPECT_TRUE(c.get(x));
+        EXPECT_EQ(x, 2);
+        EXPECT_FALSE(c.get(x));
+        
+        // closing wakes a thread waiting to get. 
+        tool::channel<int> d{2};
+        std::thread t{[&d]() {
+            int y;
+            EXPECT_FALSE(d.get(y));
+        }};
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        d.close();
+        t.join();
+    }
+    
+    TEST(ChannelTest, TestSelect) {
+        using namespace std::chrono_literals;
+        tool::channel<int> a{4};
+        tool::channel<string> b{4};
+        tool::channel<int> c{2};
+        
+        int x = 0;
+        string y{};
+        auto select = [&]() -> tool::select {
+            return tool::select{}.
+                get(a, [&x](int i) { x = i; }).
+                get(b, [&y](const string& s) { y = s; });
+        };
+        
+        // nothing is ready. 
+        bool defaulted = false;
+        EXPECT_EQ(select().otherwise([&defaulted]() { defaulted = true; })(), tool::select::defaulted);
+        EXPECT_TRUE(defaulted);
+        EXPECT_EQ(select().within(10ms)(), tool::select::timed_out);
+        
+        b.put("hi");
+        EXPECT_EQ(select()(), 1);
+        EXPECT_EQ(y, "hi");
+        
+        // a put case goes ahead when there is room. 
+        c.put(6);
+        bool put = false;
+        EXPECT_EQ(tool::select{}.put(c, 7, [&put]() { put = true; })(), 0);
+        EXPECT_TRUE(put);
+        EXPECT_EQ(tool::select{}.put(c, 8, []() {}).within(10ms)(), tool::select::timed_out);
+        
+        // a select that waits is woken by a put on any of its channels. 
+        std::thread t{[&a]() {
+            std::this_thread::sleep_for(20ms);
+            a.put(3);
+        }};
+        EXPECT_EQ(select().within(10s)(), 0);
+        EXPECT_EQ(x, 3);
+        t.join();
+        
+        // and by closing. 
+        std::thread u{[&a, &b]() {
+            std::this_thread::sleep_for(20ms);
+            a.close();
+            b.close();
+        }};
+        EXPECT_EQ(select()(), tool::select::closed);
+        u.join();
+    }
+    
+    // many selects fan in from many channels. 
+    TEST(ChannelTest, TestSelectFanIn) {
+        const int channels = 8;
+        const int count = 2000;
+        std::vector<tool::channel<int>> in{};
+        for (int i = 0; i < channels; i++) in.emplace_back(16);
+        
+        std::vector<std::thread> producers{};
+        for (int i = 0; i < channels; i++) producers.emplace_back([&in, i]() {
+            for (int j = 0; j < count; j++) in[i].put(j);
+            in[i].close();
+        });
+        
+        std::atomic<uint64> sum{0};
+        std::atomic<int> gotten{0};
+        std::vector<std::thread> consumers{};
+        for (int k = 0; k < 3; k++) consumers.emplace_back([&]() {
+            tool::select s{};
+            for (int i = 0; i < channels; i++) s.get(in[i], [&sum, &gotten](int x) {
+                sum += x;
+                gotten++;
+            });
+            while (s() != tool::select::closed);
+        });
+        
+        for (auto& t : producers) t.join();
+        for (auto& t : consumers) t.join();
+        EXPECT_EQ(gotten.load(), channels * count);
+        EXPECT_EQ(sum.load(), uint64(channels) * count * (count - 1) / 2);
+    }
+    
+    // closing wakes a thread waiting to put. 
+    TEST(ChannelTest, TestCloseWakesSenders) {
+        tool::channel<int> c{2};
+        c.put(1);
+        c.put(2);
+        std::thread t{[&c]() {
+            EXPECT_THROW(c.put(3), std::logic_error);
+        }};
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        c.close();
+        t.join();
+    }
+    
+}
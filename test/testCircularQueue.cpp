@@ -5,22 +5,83 @@
 #include <data/tools/circular_queue.h>
 #include "gtest/gtest.h"
 #include <iostream>
+#include <memory>
+#include <numeric>
+#include <thread>
 namespace data {
     namespace tools {
         TEST(CircularQueueTest, TestInitialize) {
-            circular_queue queue(5);
-            queue.setValue(5);
-            ASSERT_EQ(queue.getValue(),5);
-            queue.next();
-            queue.setValue(4);
-            queue.next();
-            queue.setValue(6);
-            queue.next();
-            queue.setValue(8);
-            queue.next();
-            queue.setValue(10);
-            queue.next();
-            ASSERT_EQ(queue.getValue(),5);
+            circular_queue<long> queue(5);
+            EXPECT_EQ(queue.capacity(), 5);
+            EXPECT_TRUE(queue.empty());
+            for (long x : {5, 4, 6, 8, 10}) EXPECT_TRUE(queue.push(x));
+            EXPECT_TRUE(queue.full());
+            EXPECT_FALSE(queue.push(12));
+            ASSERT_EQ(queue.front(), 5);
+            ASSERT_EQ(queue.back(), 10);
+
+            long x;
+            EXPECT_TRUE(queue.pop(x));
+            EXPECT_EQ(x, 5);
+            EXPECT_TRUE(queue.push(12));
+            EXPECT_EQ(queue[0], 4);
+            EXPECT_EQ(queue[4], 12);
+            EXPECT_EQ(std::accumulate(queue.begin(), queue.end(), 0l), 40);
+        }
+
+        TEST(CircularQueueTest, TestFixed) {
+            circular_queue<std::unique_ptr<int>, 4> queue;
+            EXPECT_EQ(queue.capacity(), 4);
+            for (int i = 0; i < 3; i++) EXPECT_TRUE(queue.push(std::make_unique<int>(i)));
+            for (int i = 0; i < 10; i++) {
+                EXPECT_TRUE(queue.emplace(new int(i + 3)));
+                std::unique_ptr<int> x;
+                EXPECT_TRUE(queue.pop(x));
+                EXPECT_EQ(*x, i);
+            }
+            EXPECT_EQ(queue.size(), 3);
+            EXPECT_TRUE(queue.push(std::make_unique<int>(13)));
+            EXPECT_FALSE(queue.push(std::make_unique<int>(14)));
+            queue.clear();
+            EXPECT_TRUE(queue.empty());
+        }
+
+        TEST(CircularQueueTest, TestOverwrite) {
+            circular_queue<std::shared_ptr<int>, 4, queue_mode::overwrite> window;
+            std::weak_ptr<int> first;
+            for (int i = 0; i < 10; i++) {
+                auto p = std::make_shared<int>(i);
+                if (i == 0) first = p;
+                EXPECT_TRUE(window.push(p));
+            }
+            // the oldest elements have been destroyed.
+            EXPECT_TRUE(first.expired());
+            EXPECT_EQ(window.size(), 4);
+            int expected = 6;
+            for (const auto& x : window) EXPECT_EQ(*x, expected++);
+
+            circular_queue<int, 0, queue_mode::overwrite> odd(3);
+            for (int i = 0; i < 7; i++) odd.push(i);
+            EXPECT_EQ(odd.front(), 4);
+            EXPECT_EQ(odd.back(), 6);
+        }
+
+        TEST(CircularQueueTest, TestSPSC) {
+            circular_queue<uint64_t, 64, queue_mode::spsc> queue;
+            const uint64_t n = 100000;
+            std::thread producer([&queue]() {
+                for (uint64_t i = 0; i < n; i++) while (!queue.push(i)) std::this_thread::yield();
+            });
+
+            uint64_t x, expected = 0;
+            while (expected < n) {
+                if (queue.pop(x)) {
+                    EXPECT_EQ(x, expected++);
+                }
+                else std::this_thread::yield();
+            }
+            producer.join();
+            EXPECT_TRUE(queue.empty());
         }
     }
-}
\ No newline at end of file
+}
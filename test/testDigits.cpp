@@ -0,0 +1,112 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "data/encoding/digits.hpp"
+#include "data/encoding/integer.hpp"
+#include "data/encoding/base58.hpp"
+#include "data/math/number/gmp/N.hpp"
+#include "gtest/gtest.h"
+#include <random>
+
+namespace data::encoding {
+    using nat = math::number::gmp::N;
+
+    // a number without write_digits and read_digits,
+    // so that the generic conversion is used.
+    struct slow {
+        nat Value;
+
+        slow(uint64 x) : Value{x} {}
+        slow(const nat& n) : Value{n} {}
+
+        bool operator==(uint64 x) const {
+            return Value == x;
+        }
+
+        bool operator<=(const slow& x) const {
+            return Value <= x.Value;
+        }
+
+        slow operator*(const slow& x) const {
+            return Value * x.Value;
+        }
+
+        slow operator+(const slow& x) const {
+            return Value + x.Value;
+        }
+
+        math::division<slow> divide(const slow& x) const {
+            math::division<nat> d = Value.divide(x.Value);
+            return {d.Quotient, d.Remainder};
+        }
+
+        explicit operator uint64() const {
+            return uint64(Value);
+        }
+    };
+
+    static_assert(radix::standard<nat>::value);
+    static_assert(!radix::standard<slow>::value);
+
+    std::string gmp_string(const nat& n, int base) {
+        std::string o(mpz_sizeinbase(n.Value.MPZ, base) + 2, '\0');
+        mpz_get_str(o.data(), base, n.Value.MPZ);
+        return o.c_str();
+    }
+
+    nat random_number(size_t digits, std::mt19937_64& random) {
+        std::string s(digits, '0');
+        for (char& c : s) c = '0' + random() % 10;
+        s[0] = '1' + random() % 9;
+        return nat{s};
+    }
+
+    TEST(DigitsTest, TestWriteRead) {
+        std::mt19937_64 random{1};
+        for (size_t size : {1, 19, 20, 39, 100, 1000, 5000}) for (uint32 base : {2, 10, 16, 36, 58, 62}) {
+            nat n = random_number(size, random);
+            std::string expected = gmp_string(n, base);
+            EXPECT_EQ(write_base<nat>(n, base), expected) << size << " " << base;
+            EXPECT_EQ(write_base<slow>(n, base), expected) << size << " " << base;
+            EXPECT_EQ(read_base<nat>(expected, base), n) << size << " " << base;
+            EXPECT_EQ(read_base<slow>(expected, base).Value, n) << size << " " << base;
+        }
+    }
+
+    TEST(DigitsTest, TestArbitraryDigits) {
+        std::mt19937_64 random{2};
+        nat n = random_number(3000, random);
+        std::string b58 = write_base<nat>(n, base58::characters());
+        EXPECT_EQ(write_base<slow>(n, base58::characters()), b58);
+        EXPECT_EQ(base58::read<nat>(b58), n);
+
+        // leading zeros are read but not written.
+        EXPECT_EQ(read_base<nat>("000000000000000000000000000000000000000042", 10), nat{42});
+        EXPECT_EQ(read_base<slow>("000000000000000000000000000000000000000042", 10).Value, nat{42});
+        EXPECT_EQ(write_base<nat>(nat{0}, 10), "0");
+        EXPECT_EQ(write_base<nat>(nat{0}, decimal::characters()), "");
+        EXPECT_EQ(write_base<slow>(slow{10000000000000000000u}, 10), "10000000000000000000");
+
+        EXPECT_EQ(read_base<nat>("ZZ", 36), nat{36 * 36 - 1});
+        EXPECT_EQ(read_base<nat>("zz", 36), nat{36 * 36 - 1});
+        EXPECT_EQ(read_base<nat>("Zz", 62), nat{35 * 62 + 61});
+        EXPECT_THROW(read_base<nat>("12", 2), invalid);
+        EXPECT_THROW(read_base<nat>("", 10), invalid);
+        EXPECT_THROW(read_base<nat>("1", 63), std::invalid_argument);
+        EXPECT_THROW(write_base<nat>(nat{1}, 1), std::invalid_argument);
+    }
+
+    TEST(DigitsTest, TestLongDecimal) {
+        std::mt19937_64 random{3};
+        nat a = random_number(4000, random);
+        nat b = random_number(3000, random);
+        decimal::N x{write_base<nat>(a, 10)};
+        decimal::N y{write_base<nat>(b, 10)};
+        EXPECT_EQ(x + y, write_base<nat>(a + b, 10));
+        EXPECT_EQ(x * y, write_base<nat>(a * b, 10));
+        EXPECT_EQ(x - y, write_base<nat>(a - b, 10));
+        EXPECT_TRUE(y < x);
+    }
+
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include "gtest/gtest.h"
+#include <deque>
+
+namespace data {
+    
+    template <typename X> using queue = tool::functional_queue<stack<X>>;
+    
+    TEST(FunctionalQueueTest, TestQueueConstruct) {
+        queue<int> a{1, 2, 3};
+        queue<int> b = queue<int>::make(1, 2, 3);
+        queue<int> c = queue<int>{} << 1 << 2 << 3;
+        queue<int> d{stack<int>{1, 2, 3}};
+        
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a, c);
+        EXPECT_EQ(a, d);
+        EXPECT_EQ(a.size(), 3);
+        EXPECT_EQ(a.first(), 1);
+        EXPECT_EQ(a.last(), 3);
+        EXPECT_EQ(a.reverse(), (queue<int>{3, 2, 1}));
+        EXPECT_EQ((a << queue<int>{4, 5}), (queue<int>{1, 2, 3, 4, 5}));
+        EXPECT_EQ(queue<int>{0} << a, (queue<int>{0, 1, 2, 3}));
+    }
+    
+    // old versions of a queue remain valid while 
+    // new versions are made from them. 
+    TEST(FunctionalQueueTest, TestQueuePersistence) {
+        std::vector<queue<int>> queues{queue<int>{}};
+        std::vector<std::deque<int>> expected{std::deque<int>{}};
+        
+        for (int i = 0; i < 2000; i++) {
+            size_t from = (i * 7919) % queues.size();
+            queue<int> q = queues[from];
+            std::deque<int> d = expected[from];
+            
+            switch (i % 5) {
+                case 0: 
+                case 1: 
+                    q = q << i;
+                    d.push_back(i);
+                    break;
+                case 2: 
+                    if (!d.empty()) {
+                        q = q.rest();
+                        d.pop_front();
+                    }
+                    break;
+                case 3: 
+                    q = q.prepend(i);
+                    d.push_front(i);
+                    break;
+                default: 
+                    q = q << queues[i % queues.size()];
+                    d.insert(d.end(), expected[i % queues.size()].begin(), expected[i % queues.size()].end());
+            }
+            
+            EXPECT_EQ(q.size(), d.size());
+            size_t n = 0;
+            for (int x : q) EXPECT_EQ(x, d[n++]);
+            EXPECT_EQ(n, d.size());
+            
+            queues.push_back(q);
+            expected.push_back(d);
+        }
+    }
+    
+    // a queue used as a buffer should take linear time overall.
+    TEST(FunctionalQueueTest, TestQueueBuffer) {
+        const int max = 1000000;
+        queue<int> q{};
+        uint64 sum = 0;
+        for (int i = 0; i < max; i++) {
+            q = q << i;
+            if (i % 3 == 2) {
+                sum += q.first();
+                q = q.rest();
+            }
+        }
+        EXPECT_EQ(q.size(), max - max / 3);
+        
+        int expected = max / 3;
+        for (int x : q) EXPECT_EQ(x, expected++);
+        
+        while (!q.empty()) {
+            sum += q.first();
+            q = q.rest();
+        }
+        EXPECT_EQ(sum, uint64(max) * (max - 1) / 2);
+    }
+    
+}
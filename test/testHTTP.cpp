@@ -0,0 +1,332 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/networking/http.hpp>
+#include "gtest/gtest.h"
+#include <boost/asio/use_future.hpp>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <thread>
+#include <vector>
+#ifdef BOOST_ASIO_HAS_CO_AWAIT
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
+
+namespace data::networking {
+
+    namespace beast = boost::beast;
+    using tcp = boost::asio::ip::tcp;
+
+    // a server on localhost that answers each request with its
+    // method, target and body, and counts its connections and POSTs.
+    struct echo_server {
+        boost::asio::io_context ioc;
+        tcp::acceptor acceptor;
+        std::atomic<int> connections;
+        std::atomic<int> posts;
+        std::atomic<bool> stopping;
+        // close every connection after one response.
+        bool close;
+        // close every connection after one response without saying so.
+        bool hangup;
+        // close a connection without answering a POST that comes after its first response.
+        bool drop;
+        std::vector<std::thread> sessions;
+        std::thread thread;
+
+        explicit echo_server(bool close = false, bool hangup = false, bool drop = false) :
+            acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)),
+            connections(0), posts(0), stopping(false), close(close), hangup(hangup), drop(drop) {
+            thread = std::thread([this]() {
+                while (true) {
+                    tcp::socket socket(ioc);
+                    beast::error_code ec;
+                    acceptor.accept(socket, ec);
+                    if (ec || stopping) return;
+                    connections++;
+                    sessions.emplace_back([this, s = std::move(socket)]() mutable {
+                        serve(std::move(s));
+                    });
+                }
+            });
+        }
+
+        void serve(tcp::socket socket) {
+            beast::flat_buffer buffer;
+            beast::error_code ec;
+            for (int served = 0; true; served++) {
+                beast::http::request_parser<beast::http::string_body> parser;
+                parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+                beast::http::read(socket, buffer, parser, ec);
+                if (ec) return;
+                auto req = parser.release();
+                if (req.method() == beast::http::verb::post) {
+                    posts++;
+                    if (drop && served > 0) break;
+                }
+                beast::http::response<beast::http::string_body> res(beast::http::status::ok, req.version());
+                if (req.method() != beast::http::verb::head) res.body() =
+                    std::string(beast::http::to_string(req.method())) + " " + std::string(req.target()) + " " + req.body();
+                res.keep_alive(req.keep_alive() && !close);
+                res.prepare_payload();
+                beast::http::write(socket, res, ec);
+                if (ec || !res.keep_alive() || hangup) break;
+            }
+            socket.shutdown(tcp::socket::shutdown_send, ec);
+        }
+
+        string port() const {
+            return std::to_string(acceptor.local_endpoint().port());
+        }
+
+        // clients must have closed their connections first.
+        ~echo_server() {
+            stopping = true;
+            tcp::socket wake(ioc);
+            beast::error_code ec;
+            wake.connect(acceptor.local_endpoint(), ec);
+            thread.join();
+            for (auto& s : sessions) s.join();
+        }
+    };
+
+    http::options plain() {
+        http::options o;
+        o.TLS = false;
+        return o;
+    }
+
+    TEST(HTTPTest, TestKeepAlive) {
+        echo_server server;
+        {
+            http client(plain());
+            for (int i = 0; i < 10; i++)
+                EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/" + std::to_string(i)),
+                    "GET /" + std::to_string(i) + " ");
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+    TEST(HTTPTest, TestPipeline) {
+        echo_server server;
+        {
+            http::options o = plain();
+            o.Pipeline = 4;
+            http client(o);
+            std::vector<http::call> calls;
+            for (int i = 0; i < 10; i++) calls.push_back(http::call{
+                i % 2 == 0 ? http::method::get : http::method::post, "/" + std::to_string(i), {}, std::to_string(i * i)});
+            calls.push_back(http::call{http::method::head, "/head", {}, ""});
+            calls.push_back(http::call{http::method::get, "/last", {}, ""});
+
+            std::vector<string> responses = client.pipeline(server.port(), "127.0.0.1", calls);
+            ASSERT_EQ(responses.size(), 12);
+            EXPECT_EQ(responses[0], "GET /0 0");
+            EXPECT_EQ(responses[3], "POST /3 9");
+            EXPECT_EQ(responses[9], "POST /9 81");
+            EXPECT_EQ(responses[10], "");
+            EXPECT_EQ(responses[11], "GET /last ");
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+    TEST(HTTPTest, TestClose) {
+        // the server closes every connection, so each request needs a new one.
+        echo_server server(true);
+        {
+            http client(plain());
+            std::vector<http::call> calls(5, http::call{http::method::get, "/", {}, ""});
+            for (const string& r : client.pipeline(server.port(), "127.0.0.1", calls)) EXPECT_EQ(r, "GET / ");
+            EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/again"), "GET /again ");
+        }
+        EXPECT_EQ(server.connections, 6);
+    }
+
+    TEST(HTTPTest, TestStale) {
+        // connections in the pool that the server has closed are not used again.
+        echo_server server(false, true);
+        {
+            http client(plain());
+            for (int i = 0; i < 3; i++) {
+                EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/"), "GET / ");
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        EXPECT_EQ(server.connections, 3);
+    }
+
+    TEST(HTTPTest, TestNoRepeat) {
+        // a POST that the server may have received is not sent again.
+        echo_server server(false, false, true);
+        {
+            http client(plain());
+            EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/"), "GET / ");
+            EXPECT_THROW(client.request(server.port(), http::method::post, "127.0.0.1", "/", {}, "x"), beast::system_error);
+            EXPECT_EQ(server.posts, 1);
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+    TEST(HTTPTest, TestAsyncNoRepeat) {
+        echo_server server(false, false, true);
+        {
+            boost::asio::io_context ioc;
+            http client(ioc, plain());
+            string body;
+            client.async_request(server.port(), "127.0.0.1", http::call{http::method::get, "/", {}, ""},
+                std::chrono::seconds(10), [&body](boost::system::error_code ec, string b) {
+                    EXPECT_FALSE(ec);
+                    body = b;
+                });
+            ioc.run();
+            EXPECT_EQ(body, "GET / ");
+
+            boost::system::error_code result;
+            client.async_request(server.port(), "127.0.0.1", http::call{http::method::post, "/", {}, "x"},
+                std::chrono::seconds(10), [&result](boost::system::error_code ec, string) {
+                    result = ec;
+                });
+            ioc.restart();
+            ioc.run();
+            EXPECT_TRUE(result);
+            EXPECT_EQ(server.posts, 1);
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+    TEST(HTTPTest, TestStreamNoRepeat) {
+        echo_server server(false, false, true);
+        {
+            http client(plain());
+            EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/"), "GET / ");
+            EXPECT_THROW(client.stream(server.port(), "127.0.0.1", http::call{http::method::post, "/", {}, "x"},
+                [](string_view) {}), beast::system_error);
+            EXPECT_EQ(server.posts, 1);
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+    TEST(HTTPTest, TestNoPool) {
+        echo_server server;
+        {
+            http::options o = plain();
+            o.Connections = 0;
+            http client(o);
+            for (int i = 0; i < 3; i++) EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/"), "GET / ");
+
+            // idle connections that are too old are not used.
+            o.Connections = 8;
+            o.IdleTimeout = std::chrono::seconds(0);
+            http impatient(o);
+            for (int i = 0; i < 3; i++) EXPECT_EQ(impatient.request(server.port(), http::method::get, "127.0.0.1", "/"), "GET / ");
+        }
+        EXPECT_EQ(server.connections, 6);
+    }
+
+    TEST(HTTPTest, TestAsync) {
+        echo_server server;
+        {
+            boost::asio::io_context ioc;
+            auto work = boost::asio::make_work_guard(ioc);
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 2; i++) threads.emplace_back([&ioc]() {
+                ioc.run();
+            });
+
+            http client(ioc, plain());
+            std::atomic<int> done(0);
+            std::vector<string> responses(20);
+            for (int i = 0; i < 20; i++) client.async_request(server.port(), "127.0.0.1",
+                http::call{http::method::post, "/" + std::to_string(i), {}, "x"}, std::chrono::seconds(10),
+                [&responses, &done, i](boost::system::error_code ec, string body) {
+                    EXPECT_FALSE(ec);
+                    responses[i] = body;
+                    done++;
+                });
+
+            std::future<string> future = client.async_request(server.port(), "127.0.0.1",
+                http::call{http::method::get, "/future", {}, ""}, std::chrono::seconds(10), boost::asio::use_future);
+            EXPECT_EQ(future.get(), "GET /future ");
+
+#ifdef BOOST_ASIO_HAS_CO_AWAIT
+            std::promise<string> awaited;
+            boost::asio::co_spawn(ioc, [&]() -> boost::asio::awaitable<void> {
+                // gcc 12 destroys temporaries in a co_await expression twice.
+                string port = server.port();
+                http::call c{http::method::get, "/coroutine", {}, ""};
+                string body = co_await client.async_request(port, "127.0.0.1", c, std::chrono::seconds(10), boost::asio::use_awaitable);
+                awaited.set_value(body);
+            }, boost::asio::detached);
+            EXPECT_EQ(awaited.get_future().get(), "GET /coroutine ");
+#endif
+
+            while (done < 20) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            for (int i = 0; i < 20; i++) EXPECT_EQ(responses[i], "POST /" + std::to_string(i) + " x");
+
+            // the synchronous API uses the same connections.
+            EXPECT_EQ(client.request(server.port(), http::method::get, "127.0.0.1", "/sync"), "GET /sync ");
+
+            work.reset();
+            ioc.stop();
+            for (auto& t : threads) t.join();
+        }
+        EXPECT_LE(server.connections, 21);
+    }
+
+    TEST(HTTPTest, TestDeadline) {
+        // a server that accepts connections but never answers.
+        boost::asio::io_context ioc;
+        tcp::acceptor acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+        http client(ioc, plain());
+
+        boost::system::error_code result;
+        auto start = http::clock::now();
+        client.async_request(std::to_string(acceptor.local_endpoint().port()), "127.0.0.1",
+            http::call{http::method::get, "/", {}, ""}, std::chrono::milliseconds(100),
+            [&result](boost::system::error_code ec, string) {
+                result = ec;
+            });
+        ioc.run();
+        EXPECT_EQ(result, boost::beast::error::timeout);
+        EXPECT_GE(http::clock::now() - start, std::chrono::milliseconds(100));
+    }
+
+    TEST(HTTPTest, TestEncode) {
+        EXPECT_EQ(http::url_encode("abc-XYZ_09.~"), "abc-XYZ_09.~");
+        EXPECT_EQ(http::url_encode("a b&c=d/é"), "a%20b%26c%3Dd%2F%C3%A9");
+        EXPECT_EQ(http::append_params("/path", {}), "/path");
+        EXPECT_EQ(http::append_params("/path", {{"q", "x y"}, {"a&b", "1"}}), "/path?a%26b=1&q=x%20y");
+    }
+
+    TEST(HTTPTest, TestStream) {
+        echo_server server;
+        {
+            http client(plain());
+            // large enough that the body is not copied and the response comes in pieces.
+            string body(5000000, 'x');
+            for (size_t i = 0; i < body.size(); i += 1000) body[i] = 'a' + (i / 1000) % 26;
+
+            string received;
+            size_t pieces = 0;
+            http::status status = client.stream(server.port(), "127.0.0.1", http::call{http::method::put, "/big", {}, body},
+                [&received, &pieces](string_view piece) {
+                    EXPECT_LE(piece.size(), 65536);
+                    received.append(piece);
+                    pieces++;
+                });
+            EXPECT_EQ(status, http::status::ok);
+            EXPECT_GT(pieces, 1);
+            EXPECT_EQ(received, "PUT /big " + body);
+
+            // the connection is used again.
+            EXPECT_EQ(client.request(server.port(), http::method::post, "127.0.0.1", "/small", {}, "y"), "POST /small y");
+            EXPECT_EQ(client.request(server.port(), http::method::post, "127.0.0.1", "/big", {}, body), "POST /big " + body);
+        }
+        EXPECT_EQ(server.connections, 1);
+    }
+
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include <data/crypto/digest.hpp>
+#include "gtest/gtest.h"
+#include <map>
+#include <set>
+#include <random>
+
+namespace data {
+    
+    // so few hashes that most keys collide, at every level. 
+    struct bad_hash {
+        uint64 operator()(int i) const {
+            return uint64(i % 7) * 0x0842108421084210 + (i % 3);
+        }
+    };
+    
+    TEST(HashMapTest, TestHashMapEqual) {
+        
+        hash_map<int, int> m1{{2, 1}, {3, 5}, {1, 7}};
+        hash_map<int, int> m2{{1, 7}, {3, 5}, {2, 1}};
+        hash_map<int, int> m3{{5, 2}, {3, 5}, {8, 3}};
+        hash_map<int, int> m4{{5, 2}, {3, 5}};
+        
+        EXPECT_EQ(m1, m1);
+        EXPECT_EQ(m1, m2);
+        EXPECT_NE(m1, m3);
+        EXPECT_NE(m3, m4);
+        EXPECT_NE(m4, m1);
+        EXPECT_EQ(m3.remove(8), m4);
+        EXPECT_EQ(m1.size(), 3);
+        EXPECT_EQ(m1[3], 5);
+        EXPECT_EQ(m1[4], 0);
+        EXPECT_TRUE(m1.contains(entry<int, int>{2, 1}));
+        EXPECT_FALSE(m1.contains(entry<int, int>{2, 2}));
+        EXPECT_EQ(m1.insert(2, 3)[2], 3);
+        EXPECT_EQ(m1.insert(2, 3).size(), 3);
+
+    }
+    
+    // a map has the same shape however it was built, so maps 
+    // with the same entries are equal. 
+    template <typename hasher>
+    void test_against_std_map() {
+        using hmap = tool::hash_map<int, int, hasher>;
+        std::vector<hmap> maps{hmap{}};
+        std::vector<std::map<int, int>> expected{std::map<int, int>{}};
+        
+        std::mt19937 engine{7};
+        for (int i = 0; i < 3000; i++) {
+            size_t from = engine() % maps.size();
+            hmap m = maps[from];
+            std::map<int, int> e = expected[from];
+            
+            int k = engine() % 300;
+            if (engine() % 3 == 0) {
+                m = m.remove(k);
+                e.erase(k);
+            } else {
+                m = m.insert(k, i);
+                e[k] = i;
+            }
+            
+            EXPECT_EQ(m.size(), e.size());
+            for (const auto& p : e) EXPECT_EQ(m[p.first], p.second);
+            size_t n = 0;
+            for (const auto& x : m) {
+                EXPECT_EQ(e[x.Key], x.Value);
+                n++;
+            }
+            EXPECT_EQ(n, e.size());
+            
+            hmap rebuilt{};
+            for (auto p = e.rbegin(); p != e.rend(); p++) rebuilt = rebuilt.insert(p->first, p->second);
+            EXPECT_EQ(m, rebuilt);
+            // only keys with equal hashes may come in a different order.
+            if (std::is_same<hasher, tool::hash<int>>::value) {
+                EXPECT_TRUE(m.values() == rebuilt.values());
+            }
+            
+            maps.push_back(m);
+            expected.push_back(e);
+        }
+    }
+    
+    TEST(HashMapTest, TestHashMapPersistence) {
+        test_against_std_map<tool::hash<int>>();
+        test_against_std_map<bad_hash>();
+    }
+    
+    TEST(HashMapTest, TestHashMapDigest) {
+        using digest = crypto::digest<32>;
+        std::mt19937_64 engine{3};
+        std::vector<digest> keys{};
+        hash_map<digest, int> m{};
+        for (int i = 0; i < 1000; i++) {
+            digest d{};
+            for (byte& b : d) b = byte(engine());
+            keys.push_back(d);
+            m = m.insert(d, i);
+        }
+        
+        EXPECT_EQ(m.size(), 1000);
+        for (int i = 0; i < 1000; i++) EXPECT_EQ(m[keys[i]], i);
+        EXPECT_FALSE(m.contains(digest{}));
+        EXPECT_EQ(tool::hash<digest>{}(keys[0]), crypto::hash_key(keys[0]));
+    }
+    
+    TEST(HashMapTest, TestHashMapBytestring) {
+        using key = bytestring<endian::big, 32>;
+        std::mt19937_64 engine{2};
+        std::vector<key> keys;
+        hash_map<key, int> m{};
+        hash_map<uint<32>, int> n{};
+        for (int i = 0; i < 100; i++) {
+            key k{};
+            for (byte& b : k) b = byte(engine());
+            keys.push_back(k);
+            m = m.insert(k, i);
+            n = n.insert(uint<32>{bytes_view(k)}, i);
+        }
+        
+        EXPECT_EQ(m.size(), 100);
+        EXPECT_EQ(n.size(), 100);
+        for (int i = 0; i < 100; i++) {
+            EXPECT_EQ(m[keys[i]], i);
+            EXPECT_EQ(n[uint<32>{bytes_view(keys[i])}], i);
+        }
+        EXPECT_FALSE(m.contains(key{}));
+        
+
+        // shorter than eight bytes. 
+        using small = bytestring<endian::big, 4>;
+        hash_map<small, int> s{};
+        s = s.insert(small{bytes_view(keys[0]).substr(0, 4)}, 1);
+        EXPECT_EQ(s[small{bytes_view(keys[0]).substr(0, 4)}], 1);
+    }
+    
+    TEST(HashMapTest, TestHashMapSmallNumbers) {
+        // big endian numbers start with zeros, so every byte must go into the hash. 
+        const uint32 count = 16000;
+        std::set<uint64> hashes{};
+        std::set<uint64> low{};
+        hash_map<uint<32>, uint32> m{};
+        for (uint32 i = 0; i < count; i++) {
+            uint64 h = tool::hash<uint<32>>{}(uint<32>{i});
+            hashes.insert(h);
+            // the bits used by the first two levels of the map. 
+            low.insert(h & 1023);
+            m = m.insert(uint<32>{i}, i);
+        }
+        
+        EXPECT_EQ(hashes.size(), count);
+        EXPECT_GE(low.size(), 1000);
+        EXPECT_EQ(m.size(), count);
+        for (uint32 i = 0; i < count; i += 97) EXPECT_EQ(m[uint<32>{i}], i);
+        EXPECT_FALSE(m.contains(uint<32>{count}));
+    }
+    
+    TEST(HashMapTest, TestHashSet) {
+        hash_set<int> a{};
+        hash_set<int> b{};
+        for (int i = 0; i < 100; i++) a = a.insert(i);
+        for (int i = 50; i < 150; i++) b = b.insert(i);
+        
+        EXPECT_EQ(a.size(), 100);
+        EXPECT_TRUE(a.contains(10));
+        EXPECT_FALSE(a.contains(100));
+        EXPECT_EQ((a & b).size(), 150);
+        EXPECT_EQ((a | b).size(), 50);
+        EXPECT_EQ((a - b).size(), 50);
+        EXPECT_EQ(a.remove(10).size(), 99);
+        EXPECT_EQ(a.remove(10).insert(10), a);
+    }
+    
+}
@@ -7,6 +7,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "gmock/gmock-matchers.h"
+#include <boost/algorithm/hex.hpp>
+#include <random>
 namespace data::encoding::hex {
 
     TEST(HexTest, HexHexToArray) {
@@ -24,6 +26,28 @@ namespace data::encoding::hex {
         ASSERT_FALSE(encoding::hex::valid("012345aHcd"));
     }
 
+    TEST(HexTest, HexValidLong) {
+        // long enough to go through the vectorized path, with a tail.
+        std::string s(1001, '0');
+        for (size_t i = 0; i < s.size(); i++) s[i] = "0123456789abcdef"[i % 16];
+        EXPECT_FALSE(valid(s));
+        EXPECT_TRUE(valid(string_view{s}.substr(0, 1000)));
+        EXPECT_TRUE(valid(string_view{s}.substr(1, 1000)));
+        // the character after the view is not looked at.
+        EXPECT_TRUE(valid(string_view{"ab0Z", 2}));
+        EXPECT_TRUE(valid(""));
+
+        for (size_t i : {0, 31, 32, 500, 999}) {
+            std::string x = s.substr(0, 1000);
+            x[i] = 'g';
+            EXPECT_FALSE(valid(x)) << i;
+            x[i] = 'A';
+            EXPECT_FALSE(valid(x)) << i;
+            x[i] = ' ';
+            EXPECT_FALSE(valid(x)) << i;
+        }
+    }
+
     TEST(HexTest, HexInvalidExceptionOnError) {
         string malformedHexString(std::string("0063EA172D63808"));
         ASSERT_THROW((bytes)(malformedHexString), invalid);
@@ -43,5 +67,58 @@ namespace data::encoding::hex {
 
     }
 
+    // every length around the sizes of the blocks, in both orders and cases.
+    TEST(HexTest, HexEncodeDecode) {
+        std::mt19937 random(1);
+        for (size_t n = 0; n < 150; n++) {
+            bytes b(n);
+            for (byte& x : b) x = static_cast<byte>(random());
+            bytes reversed(n);
+            std::reverse_copy(b.begin(), b.end(), reversed.begin());
+
+            for (letter_case q : {upper, lower}) {
+                std::string expected;
+                if (q == upper) boost::algorithm::hex(b.begin(), b.end(), std::back_inserter(expected));
+                else boost::algorithm::hex_lower(b.begin(), b.end(), std::back_inserter(expected));
+                std::string expected_reversed;
+                if (q == upper) boost::algorithm::hex(reversed.begin(), reversed.end(), std::back_inserter(expected_reversed));
+                else boost::algorithm::hex_lower(reversed.begin(), reversed.end(), std::back_inserter(expected_reversed));
+
+                std::string out(2 * n, ' ');
+                encode(out.data(), b, endian::big, q);
+                EXPECT_EQ(out, expected);
+                encode(out.data(), b, endian::little, q);
+                EXPECT_EQ(out, expected_reversed);
+
+                bytes decoded(n);
+                EXPECT_TRUE(decode(decoded.data(), expected));
+                EXPECT_EQ(decoded, b);
+                EXPECT_TRUE(decode(decoded.data(), expected, endian::little));
+                EXPECT_EQ(decoded, reversed);
+            }
+        }
+    }
+
+    TEST(HexTest, HexDecodeInvalid) {
+        std::string valid(200, '0');
+        for (size_t i = 0; i < valid.size(); i++) valid[i] = "0123456789abcdefABCDEF"[i % 22];
+        bytes out(100);
+        EXPECT_TRUE(decode(out.data(), valid));
+        EXPECT_FALSE(decode(out.data(), valid.substr(1)));
+
+        for (size_t n : {2, 30, 32, 62, 64, 96, 130, 200})
+            for (size_t i = 0; i < n; i++)
+                for (char c : {'g', 'G', '/', ':', '@', '`', ' ', '\0', '\xB0', '\xC1'}) {
+                    std::string invalid = valid.substr(0, n);
+                    invalid[i] = c;
+                    EXPECT_FALSE(decode(out.data(), invalid)) << n << " " << i << " " << int(c);
+                    EXPECT_FALSE(decode(out.data(), invalid, endian::little));
+                }
+
+        EXPECT_EQ(read("0g"), nullptr);
+        EXPECT_EQ(read("000"), nullptr);
+        ASSERT_NE(read("aBcD"), nullptr);
+        EXPECT_EQ(*read("aBcD"), (bytes{0xab, 0xcd}));
+    }
 
 }
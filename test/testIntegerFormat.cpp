@@ -46,6 +46,50 @@ TEST(IntegerTest, TestIntegerFormat) {
     EXPECT_TRUE(integer::negative("0xff"));
     EXPECT_TRUE(integer::negative("0x8000"));
     EXPECT_FALSE(integer::negative("0x7fff"));
+    EXPECT_FALSE(integer::negative("-"));
+    EXPECT_FALSE(integer::negative("-0x1"));
+    EXPECT_FALSE(integer::negative("0x8"));
     
+    EXPECT_TRUE(natural::zero("0"));
+    EXPECT_TRUE(natural::zero("0x"));
+    EXPECT_TRUE(natural::zero("0x0000"));
+    EXPECT_FALSE(natural::zero("0x000"));
+    EXPECT_FALSE(natural::zero("00"));
+    EXPECT_FALSE(natural::zero("0x0001"));
+    EXPECT_TRUE(natural::nonzero("0x0001"));
+    EXPECT_FALSE(natural::nonzero("0x00"));
+    EXPECT_FALSE(natural::valid("-1"));
+    
+}
+
+TEST(IntegerTest, TestIntegerFormatLong) {
+    using namespace data::encoding;
+    
+    // long enough to be checked 32 characters at a time. 
+    std::string dec(100, '0');
+    for (size_t i = 0; i < dec.size(); i++) dec[i] = '1' + i % 9;
+    EXPECT_TRUE(decimal::valid(dec));
+    EXPECT_TRUE(integer::valid("-" + dec));
+    EXPECT_TRUE(integer::negative("-" + dec));
+    EXPECT_TRUE(integer::negative("-" + std::string(99, '0') + "1"));
+    EXPECT_FALSE(integer::negative("-" + std::string(100, '0')));
+    EXPECT_TRUE(natural::zero("0x" + std::string(100, '0')));
+    EXPECT_FALSE(natural::zero("0x" + std::string(99, '0') + "1"));
+    EXPECT_TRUE(hexidecimal::valid("0x" + dec));
+    EXPECT_TRUE(integer::negative("0x9" + dec.substr(1)));
+    
+    for (size_t i : {1, 40, 64, 99}) {
+        std::string x = dec;
+        x[i] = 'a';
+        EXPECT_FALSE(decimal::valid(x)) << i;
+        EXPECT_TRUE(hexidecimal::valid("0x" + x)) << i;
+        x[i] = 'A';
+        EXPECT_FALSE(hexidecimal::valid("0xa" + x.substr(1))) << i;
+    }
+    
+    // the characters after the view are not looked at. 
+    EXPECT_TRUE(decimal::valid(std::string_view{"12a", 2}));
+    EXPECT_TRUE(hexidecimal::valid(std::string_view{"0xab0", 4}));
+    EXPECT_TRUE(natural::zero(std::string_view{"0x001", 4}));
 }
 
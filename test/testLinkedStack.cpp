@@ -3,7 +3,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "data/tools/linked_stack.hpp"
+#include "data/fold.hpp"
 #include "gtest/gtest.h"
+#include <future>
+#include <thread>
+#include <vector>
 
 namespace data {
     template <typename elem>
@@ -112,6 +116,134 @@ namespace data {
         for (const int& x : t) ;
     }
 
+    template <typename alloc, typename elem = int>
+    tool::linked_stack<elem, alloc> count_down(elem max) {
+        tool::linked_stack<elem, alloc> x{};
+        for (elem i = 1; i <= max; i++) x = x << i;
+        return x;
+    }
+    
+    template <typename alloc>
+    void test_allocation(int max) {
+        auto x = count_down<alloc>(max);
+        EXPECT_EQ(x.size(), max);
+        EXPECT_EQ(x, count_down<alloc>(max));
+        int expected = max;
+        for (int i : x) EXPECT_EQ(i, expected--);
+        EXPECT_EQ(expected, 0);
+    }
+    
+    TEST(LinkedStackTest, TestLinkedStackAllocation) {
+        test_allocation<tool::shared_allocation>(1000);
+        test_allocation<tool::pooled_allocation>(1000);
+        test_allocation<tool::local_allocation>(1000);
+        
+        // nodes made on one thread may be released on another.
+        tool::linked_stack<int, tool::pooled_allocation> made;
+        std::thread t{[&made]() {
+            made = count_down<tool::pooled_allocation>(10000);
+        }};
+        t.join();
+        EXPECT_EQ(made.size(), 10000);
+        made = count_down<tool::pooled_allocation>(100);
+        EXPECT_EQ(made.first(), 100);
+    }
+
+    struct cross_thread_block {
+        char Data[48];
+    };
+    
+    TEST(LinkedStackTest, TestSlabPoolCrossThread) {
+        // blocks made on one thread and freed on another are used again, 
+        // rather than piling up in the free list of the thread that frees them.
+        using allocator = tool::slab_allocator<cross_thread_block>;
+        using pool = tool::slab_pool<sizeof(cross_thread_block), alignof(cross_thread_block)>;
+        const int rounds = 5;
+        const size_t blocks = 20 * pool::blocks_per_slab;
+        
+        std::vector<std::promise<std::vector<cross_thread_block*>>> made(rounds);
+        std::vector<std::promise<void>> freed(rounds);
+        std::vector<std::future<std::vector<cross_thread_block*>>> made_futures;
+        std::vector<std::future<void>> freed_futures;
+        for (int r = 0; r < rounds; r++) {
+            made_futures.push_back(made[r].get_future());
+            freed_futures.push_back(freed[r].get_future());
+        }
+        
+        std::thread worker{[&]() {
+            allocator a{};
+            for (int r = 0; r < rounds; r++) {
+                std::vector<cross_thread_block*> p(blocks);
+                for (auto& x : p) x = a.allocate(1);
+                made[r].set_value(p);
+                freed_futures[r].wait();
+            }
+        }};
+        
+        allocator a{};
+        size_t first = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (auto x : made_futures[r].get()) a.deallocate(x, 1);
+            EXPECT_LT(pool::local()->free(), 2 * pool::blocks_per_slab);
+            if (r == 0) first = pool::slabs();
+            freed[r].set_value();
+        }
+        worker.join();
+        
+        EXPECT_LE(pool::slabs(), first + 2);
+    }
+    
+    // released at thread exit after the thread's pools are gone.
+    struct late {
+        tool::linked_stack<int, tool::pooled_allocation> Stack;
+    };
+    
+    TEST(LinkedStackTest, TestSlabPoolThreadExit) {
+        std::thread t{[]() {
+            // constructed before the pool, so destroyed after it.
+            thread_local late l{};
+            l.Stack = count_down<tool::pooled_allocation>(1000);
+        }};
+        t.join();
+        
+        tool::linked_stack<int, tool::pooled_allocation> x = count_down<tool::pooled_allocation>(1000);
+        EXPECT_EQ(x.size(), 1000);
+    }
+
+    // none of these should recurse over the length of the list. 
+    TEST(LinkedStackTest, TestLinkedStackLong) {
+        const uint32 max = 10000000;
+        
+        stack<uint32> a = count_down<tool::shared_allocation>(max);
+        EXPECT_EQ(a.size(), max);
+        EXPECT_EQ(a.first(), max);
+        EXPECT_EQ(a[max - 1], 1);
+        EXPECT_EQ(a.from(max - 1), stack<uint32>{1});
+        EXPECT_EQ(a.from(max + 1), stack<uint32>{});
+        EXPECT_TRUE(a.valid());
+        EXPECT_TRUE(a.contains(1));
+        EXPECT_FALSE(a.contains(0));
+        
+        {
+            stack<uint32> b = count_down<tool::shared_allocation>(max);
+            EXPECT_EQ(a, b);
+            b = b.rest() << 0;
+            EXPECT_NE(a, b);
+        }
+        
+        auto plus = [](uint64 x, uint64 y) -> uint64 {
+            return x + y;
+        };
+        
+        uint64 sum = uint64(max) * (max + 1) / 2;
+        EXPECT_EQ(data::fold(plus, uint64{0}, a), sum);
+        EXPECT_EQ(data::reduce<uint64>(plus, a), sum);
+        
+        stack<uint32> r = data::reverse(a);
+        EXPECT_EQ(r.first(), 1);
+        EXPECT_EQ(r[max - 1], max);
+    }
+
     // TODO
     TEST(LinkedStackTest, TestLinkedStackSort) {
         
@@ -2,10 +2,19 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+// statements below warning are removed from this file.
+#define DATA_LOG_FLOOR 2
+
 #include "data/log/log.hpp"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "gmock/gmock-matchers.h"
+#include <cstdio>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace data::log {
 
@@ -14,4 +23,86 @@ namespace data::log {
         init_logging("log_%N.log");
         testLog();
     }
-}
\ No newline at end of file
+
+    // lines in the file that contain the given text.
+    size_t count_lines(const std::string& filename, const std::string& text) {
+        std::ifstream file(filename);
+        std::string line;
+        size_t n = 0;
+        while (std::getline(file, line)) if (line.find(text) != std::string::npos) n++;
+        return n;
+    }
+
+    void log_from_threads(int threads, int lines, const std::string& text) {
+        std::vector<std::thread> loggers;
+        for (int i = 0; i < threads; i++) loggers.emplace_back([i, lines, &text]() {
+            for (int j = 0; j < lines; j++) DATA_LOG_CHANNEL("test", warning) << text << " " << i << " " << j;
+        });
+        for (auto& t : loggers) t.join();
+        flush_logging();
+    }
+
+    TEST(LogTest, TestAsyncLog) {
+        std::remove("async.log");
+        init_async_logging("async.log");
+        log_from_threads(4, 1000, "async");
+        EXPECT_EQ(count_lines("async.log", "] [test] [warning]: async "), 4000);
+
+        // long lines are cut short.
+        DATA_LOG(error) << std::string(1000, 'x');
+        flush_logging();
+        EXPECT_EQ(count_lines("async.log", std::string(400, 'x')), 1);
+        EXPECT_EQ(count_lines("async.log", std::string(600, 'x')), 0);
+        logging::core::get()->remove_all_sinks();
+        std::remove("async.log");
+    }
+
+    TEST(LogTest, TestAsyncOverflow) {
+        async_options options;
+        options.Lines = 2;
+
+        std::remove("block.log");
+        options.Overflow = overflow::block;
+        init_async_logging("block.log", options);
+        log_from_threads(4, 2000, "block");
+        logging::core::get()->remove_all_sinks();
+        EXPECT_EQ(count_lines("block.log", "block"), 8000);
+        std::remove("block.log");
+
+        std::remove("drop.log");
+        options.Overflow = overflow::drop;
+        uint64_t dropped = dropped_log_lines();
+        init_async_logging("drop.log", options);
+        log_from_threads(4, 2000, "drop");
+        logging::core::get()->remove_all_sinks();
+        EXPECT_EQ(count_lines("drop.log", "drop") + dropped_log_lines() - dropped, 8000);
+        std::remove("drop.log");
+
+        // bad options are refused before the file is made.
+        std::remove("bad.log");
+        options.Lines = 0;
+        EXPECT_THROW(init_async_logging("bad.log", options), std::invalid_argument);
+        options.Lines = 2;
+        options.LineSize = 1;
+        EXPECT_THROW(init_async_logging("bad.log", options), std::invalid_argument);
+        EXPECT_FALSE(std::ifstream("bad.log").good());
+    }
+
+    int evaluated = 0;
+
+    int evaluate() {
+        return ++evaluated;
+    }
+
+    TEST(LogTest, TestFloor) {
+        DATA_LOG(normal) << evaluate();
+        DATA_LOG_CHANNEL("test", notification) << evaluate();
+        EXPECT_EQ(evaluated, 0);
+        DATA_LOG(warning) << evaluate();
+        EXPECT_EQ(evaluated, 1);
+
+        if (evaluated == 0) DATA_LOG(normal) << evaluate();
+        else evaluated = 5;
+        EXPECT_EQ(evaluated, 5);
+    }
+}
@@ -51,5 +51,109 @@ namespace data {
         
         EXPECT_EQ(m1.remove(3), m2);
     }
+    
+    TEST(MapTest, TestInsertRemoveMany) {
+        
+        map<int, int> m{};
+        for (int i = 0; i < 200; i++) m = m.insert((i * 37) % 200, i);
+        EXPECT_EQ(m.size(), 200);
+        
+        map<int, int> replaced = m.insert(5, -1);
+        EXPECT_EQ(replaced.size(), 200);
+        EXPECT_EQ(replaced[5], -1);
+        EXPECT_NE(m[5], -1);
+        
+        map<int, int> removed = m;
+        for (int i = 0; i < 200; i += 2) removed = removed.remove(i);
+        EXPECT_EQ(removed.size(), 100);
+        EXPECT_EQ(m.size(), 200);
+        for (int i = 0; i < 200; i++) {
+            EXPECT_EQ(removed.contains(i), i % 2 == 1);
+            EXPECT_TRUE(m.contains(i));
+        }
+        
+        EXPECT_EQ(removed.remove(0), removed);
+        for (int i = 1; i < 200; i += 2) removed = removed.remove(i);
+        EXPECT_TRUE(removed.empty());
+        EXPECT_EQ(removed.size(), 0);
+    }
+    
+    TEST(MapTest, TestMapIterator) {
+        
+        map<int, int> m{};
+        for (int i = 0; i < 100; i++) m = m.insert((i * 37) % 100 * 2, i);
+        
+        int expected = 0;
+        for (const auto& e : m) {
+            EXPECT_EQ(e.Key, expected);
+            EXPECT_EQ(e.Value, m[expected]);
+            expected += 2;
+        }
+        EXPECT_EQ(expected, 200);
+        
+        EXPECT_EQ((*m.lower_bound(10)).Key, 10);
+        EXPECT_EQ((*m.lower_bound(11)).Key, 12);
+        EXPECT_EQ((*m.upper_bound(10)).Key, 12);
+        EXPECT_EQ((*m.upper_bound(-5)).Key, 0);
+        EXPECT_EQ(m.lower_bound(199), m.end());
+        EXPECT_EQ(m.upper_bound(198), m.end());
+        
+        int count = 0;
+        for (auto i = m.lower_bound(21); i != m.upper_bound(40); ++i) count++;
+        EXPECT_EQ(count, 10);
+        
+        map<int, int> empty{};
+        EXPECT_EQ(empty.begin(), empty.end());
+    }
+    
+    TEST(MapTest, TestMapFromSorted) {
+        
+        std::vector<std::pair<int, int>> sorted;
+        for (int i = 0; i < 1000; i++) sorted.push_back({2 * i, i});
+        
+        map<int, int> m = map<int, int>::from_sorted(sorted.begin(), sorted.end());
+        EXPECT_EQ(m.size(), 1000);
+        int i = 0;
+        for (const auto& e : m) {
+            EXPECT_EQ(e.Key, 2 * i);
+            EXPECT_EQ(e.Value, i);
+            i++;
+        }
+        EXPECT_EQ(m.insert(3, 3).size(), 1001);
+        EXPECT_EQ(m.remove(500).size(), 999);
+        
+        map<int, int> duplicates{{3, 1}, {1, 2}, {3, 4}};
+        EXPECT_EQ(duplicates.size(), 2);
+        EXPECT_EQ(duplicates[3], 4);
+    }
+    
+    TEST(MapTest, TestSetAlgebra) {
+        
+        std::vector<int> evens;
+        std::vector<int> threes;
+        for (int i = 0; i < 300; i += 2) evens.push_back(i);
+        for (int i = 0; i < 300; i += 3) threes.push_back(i);
+        
+        set<int> a = set<int>::from_sorted(evens.begin(), evens.end());
+        set<int> b = set<int>::from_sorted(threes.begin(), threes.end());
+        
+        set<int> u = a & b;
+        set<int> n = a | b;
+        set<int> d = a - b;
+        
+        EXPECT_EQ(u.size(), 200);
+        EXPECT_EQ(n.size(), 50);
+        EXPECT_EQ(d.size(), 100);
+        EXPECT_EQ(a.insert(b), u);
+        
+        for (int i = 0; i < 300; i++) {
+            EXPECT_EQ(u.contains(i), i % 2 == 0 || i % 3 == 0);
+            EXPECT_EQ(n.contains(i), i % 6 == 0);
+            EXPECT_EQ(d.contains(i), i % 2 == 0 && i % 3 != 0);
+        }
+        
+        EXPECT_EQ((a - a).size(), 0);
+        EXPECT_EQ(a | set<int>{}, set<int>{});
+        EXPECT_EQ(a & set<int>{}, a);
+    }
 }
-
@@ -89,6 +89,58 @@ namespace data {
         EXPECT_EQ(N_bytes<endian::little>{"0x00000001"}, N_bytes<endian::little>{1});
         
     }
+    TEST(NBytesTest, TestNBytesArithmetic) {
+        
+        N a{"0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F"};
+        N b{"0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141"};
+        N c{"5704566599993321"};
+        
+        for (const N& x : cross<N>{a, b, c, N{1}, N{0}}) for (const N& y : cross<N>{a, b, c, N{1}}) {
+            N_bytes<endian::big> xb{x};
+            N_bytes<endian::big> yb{y};
+            N_bytes<endian::little> xl{x};
+            N_bytes<endian::little> yl{y};
+            
+            EXPECT_EQ(N{xb}, x);
+            EXPECT_EQ(N{xl}, x);
+            
+            EXPECT_EQ(xb == yb, x == y);
+            EXPECT_EQ(xl == yl, x == y);
+            EXPECT_EQ(xb < yb, x < y);
+            EXPECT_EQ(xl < yl, x < y);
+            EXPECT_EQ(xb <= y, x <= y);
+            EXPECT_EQ(xl <= y, x <= y);
+            
+            EXPECT_EQ(N{xb + yb}, x + y);
+            EXPECT_EQ(N{xl + yl}, x + y);
+            EXPECT_EQ(N{xb - yb}, x - y);
+            EXPECT_EQ(N{xl - yl}, x - y);
+            EXPECT_EQ(N{xb * yb}, x * y);
+            EXPECT_EQ(N{xl * yl}, x * y);
+            EXPECT_EQ(N{xb / yb}, x / y);
+            EXPECT_EQ(N{xl / yl}, x / y);
+            EXPECT_EQ(N{xb % yb}, x % y);
+            EXPECT_EQ(N{xl % yl}, x % y);
+            
+            EXPECT_EQ(N{xb << 67}, x << 67);
+            EXPECT_EQ(N{xl << 67}, x << 67);
+            EXPECT_EQ(N{xb >> 67}, x >> 67);
+            EXPECT_EQ(N{xl >> 67}, x >> 67);
+        }
+        
+        EXPECT_EQ(++N_bytes<endian::big>{"0xff"}, N_bytes<endian::big>{"0x0100"});
+        EXPECT_EQ(++N_bytes<endian::little>{"0xff"}, N_bytes<endian::little>{"0x0100"});
+        EXPECT_EQ(--N_bytes<endian::big>{"0x0100"}, N_bytes<endian::big>{"0xff"});
+        EXPECT_EQ(--N_bytes<endian::little>{"0x0100"}, N_bytes<endian::little>{"0xff"});
+        
+        EXPECT_EQ((N_bytes<endian::big>{"0x0100"} - 1).size(), 1);
+        EXPECT_EQ((N_bytes<endian::little>{"0x0100"} - 1).size(), 1);
+        
+        EXPECT_THROW(N_bytes<endian::big>{1} / N_bytes<endian::big>{0}, math::division_by_zero);
+        EXPECT_THROW(N_bytes<endian::little>{1} / N_bytes<endian::little>{0}, math::division_by_zero);
+        
+    }
+    
     /*
     // Problem: string reversal not happening correctly for some reason!!
     TEST(NBytesTest, TestNToNBytes) {
@@ -0,0 +1,166 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/parallel.hpp>
+#include <data/math/arithmetic.hpp>
+#include "gtest/gtest.h"
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+namespace data {
+
+    // the function x -> A x + B. 
+    struct affine {
+        uint64 A;
+        uint64 B;
+        
+        bool operator==(const affine& f) const {
+            return A == f.A && B == f.B;
+        }
+    };
+    
+    // composition of affine functions, first a and then b. 
+    struct compose {
+        affine operator()(const affine& a, const affine& b) const {
+            return affine{a.A * b.A, b.A * a.B + b.B};
+        }
+    };
+    
+    // associative but not commutative.
+    struct concatenate {
+        std::string operator()(const std::string& a, const std::string& b) const {
+            return a + b;
+        }
+    };
+
+}
+
+namespace data::math {
+
+    template <> struct associative<data::compose, data::affine> {};
+    template <> struct associative<data::concatenate, std::string> {};
+
+}
+
+namespace data {
+
+    uint64 fibonacci(tool::executor& e, uint64 n) {
+        if (n < 2) return n;
+        uint64 a, b;
+        e.join([&e, &a, n]() { a = fibonacci(e, n - 1); }, [&e, &b, n]() { b = fibonacci(e, n - 2); });
+        return a + b;
+    }
+
+    TEST(ParallelTest, TestWorkDeque) {
+        tool::work_deque d{};
+        std::deque<tool::function_job<void (*)()>> jobs{};
+        for (int i = 0; i < 100; i++) jobs.emplace_back([]() {});
+        for (auto& j : jobs) d.push(&j);
+        EXPECT_EQ(d.steal(), &jobs[0]);
+        EXPECT_EQ(d.take(), &jobs[99]);
+        EXPECT_EQ(d.steal(), &jobs[1]);
+        for (int i = 98; i >= 2; i--) EXPECT_EQ(d.take(), &jobs[i]);
+        EXPECT_EQ(d.take(), nullptr);
+        EXPECT_EQ(d.steal(), nullptr);
+        EXPECT_TRUE(d.empty());
+    }
+
+    TEST(ParallelTest, TestExecutor) {
+        for (uint32 threads : {1, 2, 4}) {
+            tool::executor e{threads};
+            EXPECT_EQ(e.size(), threads);
+            EXPECT_EQ(fibonacci(e, 20), 6765);
+
+            // the pool can be given work from several threads at once.
+            std::vector<std::thread> callers{};
+            std::atomic<uint64> sum{0};
+            for (int i = 0; i < 4; i++) callers.emplace_back([&e, &sum]() {
+                sum += fibonacci(e, 15);
+            });
+            for (auto& t : callers) t.join();
+            EXPECT_EQ(sum.load(), 4 * 610);
+
+            EXPECT_THROW(e.join([]() {}, []() { throw std::runtime_error{"b"}; }), std::runtime_error);
+            EXPECT_THROW(e.join([]() { throw std::logic_error{"a"}; }, []() {}), std::logic_error);
+            EXPECT_THROW(e.run([]() { throw std::runtime_error{"run"}; }), std::runtime_error);
+            EXPECT_EQ(fibonacci(e, 10), 55);
+        }
+    }
+
+    TEST(ParallelTest, TestTraits) {
+        EXPECT_TRUE((meta::is_associative<plus<uint64>, uint64>::value));
+        EXPECT_TRUE((meta::is_commutative<plus<uint64>, uint64>::value));
+        EXPECT_TRUE((meta::is_associative<concatenate, std::string>::value));
+        EXPECT_FALSE((meta::is_commutative<concatenate, std::string>::value));
+        EXPECT_FALSE((meta::is_associative<minus<uint64>, uint64>::value));
+    }
+
+    TEST(ParallelTest, TestCross) {
+        tool::executor e{4};
+        for (uint64 n : {0, 1, 7, 100, 10000}) {
+            cross<uint64> c(n);
+            cross<affine> s(n);
+            affine expected{1, 0};
+            for (uint64 i = 0; i < n; i++) {
+                c[i] = i;
+                s[i] = affine{i % 5 + 1, i};
+                expected = compose{}(expected, s[i]);
+            }
+
+            cross<uint64> squares = parallel::for_each([](uint64 x) -> uint64 { return x * x; }, c, e);
+            ASSERT_EQ(squares.size(), n);
+            for (uint64 i = 0; i < n; i++) EXPECT_EQ(squares[i], i * i);
+
+            EXPECT_EQ(parallel::fold(plus<uint64>{}, uint64{5}, c, e), 5 + n * (n - 1) / 2);
+            EXPECT_EQ(parallel::reduce<uint64>(plus<uint64>{}, c, e), n * (n - 1) / 2);
+
+            EXPECT_EQ(parallel::fold(compose{}, affine{1, 0}, s, e), expected);
+            EXPECT_EQ(parallel::fold(compose{}, affine{3, 1}, s, e), compose{}(affine{3, 1}, expected));
+        }
+    }
+
+    TEST(ParallelTest, TestTree) {
+        tool::executor e{4};
+        using tree = tool::linked_tree<std::string>;
+
+        // a tree that is not balanced.
+        tree t{};
+        for (int i = 0; i < 200; i++)
+            t = tree{std::to_string(i), t, i % 3 == 0 ? tree{"r" + std::to_string(i)} : tree{}};
+
+        std::string expected{};
+        for (const std::string& x : t) expected += x;
+        EXPECT_EQ(parallel::fold(concatenate{}, std::string{}, t, e), expected);
+        EXPECT_EQ(parallel::reduce<std::string>(concatenate{}, tree{}, e), "");
+
+        auto lengths = parallel::for_each([](const std::string& x) -> uint64 { return x.size(); }, t, e);
+        EXPECT_EQ(lengths.size(), t.size());
+        auto i = t.begin();
+        for (uint64 x : lengths) {
+            EXPECT_EQ(x, (*i).size());
+            ++i;
+        }
+    }
+
+    TEST(ParallelTest, TestMap) {
+        tool::executor e{4};
+        tool::rb_map<uint64, std::string> m{};
+        std::string expected{};
+        for (uint64 i = 0; i < 1000; i++) {
+            m = m.insert(i * 7 % 1000, std::to_string(i * 7 % 1000));
+        }
+        for (uint64 i = 0; i < 1000; i++) expected += std::to_string(i);
+
+        EXPECT_EQ(parallel::fold(concatenate{}, std::string{}, m, e), expected);
+
+        auto lengths = parallel::for_each([](const std::string& x) -> uint64 { return x.size(); }, m, e);
+        EXPECT_EQ(lengths.size(), m.size());
+        EXPECT_TRUE(lengths.tree().countB() > 0);
+        lengths.tree().assert1();
+        for (uint64 i = 0; i < 1000; i++) EXPECT_EQ(lengths[i], std::to_string(i).size());
+        EXPECT_EQ(parallel::reduce<uint64>(plus<uint64>{}, lengths, e), expected.size());
+    }
+
+}
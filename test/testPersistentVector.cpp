@@ -0,0 +1,119 @@
+// Copyright (c) 2020 Daniel Krawisz
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/tools.hpp>
+#include "gtest/gtest.h"
+#include <deque>
+
+namespace data {
+    
+    template <typename X> using vector = tool::persistent_vector<X>;
+    
+    TEST(PersistentVectorTest, TestVectorConstruct) {
+        vector<int> a{1, 2, 3};
+        vector<int> b = vector<int>::make(1, 2, 3);
+        vector<int> c = vector<int>{} << 1 << 2 << 3;
+        
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a, c);
+        EXPECT_EQ(a.size(), 3);
+        EXPECT_EQ(a.first(), 1);
+        EXPECT_EQ(a.last(), 3);
+        EXPECT_EQ(a[1], 2);
+        EXPECT_THROW(a[3], std::out_of_range);
+        EXPECT_EQ(a.reverse(), (vector<int>{3, 2, 1}));
+        EXPECT_EQ((a << vector<int>{4, 5}), (vector<int>{1, 2, 3, 4, 5}));
+        EXPECT_EQ(a.prepend(0), (vector<int>{0, 1, 2, 3}));
+        EXPECT_EQ(a.rest(), (vector<int>{2, 3}));
+    }
+    
+    TEST(PersistentVectorTest, TestVectorReference) {
+        int x = 1, y = 2;
+        vector<int&> v{x, y};
+        EXPECT_EQ(&v.first(), &x);
+        EXPECT_EQ(&v[1], &y);
+    }
+    
+    // old versions of a vector remain valid while 
+    // new versions are made from them. 
+    template <typename alloc> 
+    void test_persistence() {
+        using vec = tool::persistent_vector<int, alloc>;
+        std::vector<vec> vectors{vec{}};
+        std::vector<std::deque<int>> expected{std::deque<int>{}};
+        
+        for (int i = 0; i < 3000; i++) {
+            size_t from = (i * 7919) % vectors.size();
+            vec v = vectors[from];
+            std::deque<int> d = expected[from];
+            
+            switch (i % 6) {
+                case 0: 
+                case 1: 
+                    for (int j = 0; j < i % 70; j++) {
+                        v = v << j;
+                        d.push_back(j);
+                    }
+                    break;
+                case 2: 
+                    for (int j = 0; j < i % 40 && !d.empty(); j++) {
+                        v = v.rest();
+                        d.pop_front();
+                    }
+                    break;
+                case 3: 
+                    v = v.prepend(i);
+                    d.push_front(i);
+                    break;
+                case 4: 
+                    if (d.size() + expected[i % vectors.size()].size() < 5000) {
+                        v = v << vectors[i % vectors.size()];
+                        d.insert(d.end(), expected[i % vectors.size()].begin(), expected[i % vectors.size()].end());
+                    }
+                    break;
+                default: 
+                    for (size_t j = 0; j < d.size(); j += 17) EXPECT_EQ(v[j], d[j]);
+            }
+            
+            EXPECT_EQ(v.size(), d.size());
+            size_t n = 0;
+            for (int x : v) EXPECT_EQ(x, d[n++]);
+            EXPECT_EQ(n, d.size());
+            
+            vectors.push_back(v);
+            expected.push_back(d);
+        }
+    }
+    
+    TEST(PersistentVectorTest, TestVectorPersistence) {
+        test_persistence<tool::shared_allocation>();
+        test_persistence<tool::pooled_allocation>();
+    }
+    
+    // a vector used as a buffer should take linear time overall.
+    TEST(PersistentVectorTest, TestVectorBuffer) {
+        const int max = 1000000;
+        vector<int> q{};
+        uint64 sum = 0;
+        for (int i = 0; i < max; i++) {
+            q = q << i;
+            if (i % 3 == 2) {
+                sum += q.first();
+                q = q.rest();
+            }
+        }
+        EXPECT_EQ(q.size(), max - max / 3);
+        EXPECT_EQ(q[0], max / 3);
+        
+        int expected = max / 3;
+        for (int x : q) EXPECT_EQ(x, expected++);
+        
+        while (!q.empty()) {
+            sum += q.first();
+            q = q.rest();
+        }
+        EXPECT_EQ(sum, uint64(max) * (max - 1) / 2);
+    }
+    
+}
@@ -6,6 +6,8 @@
 #include <data/tools/rate_limiter.h>
 #include "gtest/gtest.h"
 #include <iostream>
+#include <thread>
+#include <vector>
 
 namespace data {
     namespace tools {
@@ -40,5 +42,68 @@ namespace data {
 
             ASSERT_LT(time2, time1);
         }
+
+        TEST(RateLimiterTest, testTokenBucket) {
+            using namespace std::chrono;
+            token_bucket bucket(100, seconds(1), 3);
+            EXPECT_EQ(bucket.burst(), 3);
+            auto now = token_bucket::clock::now();
+
+            EXPECT_TRUE(bucket.try_acquire(2, now));
+            EXPECT_TRUE(bucket.try_acquire(1, now));
+            EXPECT_FALSE(bucket.try_acquire(1, now));
+            EXPECT_FALSE(bucket.try_acquire(4, now + seconds(10)));
+
+            // a token is made every 10 milliseconds.
+            EXPECT_FALSE(bucket.try_acquire(1, now + milliseconds(9)));
+            EXPECT_TRUE(bucket.try_acquire(1, now + milliseconds(10)));
+            EXPECT_FALSE(bucket.try_acquire(1, now + milliseconds(10)));
+
+            // a token that is not there yet can be reserved.
+            EXPECT_FALSE(bucket.acquire_until(now + milliseconds(15), 1, now + milliseconds(10)));
+            auto wait = bucket.acquire_until(now + milliseconds(25), 1, now + milliseconds(10));
+            ASSERT_TRUE(wait);
+            EXPECT_EQ(*wait, milliseconds(10));
+            EXPECT_FALSE(bucket.try_acquire(1, now + milliseconds(20)));
+            EXPECT_TRUE(bucket.try_acquire(1, now + milliseconds(30)));
+
+            // the bucket fills up to burst and no further.
+            EXPECT_TRUE(bucket.try_acquire(3, now + seconds(1)));
+            EXPECT_FALSE(bucket.try_acquire(1, now + seconds(1)));
+
+            auto start = token_bucket::clock::now();
+            token_bucket fast(1000, seconds(1), 1);
+            for (int i = 0; i < 20; i++) fast.acquire();
+            EXPECT_GE(token_bucket::clock::now() - start, milliseconds(19));
+        }
+
+        TEST(RateLimiterTest, testTokenBucketThreads) {
+            token_bucket bucket(1, std::chrono::hours(1), 1000);
+            std::atomic<int> acquired(0);
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 8; i++) threads.emplace_back([&bucket, &acquired]() {
+                for (int j = 0; j < 500; j++) if (bucket.try_acquire()) acquired++;
+            });
+            for (auto& t : threads) t.join();
+            EXPECT_EQ(acquired.load(), 1000);
+        }
+
+        TEST(RateLimiterTest, testKeyedRateLimiter) {
+            keyed_rate_limiter limiter(1, std::chrono::hours(1), 2);
+            EXPECT_TRUE(limiter.try_acquire("a.com"));
+            EXPECT_TRUE(limiter.try_acquire("a.com"));
+            EXPECT_FALSE(limiter.try_acquire("a.com"));
+            EXPECT_TRUE(limiter.try_acquire("b.com", 2));
+            EXPECT_FALSE(limiter.acquire_until("b.com", token_bucket::clock::now() + std::chrono::seconds(1)));
+            EXPECT_EQ(&limiter["a.com"], &limiter["a.com"]);
+
+            std::vector<std::thread> threads;
+            std::atomic<int> acquired(0);
+            for (int i = 0; i < 8; i++) threads.emplace_back([&limiter, &acquired]() {
+                for (int j = 0; j < 100; j++) if (limiter.try_acquire("host" + std::to_string(j))) acquired++;
+            });
+            for (auto& t : threads) t.join();
+            EXPECT_EQ(acquired.load(), 200);
+        }
     }
 }
\ No newline at end of file
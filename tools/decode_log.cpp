@@ -0,0 +1,31 @@
+// Copyright (c) 2021 Katrina Knight
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <data/log/binary.hpp>
+#include <fstream>
+#include <iostream>
+
+// decode_log [file...]
+// write binary logs as text, reading standard input if no file is given.
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        if (data::log::binary::decode(std::cin, std::cout)) return 0;
+        std::cerr << "standard input is not a complete binary log" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    for (int i = 1; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::cerr << "could not open " << argv[i] << std::endl;
+            result = 1;
+        } else if (!data::log::binary::decode(file, std::cout)) {
+            std::cerr << argv[i] << " is not a complete binary log" << std::endl;
+            result = 1;
+        }
+    }
+    return result;
+}